@@ -20,6 +20,7 @@ Renderer* g_theRenderer = nullptr;		// Created and owned by the App
 AudioSystem* g_theAudio = nullptr;		// Created and owned by the App
 Window* g_theWindow = nullptr;			// Created and owned by the App
 JobSystem* g_theJobSystem = nullptr;    // Created and owned by the App
+JobSystem* g_theIOJobSystem = nullptr;  // Created and owned by the App
 
 App::App()
 {
@@ -66,7 +67,14 @@ void App::Startup()
 	jobSystemConfig.m_numJobWorkers = std::thread::hardware_concurrency() - 1;
 	g_theJobSystem = new JobSystem(jobSystemConfig);
 
+	// Chunk loads and saves get their own small pool, so they never queue behind generation and meshing.
+	// Its workers mostly wait on the disk, so they are not taken away from the compute pool
+	JobSystemConfig ioJobSystemConfig;
+	ioJobSystemConfig.m_numJobWorkers = g_gameConfigBlackboard.GetValue("ioJobWorkers", 2);
+	g_theIOJobSystem = new JobSystem(ioJobSystemConfig);
+
 	g_theJobSystem->StartUp();
+	g_theIOJobSystem->StartUp();
 	g_theEventSystem->Startup();
 	g_theDevConsole->Startup();
 	g_theInput->Startup();
@@ -97,6 +105,7 @@ void App::Shutdown()
 	g_theInput->Shutdown();
 	g_theDevConsole->Shutdown();
 	g_theEventSystem->Shutdown();
+	g_theIOJobSystem->Shutdown();
 	g_theJobSystem->Shutdown();
 
 	delete g_theRenderer;
@@ -104,6 +113,7 @@ void App::Shutdown()
 	delete g_theInput;
 	delete g_theEventSystem;
 	delete g_theDevConsole;
+	delete g_theIOJobSystem;
 	delete g_theJobSystem;
 
 	g_theRenderer = nullptr;
@@ -111,6 +121,7 @@ void App::Shutdown()
 	g_theInput = nullptr;
 	g_theEventSystem = nullptr;
 	g_theDevConsole = nullptr;
+	g_theIOJobSystem = nullptr;
 	g_theJobSystem = nullptr;
 }
 
@@ -124,6 +135,7 @@ void App::BeginFrame()
 	g_theInput->BeginFrame();
 	g_theDevConsole->BeginFrame();
 	g_theJobSystem->BeginFrame();
+	g_theIOJobSystem->BeginFrame();
 
 	DebugRenderBeginFrame();
 }
@@ -0,0 +1,325 @@
+#include "Game/BatchNoise.hpp"
+#include "Engine/Math/SmoothNoise.hpp"
+#include "Engine/Math/RawNoise.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <immintrin.h>
+#include <math.h>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Lane wrappers so the kernels below are written once for both widths
+// -----------------------------------------------------------------------------
+#if defined(__AVX2__)
+typedef __m256 NoiseLanes;
+static inline NoiseLanes LoadLanes(float const* values)              { return _mm256_load_ps(values); }
+static inline void       StoreLanes(float* values, NoiseLanes lanes) { _mm256_store_ps(values, lanes); }
+static inline NoiseLanes SetLanes(float value)                       { return _mm256_set1_ps(value); }
+static inline NoiseLanes AddLanes(NoiseLanes a, NoiseLanes b)        { return _mm256_add_ps(a, b); }
+static inline NoiseLanes SubLanes(NoiseLanes a, NoiseLanes b)        { return _mm256_sub_ps(a, b); }
+static inline NoiseLanes MulLanes(NoiseLanes a, NoiseLanes b)        { return _mm256_mul_ps(a, b); }
+static inline NoiseLanes DivLanes(NoiseLanes a, NoiseLanes b)        { return _mm256_div_ps(a, b); }
+static inline NoiseLanes FloorLanes(NoiseLanes a)                    { return _mm256_floor_ps(a); }
+#define NOISE_LANE_ALIGN alignas(32)
+#else
+typedef __m128 NoiseLanes;
+static inline NoiseLanes LoadLanes(float const* values)              { return _mm_load_ps(values); }
+static inline void       StoreLanes(float* values, NoiseLanes lanes) { _mm_store_ps(values, lanes); }
+static inline NoiseLanes SetLanes(float value)                       { return _mm_set1_ps(value); }
+static inline NoiseLanes AddLanes(NoiseLanes a, NoiseLanes b)        { return _mm_add_ps(a, b); }
+static inline NoiseLanes SubLanes(NoiseLanes a, NoiseLanes b)        { return _mm_sub_ps(a, b); }
+static inline NoiseLanes MulLanes(NoiseLanes a, NoiseLanes b)        { return _mm_mul_ps(a, b); }
+static inline NoiseLanes DivLanes(NoiseLanes a, NoiseLanes b)        { return _mm_div_ps(a, b); }
+static inline NoiseLanes FloorLanes(NoiseLanes a)
+{
+	// SSE2 has no floor, truncate and step down where truncation rounded up
+	NoiseLanes truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+	NoiseLanes roundedUp = _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.f));
+	return _mm_sub_ps(truncated, roundedUp);
+}
+#define NOISE_LANE_ALIGN alignas(16)
+#endif
+
+// -----------------------------------------------------------------------------
+// Same constants as the scalar implementation in SmoothNoise.cpp
+// -----------------------------------------------------------------------------
+static constexpr float OCTAVE_OFFSET = 0.636764989593174f;
+static constexpr float SQRT_3_OVER_3 = 0.577350269189f;
+static constexpr float PERLIN_2D_NORMALIZER = 1.f / 0.662578106f;
+static constexpr float PERLIN_3D_NORMALIZER = 1.f / 0.793856621f;
+
+static float const GRADIENTS_2D_X[8] = { +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f, +0.382683432f, +0.923879533f };
+static float const GRADIENTS_2D_Y[8] = { +0.382683432f, +0.923879533f, +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f };
+
+static inline NoiseLanes SmoothStep3Lanes(NoiseLanes t)
+{
+	// 3t^2 - 2t^3
+	NoiseLanes tSquared = MulLanes(t, t);
+	return SubLanes(MulLanes(SetLanes(3.f), tSquared), MulLanes(SetLanes(2.f), MulLanes(tSquared, t)));
+}
+
+static inline NoiseLanes RenormalizeLanes(NoiseLanes totalNoise, float totalAmplitude)
+{
+	totalNoise = DivLanes(totalNoise, SetLanes(totalAmplitude));
+	totalNoise = AddLanes(MulLanes(totalNoise, SetLanes(0.5f)), SetLanes(0.5f));
+	totalNoise = SmoothStep3Lanes(totalNoise);
+	return SubLanes(MulLanes(totalNoise, SetLanes(2.f)), SetLanes(1.f));
+}
+
+// -----------------------------------------------------------------------------
+static void Compute2dPerlinNoiseLanes(float const* posX, float const* posY, float* outNoise,
+	                                  float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	NOISE_LANE_ALIGN float cellMinsX[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float cellMinsY[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float gradientX[4][NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float gradientY[4][NOISE_BATCH_WIDTH];
+
+	float invScale = 1.f / scale;
+	NoiseLanes currentX = MulLanes(LoadLanes(posX), SetLanes(invScale));
+	NoiseLanes currentY = MulLanes(LoadLanes(posY), SetLanes(invScale));
+	NoiseLanes totalNoise = SetLanes(0.f);
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+
+	for (unsigned int octaveNum = 0; octaveNum < numOctaves; ++octaveNum)
+	{
+		NoiseLanes minsX = FloorLanes(currentX);
+		NoiseLanes minsY = FloorLanes(currentY);
+		StoreLanes(cellMinsX, minsX);
+		StoreLanes(cellMinsY, minsY);
+
+		// Hashing stays scalar so gradient choices are identical to the scalar path
+		for (int lane = 0; lane < NOISE_BATCH_WIDTH; ++lane)
+		{
+			int westX = static_cast<int>(cellMinsX[lane]);
+			int southY = static_cast<int>(cellMinsY[lane]);
+			for (int corner = 0; corner < 4; ++corner)
+			{
+				unsigned int noise = Get2dNoiseUint(westX + (corner & 1), southY + ((corner >> 1) & 1), seed);
+				gradientX[corner][lane] = GRADIENTS_2D_X[noise & 0x00000007];
+				gradientY[corner][lane] = GRADIENTS_2D_Y[noise & 0x00000007];
+			}
+		}
+
+		NoiseLanes maxsX = AddLanes(minsX, SetLanes(1.f));
+		NoiseLanes maxsY = AddLanes(minsY, SetLanes(1.f));
+		NoiseLanes fromWestX = SubLanes(currentX, minsX);
+		NoiseLanes fromSouthY = SubLanes(currentY, minsY);
+		NoiseLanes fromEastX = SubLanes(currentX, maxsX);
+		NoiseLanes fromNorthY = SubLanes(currentY, maxsY);
+
+		NoiseLanes dotSouthWest = AddLanes(MulLanes(LoadLanes(gradientX[0]), fromWestX), MulLanes(LoadLanes(gradientY[0]), fromSouthY));
+		NoiseLanes dotSouthEast = AddLanes(MulLanes(LoadLanes(gradientX[1]), fromEastX), MulLanes(LoadLanes(gradientY[1]), fromSouthY));
+		NoiseLanes dotNorthWest = AddLanes(MulLanes(LoadLanes(gradientX[2]), fromWestX), MulLanes(LoadLanes(gradientY[2]), fromNorthY));
+		NoiseLanes dotNorthEast = AddLanes(MulLanes(LoadLanes(gradientX[3]), fromEastX), MulLanes(LoadLanes(gradientY[3]), fromNorthY));
+
+		NoiseLanes weightEast = SmoothStep3Lanes(fromWestX);
+		NoiseLanes weightNorth = SmoothStep3Lanes(fromSouthY);
+		NoiseLanes weightWest = SubLanes(SetLanes(1.f), weightEast);
+		NoiseLanes weightSouth = SubLanes(SetLanes(1.f), weightNorth);
+
+		NoiseLanes blendSouth = AddLanes(MulLanes(weightEast, dotSouthEast), MulLanes(weightWest, dotSouthWest));
+		NoiseLanes blendNorth = AddLanes(MulLanes(weightEast, dotNorthEast), MulLanes(weightWest, dotNorthWest));
+		NoiseLanes blendTotal = AddLanes(MulLanes(weightSouth, blendSouth), MulLanes(weightNorth, blendNorth));
+		NoiseLanes noiseThisOctave = MulLanes(blendTotal, SetLanes(PERLIN_2D_NORMALIZER));
+
+		totalNoise = AddLanes(totalNoise, MulLanes(noiseThisOctave, SetLanes(currentAmplitude)));
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentX = AddLanes(MulLanes(currentX, SetLanes(octaveScale)), SetLanes(OCTAVE_OFFSET));
+		currentY = AddLanes(MulLanes(currentY, SetLanes(octaveScale)), SetLanes(OCTAVE_OFFSET));
+		++seed;
+	}
+
+	if (renormalize && totalAmplitude > 0.f)
+	{
+		totalNoise = RenormalizeLanes(totalNoise, totalAmplitude);
+	}
+	StoreLanes(outNoise, totalNoise);
+}
+
+// -----------------------------------------------------------------------------
+static void Compute3dPerlinNoiseLanes(float const* posX, float const* posY, float const* posZ, float* outNoise,
+	                                  float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	NOISE_LANE_ALIGN float cellMinsX[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float cellMinsY[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float cellMinsZ[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float gradientX[8][NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float gradientY[8][NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float gradientZ[8][NOISE_BATCH_WIDTH];
+
+	float invScale = 1.f / scale;
+	NoiseLanes currentX = MulLanes(LoadLanes(posX), SetLanes(invScale));
+	NoiseLanes currentY = MulLanes(LoadLanes(posY), SetLanes(invScale));
+	NoiseLanes currentZ = MulLanes(LoadLanes(posZ), SetLanes(invScale));
+	NoiseLanes totalNoise = SetLanes(0.f);
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+
+	for (unsigned int octaveNum = 0; octaveNum < numOctaves; ++octaveNum)
+	{
+		NoiseLanes minsX = FloorLanes(currentX);
+		NoiseLanes minsY = FloorLanes(currentY);
+		NoiseLanes minsZ = FloorLanes(currentZ);
+		StoreLanes(cellMinsX, minsX);
+		StoreLanes(cellMinsY, minsY);
+		StoreLanes(cellMinsZ, minsZ);
+
+		// Corner gradients point at cube corners, so each hash bit picks the sign of one component
+		for (int lane = 0; lane < NOISE_BATCH_WIDTH; ++lane)
+		{
+			int westX = static_cast<int>(cellMinsX[lane]);
+			int southY = static_cast<int>(cellMinsY[lane]);
+			int belowZ = static_cast<int>(cellMinsZ[lane]);
+			for (int corner = 0; corner < 8; ++corner)
+			{
+				unsigned int noise = Get3dNoiseUint(westX + (corner & 1), southY + ((corner >> 1) & 1), belowZ + ((corner >> 2) & 1), seed);
+				gradientX[corner][lane] = (noise & 1) ? -SQRT_3_OVER_3 : SQRT_3_OVER_3;
+				gradientY[corner][lane] = (noise & 2) ? -SQRT_3_OVER_3 : SQRT_3_OVER_3;
+				gradientZ[corner][lane] = (noise & 4) ? -SQRT_3_OVER_3 : SQRT_3_OVER_3;
+			}
+		}
+
+		NoiseLanes fromWestX = SubLanes(currentX, minsX);
+		NoiseLanes fromSouthY = SubLanes(currentY, minsY);
+		NoiseLanes fromBelowZ = SubLanes(currentZ, minsZ);
+		NoiseLanes fromEastX = SubLanes(currentX, AddLanes(minsX, SetLanes(1.f)));
+		NoiseLanes fromNorthY = SubLanes(currentY, AddLanes(minsY, SetLanes(1.f)));
+		NoiseLanes fromAboveZ = SubLanes(currentZ, AddLanes(minsZ, SetLanes(1.f)));
+
+		NoiseLanes dots[8];
+		for (int corner = 0; corner < 8; ++corner)
+		{
+			NoiseLanes displacementX = (corner & 1) ? fromEastX : fromWestX;
+			NoiseLanes displacementY = (corner & 2) ? fromNorthY : fromSouthY;
+			NoiseLanes displacementZ = (corner & 4) ? fromAboveZ : fromBelowZ;
+			dots[corner] = AddLanes(AddLanes(MulLanes(LoadLanes(gradientX[corner]), displacementX),
+				                             MulLanes(LoadLanes(gradientY[corner]), displacementY)),
+				                             MulLanes(LoadLanes(gradientZ[corner]), displacementZ));
+		}
+
+		NoiseLanes weightEast = SmoothStep3Lanes(fromWestX);
+		NoiseLanes weightNorth = SmoothStep3Lanes(fromSouthY);
+		NoiseLanes weightAbove = SmoothStep3Lanes(fromBelowZ);
+		NoiseLanes weightWest = SubLanes(SetLanes(1.f), weightEast);
+		NoiseLanes weightSouth = SubLanes(SetLanes(1.f), weightNorth);
+		NoiseLanes weightBelow = SubLanes(SetLanes(1.f), weightAbove);
+
+		// 8-way blend (8 -> 4 -> 2 -> 1)
+		NoiseLanes blendBelowSouth = AddLanes(MulLanes(weightEast, dots[1]), MulLanes(weightWest, dots[0]));
+		NoiseLanes blendBelowNorth = AddLanes(MulLanes(weightEast, dots[3]), MulLanes(weightWest, dots[2]));
+		NoiseLanes blendAboveSouth = AddLanes(MulLanes(weightEast, dots[5]), MulLanes(weightWest, dots[4]));
+		NoiseLanes blendAboveNorth = AddLanes(MulLanes(weightEast, dots[7]), MulLanes(weightWest, dots[6]));
+		NoiseLanes blendBelow = AddLanes(MulLanes(weightSouth, blendBelowSouth), MulLanes(weightNorth, blendBelowNorth));
+		NoiseLanes blendAbove = AddLanes(MulLanes(weightSouth, blendAboveSouth), MulLanes(weightNorth, blendAboveNorth));
+		NoiseLanes blendTotal = AddLanes(MulLanes(weightBelow, blendBelow), MulLanes(weightAbove, blendAbove));
+		NoiseLanes noiseThisOctave = MulLanes(blendTotal, SetLanes(PERLIN_3D_NORMALIZER));
+
+		totalNoise = AddLanes(totalNoise, MulLanes(noiseThisOctave, SetLanes(currentAmplitude)));
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentX = AddLanes(MulLanes(currentX, SetLanes(octaveScale)), SetLanes(OCTAVE_OFFSET));
+		currentY = AddLanes(MulLanes(currentY, SetLanes(octaveScale)), SetLanes(OCTAVE_OFFSET));
+		currentZ = AddLanes(MulLanes(currentZ, SetLanes(octaveScale)), SetLanes(OCTAVE_OFFSET));
+		++seed;
+	}
+
+	if (renormalize && totalAmplitude > 0.f)
+	{
+		totalNoise = RenormalizeLanes(totalNoise, totalAmplitude);
+	}
+	StoreLanes(outNoise, totalNoise);
+}
+
+// -----------------------------------------------------------------------------
+void Compute2dPerlinNoiseBatch(float const* posX, float const* posY, float* outNoise, int numPoints,
+	                           float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	NOISE_LANE_ALIGN float lanesX[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float lanesY[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float lanesNoise[NOISE_BATCH_WIDTH];
+
+	for (int firstPoint = 0; firstPoint < numPoints; firstPoint += NOISE_BATCH_WIDTH)
+	{
+		// Pad the final partial batch by repeating its last point
+		int numInBatch = GetMin(NOISE_BATCH_WIDTH, numPoints - firstPoint);
+		for (int lane = 0; lane < NOISE_BATCH_WIDTH; ++lane)
+		{
+			int pointIndex = firstPoint + GetMin(lane, numInBatch - 1);
+			lanesX[lane] = posX[pointIndex];
+			lanesY[lane] = posY[pointIndex];
+		}
+
+		Compute2dPerlinNoiseLanes(lanesX, lanesY, lanesNoise, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+
+		for (int lane = 0; lane < numInBatch; ++lane)
+		{
+			outNoise[firstPoint + lane] = lanesNoise[lane];
+		}
+	}
+}
+
+// -----------------------------------------------------------------------------
+void Compute3dPerlinNoiseBatch(float const* posX, float const* posY, float const* posZ, float* outNoise, int numPoints,
+	                           float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+	NOISE_LANE_ALIGN float lanesX[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float lanesY[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float lanesZ[NOISE_BATCH_WIDTH];
+	NOISE_LANE_ALIGN float lanesNoise[NOISE_BATCH_WIDTH];
+
+	for (int firstPoint = 0; firstPoint < numPoints; firstPoint += NOISE_BATCH_WIDTH)
+	{
+		int numInBatch = GetMin(NOISE_BATCH_WIDTH, numPoints - firstPoint);
+		for (int lane = 0; lane < NOISE_BATCH_WIDTH; ++lane)
+		{
+			int pointIndex = firstPoint + GetMin(lane, numInBatch - 1);
+			lanesX[lane] = posX[pointIndex];
+			lanesY[lane] = posY[pointIndex];
+			lanesZ[lane] = posZ[pointIndex];
+		}
+
+		Compute3dPerlinNoiseLanes(lanesX, lanesY, lanesZ, lanesNoise, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+
+		for (int lane = 0; lane < numInBatch; ++lane)
+		{
+			outNoise[firstPoint + lane] = lanesNoise[lane];
+		}
+	}
+}
+
+// -----------------------------------------------------------------------------
+float MeasureBatchNoiseError(int numSamples, unsigned int seed)
+{
+	std::vector<float> posX(numSamples);
+	std::vector<float> posY(numSamples);
+	std::vector<float> posZ(numSamples);
+	std::vector<float> batchNoise(numSamples);
+
+	// Spread samples over negative and positive coordinates, including exact integers
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		posX[sampleIndex] = Get1dNoiseNegOneToOne(sampleIndex, seed) * 4096.f;
+		posY[sampleIndex] = Get1dNoiseNegOneToOne(sampleIndex, seed + 1) * 4096.f;
+		posZ[sampleIndex] = static_cast<float>(sampleIndex % 128);
+	}
+
+	float maxError = 0.f;
+
+	Compute2dPerlinNoiseBatch(posX.data(), posY.data(), batchNoise.data(), numSamples, 200.f, 8, 0.5f, 2.f, true, seed);
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		float scalarNoise = Compute2dPerlinNoise(posX[sampleIndex], posY[sampleIndex], 200.f, 8, 0.5f, 2.f, true, seed);
+		maxError = GetMax(maxError, fabsf(scalarNoise - batchNoise[sampleIndex]));
+	}
+
+	Compute3dPerlinNoiseBatch(posX.data(), posY.data(), posZ.data(), batchNoise.data(), numSamples, 64.f, 8, 0.5f, 2.f, true, seed);
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		float scalarNoise = Compute3dPerlinNoise(posX[sampleIndex], posY[sampleIndex], posZ[sampleIndex], 64.f, 8, 0.5f, 2.f, true, seed);
+		maxError = GetMax(maxError, fabsf(scalarNoise - batchNoise[sampleIndex]));
+	}
+
+	return maxError;
+}
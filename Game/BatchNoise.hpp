@@ -0,0 +1,26 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Batched Perlin noise for chunk generation.
+// Evaluates NOISE_BATCH_WIDTH points per instruction stream (AVX2 when the
+// compiler targets it, SSE2 otherwise) and matches the scalar
+// Compute2dPerlinNoise / Compute3dPerlinNoise from SmoothNoise.hpp to within
+// BATCH_NOISE_TOLERANCE. Gradient selection uses the same RawNoise hashes, so
+// the two paths always agree on which lattice gradients are used.
+// -----------------------------------------------------------------------------
+#if defined(__AVX2__)
+constexpr int NOISE_BATCH_WIDTH = 8;
+#else
+constexpr int NOISE_BATCH_WIDTH = 4;
+#endif
+constexpr float BATCH_NOISE_TOLERANCE = 0.0001f;
+// -----------------------------------------------------------------------------
+void Compute2dPerlinNoiseBatch(float const* posX, float const* posY, float* outNoise, int numPoints,
+	                           float scale, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f,
+	                           bool renormalize = true, unsigned int seed = 0);
+
+void Compute3dPerlinNoiseBatch(float const* posX, float const* posY, float const* posZ, float* outNoise, int numPoints,
+	                           float scale, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f,
+	                           bool renormalize = true, unsigned int seed = 0);
+
+// Compares the batched and scalar paths over pseudo-random points, returns the largest absolute difference
+float MeasureBatchNoiseError(int numSamples, unsigned int seed);
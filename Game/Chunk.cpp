@@ -1,36 +1,42 @@
 #include "Game/Chunk.hpp"
-#include "Game/World.hpp"
 #include "Game/Block.hpp"
 #include "Game/BlockDefinition.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <algorithm>
+#include <iterator>
+// Rendering and world access are left out of headless builds (see Tools/CMakeLists.txt)
+#if !defined(HEADLESS_WORLDGEN)
+#include "Game/World.hpp"
 #include "Game/BlockIterator.hpp"
 #include "Game/Game.h"
+#include "Game/WorldRenderContext.hpp"
 #include "Engine/Renderer/Renderer.h"
-#include "Engine/Core/EngineCommon.h"
-#include "Engine/Math/SmoothNoise.hpp"
-#include "Engine/Math/RawNoise.hpp"
-#include "Engine/Math/MathUtils.h"
-#include "Engine/Math/Splines.hpp"
+#endif
 
 Chunk::Chunk(IntVec2 const& chunkCoords)
 	:m_chunkCoords(chunkCoords)
 {
-	// Getting spritesheet texture
-	m_spriteImage = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/SpriteSheet_Classic_Faithful_32x.png", 5);
-	m_spriteSheet = new SpriteSheet(*m_spriteImage, IntVec2::GRID8X8);
-
 	// Populate blocks in chunk
 	m_blocks = new Block[CHUNK_BLOCK_TOTAL];
 }
 
-Chunk::~Chunk()
+Chunk::Chunk(IntVec2 const& chunkCoords, Block* recycledBlocks)
+	:m_chunkCoords(chunkCoords)
+	,m_blocks(recycledBlocks)
 {
-	DeleteBuffers();
+}
 
+Chunk::~Chunk()
+{
 	delete[] m_blocks;
 	m_blocks = nullptr;
 
-	delete m_spriteSheet;
-	m_spriteSheet = nullptr;
+#if !defined(HEADLESS_WORLDGEN)
+	DeleteBuffers();
+#endif
 }
 
 void Chunk::Update(float deltaseconds)
@@ -38,1032 +44,436 @@ void Chunk::Update(float deltaseconds)
 	UNUSED(deltaseconds);
 }
 
-void Chunk::Render() const
+#if !defined(HEADLESS_WORLDGEN)
+bool Chunk::Render(WorldRenderContext& context, IndexBuffer* quadIndexBuffer) const
 {
-	if (m_vertexBuffer == nullptr || m_indexBuffer == nullptr)
+	if (m_vertexBuffer == nullptr || quadIndexBuffer == nullptr)
 	{
-		return;
+		return false;
 	}
 
-	if (m_indices.empty())
+	if (m_vertexes.empty())
 	{
-		return;
+		return false;
 	}
 
-	g_theRenderer->SetModelConstants();
-	g_theGame->SetWorldConstants();
-	g_theRenderer->SetBlendMode(BlendMode::OPAQUE);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-	g_theRenderer->BindShader(g_theGame->m_worldShader);
-	g_theRenderer->BindTexture(m_spriteImage);
-	g_theRenderer->DrawIndexedVertexBuffer(m_vertexBuffer, m_indexBuffer, static_cast<unsigned int>(m_indices.size()));
+	// Shared state is set once by World::Render
+	DrawChunkMesh(context, m_chunkCoords, m_vertexBuffer, quadIndexBuffer, static_cast<unsigned int>(GetIndexCount()));
+	return true;
 }
 
-void Chunk::PopulateWithDensityNoise()
+void Chunk::GenerateChunkMesh()
 {
-	const float densityBiasPerBlock = 2.f / static_cast<float>(CHUNK_SIZE_Z);
-	const int numXY = CHUNK_SIZE_X * CHUNK_SIZE_Y;
-
-	// Noise maps for this chunk
-	std::vector<float> continentNoiseMap(numXY);
-	std::vector<float> continentalnessNoiseMap(numXY);
-	std::vector<float> erosionMap(numXY);
-	std::vector<float> peaksValleysMap(numXY);
-	std::vector<float> temperatureMap(numXY);
-	std::vector<float> humidityMap(numXY);
-	std::vector<float> treeNoiseMap(numXY);
-	std::vector<float> treeVariantNoiseMap(numXY);
-
-	// Precomputation caching
-	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
-	{
-		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
-		{
-			int chunkIndex = chunkY * CHUNK_SIZE_X + chunkX;
-			int globalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
-			int globalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
-
-
-			continentNoiseMap[chunkIndex] = Compute2dPerlinNoise((float)globalX, (float)globalY, CONTINENT_SCALE, CONTINENT_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 100);
-			continentalnessNoiseMap[chunkIndex] = Compute2dPerlinNoise((float)globalX, (float)globalY, CONTINENTALNESS_SCALE, BIOME_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 100);
-			erosionMap[chunkIndex] = Compute2dPerlinNoise((float)globalX, (float)globalY, EROSIION_SCALE, BIOME_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 200);
-			peaksValleysMap[chunkIndex] = Compute2dPerlinNoise((float)globalX, (float)globalY, PEAKVALLEY_SCALE, BIOME_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 300);
-			temperatureMap[chunkIndex] = Compute2dPerlinNoise((float)globalX, (float)globalY, TEMPERATURE_SCALE, BIOME_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 400);
-			humidityMap[chunkIndex] = Compute2dPerlinNoise((float)globalX, (float)globalY, HUMIDITY_SCALE, BIOME_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 500);
-
-			treeNoiseMap[chunkIndex] = Get2dNoiseZeroToOne(globalX, globalY, GAME_SEED + 42);
-			treeVariantNoiseMap[chunkIndex] = Get2dNoiseZeroToOne(globalX, globalY, GAME_SEED + 1337);
-		}
-	}
-
-	// Using cached maps during block population
-	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
-	{
-		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
-		{
-			int chunkIndex = chunkY * CHUNK_SIZE_X + chunkX;
-			int globalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
-			int globalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
-
-			// Grabbing noise maps
-			float continentNoise = continentNoiseMap[chunkIndex];
-			float continentalness = continentalnessNoiseMap[chunkIndex];
-			float erosion = erosionMap[chunkIndex];
-			float peaksValleys = peaksValleysMap[chunkIndex];
-			float temperature = temperatureMap[chunkIndex];
-			float humidity = humidityMap[chunkIndex];
-
-			// Computing biomes once per column
-			BiomeParams biomeParams = { continentalness, erosion, peaksValleys, temperature, humidity };
-			BiomeType biome = GetBiomeType(biomeParams);
-			SurfaceBlocks surface = GetSurfaceBlocks(biome);
-
-			// Continent shaping
-			float normalizedNoise = (continentNoise + 1.0f) * 0.5f;
-			float heightOffset = g_theGame->m_continentHeightOffsetCurve->EvaluateAtParametric(normalizedNoise).y;
-			float squashingFactor = g_theGame->m_continentSquashCurve->EvaluateAtParametric(normalizedNoise).y;
-			float baseHeight = DEFAULT_TERRAIN_HEIGHT + (heightOffset * (CHUNK_SIZE_Z / 8.5f));
-
-			int surfaceDepthCounter = 0;
-			int surfaceZ = -1;
-
-			for (int chunkZ = CHUNK_SIZE_Z - 1; chunkZ >= 0; --chunkZ)
-			{
-				int blockIndex = GetBlockIndex(chunkX, chunkY, chunkZ);
-				Block* block = &m_blocks[blockIndex];
-				int globalZ = chunkZ;
-
-				// Terrain density bias
-				// -----------------------------------------------------------------------------
-				float noiseValue = Compute3dPerlinNoise(static_cast<float>(globalX), static_cast<float>(globalY), static_cast<float>(globalZ),
-					                                    DENSITY_NOISE_SCALE, DENSITY_OCTAVES, DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED);
-
-				float noiseBias = densityBiasPerBlock * (static_cast<float>(globalZ) - DEFAULT_TERRAIN_HEIGHT);
-				float densityValue = noiseValue + noiseBias;
-				// -----------------------------------------------------------------------------
-				
-				// Applying continental shaping
-				// -----------------------------------------------------------------------------
-				float offset = (static_cast<float>(globalZ) - baseHeight) / baseHeight;
-				densityValue -= heightOffset;
-				densityValue += (squashingFactor * SQUASH_MULT) * offset;
-				// -----------------------------------------------------------------------------
-
-				// Caves
-				// -----------------------------------------------------------------------------
-				bool isCave = false;
-				bool chunkHasCaves = (Get2dNoiseZeroToOne(m_chunkCoords.x, m_chunkCoords.y, GAME_SEED + 9999) > 0.925f);
-				bool belowSurface = (surfaceZ != -1 && chunkZ < surfaceZ);
-
-				if (chunkHasCaves && belowSurface)
-				{
-					// Perlin Worm Tunnels
-					{
-						float wormNoise = Compute3dPerlinNoise(globalX * 0.05f, globalY * 0.05f, globalZ * 0.05f, 1.0f, 3, 0.5f, 2.0f, true, GAME_SEED + 777);
-						if (fabsf(wormNoise) < 0.1f) 
-						{
-							densityValue = 1.0f;
-							isCave = true;
-						}
-					}
-
-					// Cheese Caves
-					{
-						float caveMask = Compute3dPerlinNoise(globalX * 0.03f, globalY * 0.03f, globalZ * 0.03f, 1.0f, 2, 0.5f, 2.0f, true, GAME_SEED + 900);
-						if (caveMask > 0.55f)
-						{
-							densityValue = 1.0f;
-							isCave = true;
-						}
-					}
-
-					// Spherical Cavern
-					{
-						float roomChance = Get3dNoiseZeroToOne(globalX, globalY, globalZ, GAME_SEED + 1234);
-						if (roomChance > 0.995f) 
-						{
-							Vec3 center = Vec3(floorf(globalX / 12.f) * 12, floorf(globalY / 12.f) * 12, floorf(globalZ / 12.f) * 12);
-							Vec3 position = Vec3(static_cast<float>(globalX), static_cast<float>(globalY), static_cast<float>(globalZ));
-							float dist = (position - center).GetLength();
-							if (dist < 8.0f) 
-							{
-								densityValue = 1.0f;
-								isCave = true;
-							}
-						}
-					}
-				}
-
-				// -----------------------------------------------------------------------------
-
-				// Block type assignemnt
-				// -----------------------------------------------------------------------------
-				if (densityValue < 0.f)
-				{
-					if (surfaceDepthCounter < SURFACE_LAYER_DEPTH)
-					{
-						if (globalZ >= SEA_LEVEL)
-						{
-							if (surfaceDepthCounter == 0)
-							{
-								block->SetBlockType(surface.top);
-							}
-							else
-							{
-								block->SetBlockType(surface.sub);
-							}
-						}
-						else
-						{
-							block->SetBlockType(surface.underwater);
-						}
-						surfaceDepthCounter += 1;
-					}
-					else
-					{
-						if (globalZ == OBSIDIAN_Z)
-						{
-							block->SetBlockType(BLOCKTYPE_OBSIDIAN);
-						}
-						else if (globalZ == LAVA_Z)
-						{
-							block->SetBlockType(BLOCKTYPE_LAVA);
-						}
-						else
-						{
-							OreChance(globalX, globalY, globalZ, block);
-						}
-					}
-					if (surfaceZ == -1)
-					{
-						surfaceZ = chunkZ;
-					}
-				}
-				else
-				{
-					surfaceDepthCounter = 0;
-					if (globalZ < SEA_LEVEL)
-					{
-						if (!isCave)
-						{
-							block->SetBlockType(BLOCKTYPE_WATER);
-						}
-						else if (block->m_blockType != BLOCKTYPE_WATER)
-						{
-							block->SetBlockType(BLOCKTYPE_AIR);
-						}
-					}
-					else
-					{
-						block->SetBlockType(BLOCKTYPE_AIR);
-					}
-				}
-				// -----------------------------------------------------------------------------
-
-				// Trees
-				// -----------------------------------------------------------------------------
-				if (surfaceZ >= 0 && surfaceZ == chunkZ)
-				{
-					float treeNoise = treeNoiseMap[chunkIndex];
-					if (treeNoise > 0.975f)
-					{
-						Block* surfaceBlock = &m_blocks[GetBlockIndex(chunkX, chunkY, surfaceZ)];
-						uint8_t surfaceType = surfaceBlock->m_blockType;
-
-						if (surfaceBlock->m_blockType != BLOCKTYPE_WATER)
-						{
-							TreeStamp const* stamp = nullptr;
-							float treeVariantNoise = treeVariantNoiseMap[chunkIndex];
-
-							if (biome == BIOME_FOREST)
-							{
-								if (surfaceType == BLOCKTYPE_GRASS || surfaceType == BLOCKTYPE_DIRT)
-								{
-
-									if (treeVariantNoise < 0.33f)
-									{
-										stamp = &g_treeStamps["oak_small"];
-									}
-									else if (treeVariantNoise < 0.66f)
-									{
-										stamp = &g_treeStamps["oak_large"];
-									}
-									else
-									{
-										stamp = &g_treeStamps["birch"];
-									}
-								}
-							}
-							else if (biome == BIOME_TAIGA)
-							{
-								if (surfaceType == BLOCKTYPE_GRASSLIGHT)
-								{
-									stamp = &g_treeStamps["spruce"];
-								}
-							}
-							else if (biome == BIOME_SNOWY_TAIGA)
-							{
-								if (surfaceType == BLOCKTYPE_SNOW)
-								{
-									stamp = &g_treeStamps["snowy_spruce"];
-								}
-							}
-							else if (biome == BIOME_DESERT)
-							{
-								if (surfaceType == BLOCKTYPE_SAND)
-								{
-									stamp = &g_treeStamps["cactus"];
-								}
-							}
-							else if (biome == BIOME_SAVANNA)
-							{
-								if (surfaceType == BLOCKTYPE_GRASSYELLOW)
-								{
-									stamp = &g_treeStamps["acacia"];
-								}
-							}
-							else if (biome == BIOME_JUNGLE)
-							{
-								if (surfaceType == BLOCKTYPE_GRASSDARK)
-								{
-									stamp = &g_treeStamps["jungle"];
-								}
-							}
-
-							if (stamp != nullptr)
-							{
-								int aboveSurfaceIndex = GetBlockIndex(chunkX, chunkY, surfaceZ + 1);
-								Block* aboveSurfaceBlock = &m_blocks[aboveSurfaceIndex];
-
-								if (aboveSurfaceBlock->m_blockType == BLOCKTYPE_WATER)
-								{
-									continue;
-								}
-
-								if (chunkX >= stamp->radius && chunkX < CHUNK_SIZE_X - stamp->radius &&
-									chunkY >= stamp->radius && chunkY < CHUNK_SIZE_Y - stamp->radius)
-								{
-									TryToPlaceTreeStamp(*stamp, chunkX, chunkY, surfaceZ + 1);
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-	}
+	ChunkMeshSnapshot snapshot;
+	CaptureMeshSnapshot(snapshot);
+	m_meshStats = BuildMeshFromSnapshot(snapshot, m_vertexes);
+	m_visibility = BuildVisibilityFromSnapshot(snapshot);
+	CreateBuffers();
+	g_theGame->m_currentWorld->EnsureQuadIndexCapacity(GetQuadCount());
 }
 
-void Chunk::OreChance(int globalX, int globalY, int globalZ, Block* block)
+void Chunk::CaptureMeshSnapshot(ChunkMeshSnapshot& outSnapshot) const
 {
-	// Diamond veins
-	float diamondNoise = Compute3dPerlinNoise(globalX * 0.09f, globalY * 0.09f, globalZ * 0.09f,
-		1.0f, 3, 0.5f, 2.0f, true,
-		GAME_SEED + 20100);
-
-	if (diamondNoise > 0.75f && globalZ < 20)
-	{
-		block->SetBlockType(BLOCKTYPE_DIAMOND);
-		return;
-	}
-
-	// Gold veins
-	float goldNoise = Compute3dPerlinNoise(globalX * 0.09f, globalY * 0.09f, globalZ * 0.09f,
-		1.0f, 3, 0.5f, 2.0f, true,
-		GAME_SEED + 20200);
-
-	if (goldNoise > 0.65f && globalZ < 40)
-	{
-		block->SetBlockType(BLOCKTYPE_GOLD);
-		return;
-	}
-
-	// Iron veins
-	float ironNoise = Compute3dPerlinNoise(globalX * 0.08f, globalY * 0.08f, globalZ * 0.08f,
-		1.0f, 4, 0.5f, 2.0f, true,
-		GAME_SEED + 20300);
-
-	if (ironNoise > 0.5f)
-	{
-		block->SetBlockType(BLOCKTYPE_IRON);
-		return;
-	}
+	outSnapshot.m_chunkCoords = m_chunkCoords;
+	outSnapshot.m_editGeneration = m_meshEditGeneration;
+	outSnapshot.m_lightingEnabled = g_theGame->m_currentWorld->m_lightingEnabled;
+	outSnapshot.m_meshingMode = g_theGame->m_currentWorld->m_meshingMode;
+	outSnapshot.m_blockTypes.assign(MESH_SNAPSHOT_NUM_BLOCKS, BLOCKTYPE_AIR);
+	outSnapshot.m_lightInfluence.assign(MESH_SNAPSHOT_NUM_BLOCKS, 0);
 
-	// Coal veins
-	float coalNoise = Compute3dPerlinNoise(globalX * 0.075f, globalY * 0.075f, globalZ * 0.075f,
-		1.0f, 3, 0.5f, 2.0f, true,
-		GAME_SEED + 20400);
-
-	if (coalNoise > 0.45f)
-	{
-		block->SetBlockType(BLOCKTYPE_COAL);
-		return;
-	}
-
-	block->SetBlockType(BLOCKTYPE_STONE);
-}
-
-void Chunk::TryToPlaceTreeStamp(TreeStamp const& treeStamp, int localX, int localY, int localZ)
-{
-	for (auto const& [offset, blocktype] : treeStamp.blocks)
+	// Interior, then the one-block border row from each neighbor; corners are never read
+	for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
 	{
-		IntVec3 treePosition = IntVec3(localX + offset.x, localY + offset.y, localZ + offset.z);
-		IntVec2 neighborChunkOffset = IntVec2::ZERO;
-		IntVec3 blockPositionInTarget = treePosition;
-
-		// X
-		if (treePosition.x < 0)
-		{
-			neighborChunkOffset.x = -1;
-			blockPositionInTarget.x += CHUNK_SIZE_X;
-		}
-		else if (treePosition.x >= CHUNK_SIZE_X)
-		{
-			neighborChunkOffset.x = 1;
-			blockPositionInTarget.x -= CHUNK_SIZE_X;
-		}
-
-		// Y
-		if (treePosition.y < 0)
-		{
-			neighborChunkOffset.y = -1;
-			blockPositionInTarget.y += CHUNK_SIZE_Y;
-		}
-		else if (treePosition.y >= CHUNK_SIZE_Y)
-		{
-			neighborChunkOffset.y = 1;
-			blockPositionInTarget.y -= CHUNK_SIZE_Y;
-		}
-
-		// Skipping blocks below or above world height
-		if (blockPositionInTarget.z < 0 || blockPositionInTarget.z >= CHUNK_SIZE_Z)
+		for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
 		{
-			continue;
+			for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+			{
+				outSnapshot.CopyBlock(chunkX, chunkY, chunkZ, m_blocks[GetBlockIndex(chunkX, chunkY, chunkZ)]);
+			}
 		}
 
-		// Finding the target chunk
-		Chunk* targetChunk = g_theGame->m_currentWorld->GetWorldChunk(m_chunkCoords + neighborChunkOffset);
-		if (!targetChunk)
+		for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
 		{
-			continue;
+			if (m_eastNeighbor)
+			{
+				outSnapshot.CopyBlock(CHUNK_SIZE_X, chunkY, chunkZ, m_eastNeighbor->m_blocks[GetBlockIndex(0, chunkY, chunkZ)]);
+			}
+			if (m_westNeighbor)
+			{
+				outSnapshot.CopyBlock(-1, chunkY, chunkZ, m_westNeighbor->m_blocks[GetBlockIndex(CHUNK_MASK_X, chunkY, chunkZ)]);
+			}
 		}
-
-		int index = targetChunk->GetBlockIndex(blockPositionInTarget);
-		Block& block = targetChunk->m_blocks[index];
-
-		if (block.m_blockType == BLOCKTYPE_AIR)
+		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
 		{
-			block.SetBlockType(blocktype);
+			if (m_northNeighbor)
+			{
+				outSnapshot.CopyBlock(chunkX, CHUNK_SIZE_Y, chunkZ, m_northNeighbor->m_blocks[GetBlockIndex(chunkX, 0, chunkZ)]);
+			}
+			if (m_southNeighbor)
+			{
+				outSnapshot.CopyBlock(chunkX, -1, chunkZ, m_southNeighbor->m_blocks[GetBlockIndex(chunkX, CHUNK_MASK_Y, chunkZ)]);
+			}
 		}
 	}
-}
-
-int Chunk::GetTemperatureBand(float v)
-{
-	if (v < -0.45f) return 0;
-	if (v < -0.15f) return 1;
-	if (v < 0.20f) return 2; 
-	if (v < 0.55f) return 3;
-	return 4;
-}
 
-int Chunk::GetHumidityBand(float v)
-{
-	if (v < -0.35f) return 0; 
-	if (v < -0.10f) return 1; 
-	if (v < 0.10f) return 2;
-	if (v < 0.30f) return 3; 
-	return 4;
-}
-
-int Chunk::GetContinentalnessBand(float v)
-{
-	if (v < -1.05f) return 0;      // Deep Ocean
-	if (v < -0.455f) return 1;    // Deep Ocean
-	if (v < -0.19f) return 2;    // Ocean
-	if (v < -0.11f) return 3;   // Coast
-	if (v < 0.03f) return 4;   // Near-Inland
-	if (v < 0.30f) return 5;  // Mid-Inland
-	return 6;                // Far-Inland
+	// The world resolves sprite cells once; the copy is a few hundred bytes and keeps workers off world memory
+	outSnapshot.m_faceSpriteCells = g_theGame->m_currentWorld->m_faceSpriteCells;
 }
 
-BiomeType Chunk::GetBiomeType(BiomeParams const& biome)
+ChunkMeshStats Chunk::BuildMeshFromSnapshot(ChunkMeshSnapshot const& snapshot, std::vector<ChunkVertex>& outVertexes)
 {
-	int temp = GetTemperatureBand(biome.temperature);
-	int humidity = GetHumidityBand(biome.humidity);
-	int continent = GetContinentalnessBand(biome.continentalness);
-
-	// Oceanic regions
-	if (continent <= 2) 
-	{
-		if (temp == 0) return BIOME_FROZEN_OCEAN;
-		if (continent <= 1) return BIOME_DEEP_OCEAN;
-		return BIOME_OCEAN;
-	}
-
-	// Coasts / beaches
-	if (continent == 3) 
-	{
-		if (temp == 0) return BIOME_SNOWY_BEACH;
-		if (temp < 4) return BIOME_BEACH;
-		return BIOME_DESERT;
-	}
-
-	// Inland regions
-	// Temperature + Humidity table
-	if (temp == 0) 
-	{
-		if (humidity <= 1)
-		{
-			return BIOME_SNOWY_PLAINS;
-		}
-		if (humidity == 3)
-		{
-			return BIOME_SNOWY_TAIGA;
-		}
-		else
-		{
-			return BIOME_TAIGA;
-		}
-	}
-	else if (temp == 1) 
+	std::vector<ChunkMeshQuad> quads;
+	if (snapshot.m_meshingMode == MeshingMode::GREEDY)
 	{
-		if (humidity <= 1)
-		{
-			return BIOME_PLAINS;
-		}
-		if (humidity >= 3)
-		{
-			return BIOME_FOREST;
-		}
-		else
-		{
-			return BIOME_TAIGA;
-		}
+		BuildGreedyQuads(snapshot, quads);
 	}
-	else if (temp == 2) 
-	{
-		if (humidity <= 1)
-		{
-			return BIOME_PLAINS;
-		}
-		if (humidity >= 3)
-		{
-			return BIOME_FOREST;
-		}
-		else
-		{
-			return BIOME_FOREST;
-		}
-	}
-	else if (temp == 3) 
-	{
-		if (humidity <= 1)
-		{
-			return BIOME_SAVANNA;
-		}
-		if (humidity >= 3)
-		{
-			return BIOME_JUNGLE;
-		}
-		else
-		{
-			return BIOME_FOREST;
-		}
-	}
-	else 
+	else
 	{
-		if (humidity <= 2)
-		{
-			return BIOME_DESERT;
-		}
-		else
-		{
-			return BIOME_BADLANDS;
-		}
+		BuildPerFaceQuads(snapshot, quads);
 	}
-}
 
-
-SurfaceBlocks Chunk::GetSurfaceBlocks(BiomeType biome)
-{
-	switch (biome)
+	ChunkMeshStats stats;
+	outVertexes.clear();
+	outVertexes.reserve(quads.size() * 4);
+	for (ChunkMeshQuad const& quad : quads)
 	{
-	// Oceans & Beaches
-		case BIOME_OCEAN:
-		case BIOME_DEEP_OCEAN:
-			return { BLOCKTYPE_SAND, BLOCKTYPE_ICE, BLOCKTYPE_SAND };
-		case BIOME_FROZEN_OCEAN:
-			return { BLOCKTYPE_SNOW, BLOCKTYPE_ICE, BLOCKTYPE_SAND };
-		case BIOME_BEACH:
-			return { BLOCKTYPE_SAND, BLOCKTYPE_SAND, BLOCKTYPE_SAND };
-		case BIOME_SNOWY_BEACH:
-			return { BLOCKTYPE_SNOW, BLOCKTYPE_SNOW, BLOCKTYPE_SAND };
-
-	// Hot desert areas
-		case BIOME_DESERT:
-			return { BLOCKTYPE_SAND, BLOCKTYPE_SAND, BLOCKTYPE_SAND };
-		case BIOME_BADLANDS:
-			return { BLOCKTYPE_GRASSLIGHT, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
-
-	// Forests
-		case BIOME_PLAINS:
-			return { BLOCKTYPE_GRASS, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
-		case BIOME_FOREST:
-			return { BLOCKTYPE_GRASS, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
-		case BIOME_TAIGA:
-			return { BLOCKTYPE_GRASSLIGHT, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
-		case BIOME_SNOWY_TAIGA:
-			return { BLOCKTYPE_SNOW, BLOCKTYPE_ICE, BLOCKTYPE_STONE };
-		case BIOME_SNOWY_PLAINS:
-			return { BLOCKTYPE_SNOW, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
-
-	// Jungle / Savanna
-		case BIOME_JUNGLE:
-			return { BLOCKTYPE_GRASSDARK, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
-		case BIOME_SAVANNA:
-			return { BLOCKTYPE_GRASSYELLOW, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
-
-		default:
-			return { BLOCKTYPE_STONE, BLOCKTYPE_STONE, BLOCKTYPE_STONE };
+		AddVertsForMeshQuad(outVertexes, quad);
+		stats.m_numFaces += quad.m_size.x * quad.m_size.y * quad.m_size.z;
 	}
+	stats.m_numQuads = static_cast<int>(quads.size());
+	return stats;
 }
+#endif
 
-void Chunk::PopulateChunksWithNoise()
+void ChunkMeshSnapshot::CopyBlock(int localX, int localY, int localZ, Block const& block)
 {
-	unsigned int terrainSeed = GAME_SEED;
-	unsigned int humiditySeed = terrainSeed + 1;
-	unsigned int temperatureSeed = humiditySeed + 1;
-	unsigned int hillSeed = temperatureSeed + 1;
-	unsigned int oceanSeed = hillSeed + 1;
-	unsigned int dirtSeed = oceanSeed + 1;
-
-	std::vector<int> heightMapXY(CHUNK_SIZE_X * CHUNK_SIZE_Y);
-	std::vector<int> dirtDepthXY(CHUNK_SIZE_X * CHUNK_SIZE_Y);
-	std::vector<float> humidityMapXY(CHUNK_SIZE_X * CHUNK_SIZE_Y);
-	std::vector<float> tempMapXY(CHUNK_SIZE_X * CHUNK_SIZE_Y);
-
-	// Generating the noise maps
-	GenerateNoiseMaps(humiditySeed, humidityMapXY, temperatureSeed, tempMapXY, hillSeed, oceanSeed, terrainSeed, dirtSeed, dirtDepthXY, heightMapXY);
-
-	// Fill the blocks based on noise maps
-	PopulateTerrainBlocks(heightMapXY, dirtDepthXY, humidityMapXY, tempMapXY, terrainSeed);
-
-	// Generate vegetation
-	PopulateTrees(heightMapXY, humidityMapXY, tempMapXY);
+	int snapshotIndex = GetIndex(localX, localY, localZ);
+	m_blockTypes[snapshotIndex] = block.m_blockType;
+	m_lightInfluence[snapshotIndex] = block.m_lightInfluenceData;
 }
 
-void Chunk::GenerateNoiseMaps(unsigned int humiditySeed, std::vector<float>& humidityMapXY, unsigned int temperatureSeed, std::vector<float>& tempMapXY, unsigned int hillSeed, unsigned int oceanSeed, unsigned int terrainSeed, unsigned int dirtSeed, std::vector<int>& dirtDepthXY, std::vector<int>& heightMapXY)
+void Chunk::BuildPerFaceQuads(ChunkMeshSnapshot const& snapshot, std::vector<ChunkMeshQuad>& outQuads)
 {
-	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+	for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
 	{
-		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+		for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
 		{
-			int chunkGlobalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
-			int chunkGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
-			int blockIndexXY = chunkY * CHUNK_SIZE_X + chunkX;
-
-			// Humidity
-			float humidityNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), HUMIDITY_NOISE_SCALE, HUMIDITY_NOISE_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, humiditySeed);
-			float humidity = 0.5f + 0.5f * humidityNoise;
-			humidityMapXY[blockIndexXY] = humidity;
-
-			// Temperature
-			float temperatureRaw = Get2dNoiseNegOneToOne(chunkGlobalX, chunkGlobalY, temperatureSeed) * TEMPERATURE_RAW_NOISE_SCALE;
-			float temperatureNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), TEMPERATURE_NOISE_SCALE, TEMPERATURE_NOISE_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, temperatureSeed);
-			float temperature = temperatureRaw + 0.5f + 0.5f * temperatureNoise;
-			tempMapXY[blockIndexXY] = temperature;
-
-			// Hills
-			float hillNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), HILLINESS_NOISE_SCALE, HILLINESS_NOISE_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, hillSeed);
-			float hillNormalized = (hillNoise + 1.f) * 0.5f;
-			float hill = SmoothStep3(hillNormalized);
-
-			// Ocean
-			float oceanNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), OCEANESS_NOISE_SCALE, OCEANESS_NOISE_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, oceanSeed);
-
-			// Terrain
-			float terrainNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), TERRAIN_NOISE_SCALE, TERRAIN_NOISE_OCTAVES,
-				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, terrainSeed);
-			float riverValleyTerrain = fabsf(terrainNoise);
-			float baseTerrainHeight = DEFAULT_TERRAIN_HEIGHT + hill * RangeMap(riverValleyTerrain, 0.f, 1.f, -RIVER_DEPTH, DEFAULT_TERRAIN_HEIGHT);
-
-			// Ocean dips
-			if (oceanNoise > OCEAN_START_THRESHOLD)
+			for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
 			{
-				float oceanBlend = (oceanNoise - OCEAN_START_THRESHOLD) / (OCEAN_END_THRESHOLD - OCEAN_START_THRESHOLD);
-				oceanBlend = GetClamped(oceanBlend, 0.f, 1.f);
-				baseTerrainHeight -= Interpolate(0.f, OCEAN_DEPTH, oceanBlend);
-			}
-
-			int terrainHeight = static_cast<int>(floorf(baseTerrainHeight));
-
-			// Dirt depth
-			float dirtDepthNoise = Get2dNoiseZeroToOne(chunkGlobalX, chunkGlobalY, dirtSeed);
-			int dirtSubZ = MIN_DIRT_OFFSET_Z + RoundDownToInt(dirtDepthNoise * (MAX_DIRT_OFFSET_Z - MIN_DIRT_OFFSET_Z));
-			dirtDepthXY[blockIndexXY] = dirtSubZ;
+				for (int blockFace = 0; blockFace < NUM_BLOCKFACES; ++blockFace)
+				{
+					uint32_t appearanceKey = GetFaceAppearanceKey(snapshot, chunkX, chunkY, chunkZ, blockFace);
+					if (appearanceKey == 0)
+					{
+						continue;
+					}
 
-			heightMapXY[blockIndexXY] = terrainHeight;
+					ChunkMeshQuad quad;
+					quad.m_mins = IntVec3(chunkX, chunkY, chunkZ);
+					quad.m_blockFace = static_cast<uint8_t>(blockFace);
+					SetQuadAppearance(snapshot, appearanceKey, quad);
+					outQuads.push_back(quad);
+				}
+			}
 		}
 	}
 }
 
-void Chunk::PopulateTerrainBlocks(std::vector<int> heightMapXY, std::vector<int> dirtDepthXY, std::vector<float> humidityMapXY, std::vector<float> tempMapXY, unsigned int terrainSeed)
+void Chunk::BuildGreedyQuads(ChunkMeshSnapshot const& snapshot, std::vector<ChunkMeshQuad>& outQuads)
 {
-	for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+	// Slices are taken along each face's normal; within a slice, faces are merged first along U, then V
+	std::vector<uint32_t> sliceKeys;
+	for (int blockFace = 0; blockFace < NUM_BLOCKFACES; ++blockFace)
 	{
-		for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+		bool isEastWest = (blockFace == BLOCK_FACE_EAST || blockFace == BLOCK_FACE_WEST);
+		bool isTopBottom = (blockFace == BLOCK_FACE_TOP || blockFace == BLOCK_FACE_BOTTOM);
+		int numSlices = isTopBottom ? CHUNK_SIZE_Z : (isEastWest ? CHUNK_SIZE_X : CHUNK_SIZE_Y);
+		int sizeU = isEastWest ? CHUNK_SIZE_Y : CHUNK_SIZE_X;
+		int sizeV = isTopBottom ? CHUNK_SIZE_Y : CHUNK_SIZE_Z;
+		sliceKeys.resize(sizeU * sizeV);
+
+		for (int slice = 0; slice < numSlices; ++slice)
 		{
-			for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+			for (int v = 0; v < sizeV; ++v)
 			{
-				int blockIndex = GetBlockIndex(chunkX, chunkY, chunkZ);
-				Block* block = &m_blocks[blockIndex];
-				block->m_blockType = BLOCKTYPE_AIR;
-
-				int chunkGlobalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
-				int chunkGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
-				int chunkGlobalZ = chunkZ;
-
-				int blockIndexXY = chunkY * CHUNK_SIZE_X + chunkX;
-				int terrainHeight = heightMapXY[blockIndexXY];
-				int dirtDepth = dirtDepthXY[blockIndexXY];
-				float humidity = humidityMapXY[blockIndexXY];
-				float temperature = tempMapXY[blockIndexXY];
-
-				// Ice
-				float iceDepthFloat = DEFAULT_TERRAIN_HEIGHT - floorf(RangeMapClamped(temperature, ICE_TEMPERATURE_MAX, ICE_TEMPERATURE_MIN, ICE_DEPTH_MIN, ICE_DEPTH_MAX));
-				int iceDepth = static_cast<int>(iceDepthFloat);
-
-				// Water
-				if (chunkGlobalZ > terrainHeight && chunkGlobalZ < SEA_LEVEL_Z)
+				for (int u = 0; u < sizeU; ++u)
 				{
-					if (temperature < 0.38f && chunkGlobalZ > iceDepth)
-					{
-						block->m_blockType = BLOCKTYPE_ICE;
-					}
-					else
-					{
-						block->m_blockType = BLOCKTYPE_WATER;
-					}
+					IntVec3 localCoords = isTopBottom ? IntVec3(u, v, slice) : (isEastWest ? IntVec3(slice, u, v) : IntVec3(u, slice, v));
+					sliceKeys[v * sizeU + u] = GetFaceAppearanceKey(snapshot, localCoords.x, localCoords.y, localCoords.z, blockFace);
 				}
+			}
 
-				// Surface
-				if (chunkGlobalZ == terrainHeight)
+			for (int v = 0; v < sizeV; ++v)
+			{
+				for (int u = 0; u < sizeU; ++u)
 				{
-					BlockType blockType = BLOCKTYPE_GRASS;
-					if (humidity < MIN_SAND_HUMIDITY)
+					uint32_t appearanceKey = sliceKeys[v * sizeU + u];
+					if (appearanceKey == 0)
 					{
-						blockType = BLOCKTYPE_SAND;
+						continue;
 					}
-					if (humidity < MAX_SAND_HUMIDITY && terrainHeight <= static_cast<int>(DEFAULT_TERRAIN_HEIGHT))
+
+					int width = 1;
+					while (u + width < sizeU && sliceKeys[v * sizeU + u + width] == appearanceKey)
 					{
-						blockType = BLOCKTYPE_SAND;
+						++width;
 					}
-					block->m_blockType = blockType;
-				}
 
-				int dirtTopZ = terrainHeight - dirtDepth;
-				int sandTopZ = terrainHeight - static_cast<int>(RoundDownToInt(RangeMapClamped(humidity, MIN_SAND_DEPTH_HUMIDITY, MAX_SAND_DEPTH_HUMIDITY, SAND_DEPTH_MIN, SAND_DEPTH_MAX)));
+					int height = 1;
+					for (bool canGrow = true; canGrow && v + height < sizeV;)
+					{
+						for (int rowU = u; rowU < u + width; ++rowU)
+						{
+							if (sliceKeys[(v + height) * sizeU + rowU] != appearanceKey)
+							{
+								canGrow = false;
+								break;
+							}
+						}
+						height += canGrow ? 1 : 0;
+					}
 
-				if (chunkGlobalZ < terrainHeight && chunkGlobalZ >= dirtTopZ)
-				{
-					BlockType blockType = BLOCKTYPE_DIRT;
-					if (chunkGlobalZ >= sandTopZ)
+					// Claimed faces are cleared so later rows skip them
+					for (int rowV = v; rowV < v + height; ++rowV)
 					{
-						blockType = BLOCKTYPE_SAND;
+						for (int rowU = u; rowU < u + width; ++rowU)
+						{
+							sliceKeys[rowV * sizeU + rowU] = 0;
+						}
 					}
-					block->m_blockType = blockType;
-				}
 
-				// Underground
-				if (chunkGlobalZ < dirtTopZ)
-				{
-					if (chunkGlobalZ == OBSIDIAN_Z)
+					ChunkMeshQuad quad;
+					quad.m_blockFace = static_cast<uint8_t>(blockFace);
+					if (isTopBottom)
 					{
-						block->m_blockType = BLOCKTYPE_OBSIDIAN;
+						quad.m_mins = IntVec3(u, v, slice);
+						quad.m_size = IntVec3(width, height, 1);
 					}
-					else if (chunkGlobalZ == LAVA_Z)
+					else if (isEastWest)
 					{
-						block->m_blockType = BLOCKTYPE_LAVA;
+						quad.m_mins = IntVec3(slice, u, v);
+						quad.m_size = IntVec3(1, width, height);
 					}
 					else
 					{
-						float oreNoise = Get3dNoiseZeroToOne(chunkGlobalX, chunkGlobalY, chunkZ, terrainSeed + 100);
-
-						if (oreNoise < DIAMOND_CHANCE)
-						{
-							block->m_blockType = BLOCKTYPE_DIAMOND;
-						}
-						else if (oreNoise < GOLD_CHANCE)
-						{
-							block->m_blockType = BLOCKTYPE_GOLD;
-						}
-						else if (oreNoise < IRON_CHANCE)
-						{
-							block->m_blockType = BLOCKTYPE_IRON;
-						}
-						else if (oreNoise < COAL_CHANCE)
-						{
-							block->m_blockType = BLOCKTYPE_COAL;
-						}
-						else
-						{
-							block->m_blockType = BLOCKTYPE_STONE;
-						}
+						quad.m_mins = IntVec3(u, slice, v);
+						quad.m_size = IntVec3(width, 1, height);
 					}
+					SetQuadAppearance(snapshot, appearanceKey, quad);
+					outQuads.push_back(quad);
 				}
 			}
 		}
 	}
 }
 
-void Chunk::PopulateTrees(std::vector<int> heightMapXY, std::vector<float> humidityMapXY, std::vector<float> tempMapXY)
+uint32_t Chunk::GetFaceAppearanceKey(ChunkMeshSnapshot const& snapshot, int localX, int localY, int localZ, int blockFace)
 {
-	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+	static IntVec3 const FACE_STEPS[NUM_BLOCKFACES] = { IntVec3(1, 0, 0), IntVec3(-1, 0, 0), IntVec3(0, 1, 0), IntVec3(0, -1, 0), IntVec3(0, 0, 1), IntVec3(0, 0, -1) };
+
+	uint8_t blockType = snapshot.m_blockTypes[ChunkMeshSnapshot::GetIndex(localX, localY, localZ)];
+	BlockDefinition const* blockDef = BlockDefinition::s_blockDefs[blockType];
+	if (!blockDef || !blockDef->m_isVisible)
 	{
-		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
-		{
-			int chunkGlobalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
-			int chunkGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
-			int blockIndexXY = chunkY * CHUNK_SIZE_X + chunkX;
+		return 0;
+	}
 
-			int terrainHeight = heightMapXY[blockIndexXY];
-			float humidity = humidityMapXY[blockIndexXY];
-			float temperature = tempMapXY[blockIndexXY];
+	// Above the top or below the bottom of the world there is no neighbor: always drawn, unlit
+	int neighborZ = localZ + FACE_STEPS[blockFace].z;
+	bool hasNeighbor = (neighborZ >= 0 && neighborZ < CHUNK_SIZE_Z);
+	uint8_t lightInfluence = 0;
+	if (hasNeighbor)
+	{
+		int neighborIndex = ChunkMeshSnapshot::GetIndex(localX + FACE_STEPS[blockFace].x, localY + FACE_STEPS[blockFace].y, neighborZ);
+		BlockDefinition const* neighborDef = BlockDefinition::s_blockDefs[snapshot.m_blockTypes[neighborIndex]];
+		if (neighborDef && neighborDef->m_isOpaque)
+		{
+			return 0;
+		}
+		lightInfluence = snapshot.m_lightInfluence[neighborIndex];
+	}
 
-			// Check to not spawn trees underwater
-			if (terrainHeight < SEA_LEVEL_Z)
-			{
-				continue;
-			}
+	int faceUV = (blockFace == BLOCK_FACE_TOP) ? SNAPSHOT_FACE_UV_TOP : ((blockFace == BLOCK_FACE_BOTTOM) ? SNAPSHOT_FACE_UV_BOTTOM : SNAPSHOT_FACE_UV_SIDE);
+	IntVec2 const& spriteCell = snapshot.m_faceSpriteCells[blockType * NUM_SNAPSHOT_FACE_UVS + faceUV];
 
-			int blockIndex = GetBlockIndex(chunkX, chunkY, terrainHeight);
-			uint8_t surfaceBlockType = m_blocks[blockIndex].m_blockType;
+	// Everything that decides how the face looks; equal keys on the same face direction can be merged
+	if (!snapshot.m_lightingEnabled)
+	{
+		lightInfluence = 0;
+	}
+	return 1u | (static_cast<uint32_t>(spriteCell.x & 0xFF) << 1) | (static_cast<uint32_t>(spriteCell.y & 0xFF) << 9) | (static_cast<uint32_t>(lightInfluence) << 17);
+}
 
-			// Check so that our trees spawn on grass
-			if (surfaceBlockType != BLOCKTYPE_GRASS)
-			{
-				continue;
-			}
+void Chunk::SetQuadAppearance(ChunkMeshSnapshot const& snapshot, uint32_t appearanceKey, ChunkMeshQuad& quad)
+{
+	quad.m_spriteCell = IntVec2(static_cast<int>((appearanceKey >> 1) & 0xFF), static_cast<int>((appearanceKey >> 9) & 0xFF));
 
-			float treeNoise = Get2dNoiseZeroToOne(chunkGlobalX, chunkGlobalY, GAME_SEED);
-			if (treeNoise > 0.0005f)
-			{
-				continue;
-			}
+	quad.m_tint = 255;
+	switch (quad.m_blockFace)
+	{
+		case BLOCK_FACE_EAST:
+		case BLOCK_FACE_WEST:
+		{
+			quad.m_tint = 230;
+			break;
+		}
+		case BLOCK_FACE_NORTH:
+		case BLOCK_FACE_SOUTH:
+		{
+			quad.m_tint = 200;
+			break;
+		}
+	}
 
-			// Choosing a tree type by climate
-			BlockType blockLog = BLOCKTYPE_OAKLOG;
-			BlockType blockLeaves = BLOCKTYPE_OAKLEAVES;
+	// The shader turns each light nibble into a 0-1 influence and applies the tint as brightness
+	quad.m_lightInfluence = static_cast<uint8_t>((appearanceKey >> 17) & 0xFF);
+	quad.m_isLit = snapshot.m_lightingEnabled;
+}
 
-			if (temperature < 0.4f)
-			{
-				blockLog = BLOCKTYPE_SPRUCELOG;
-				blockLeaves = BLOCKTYPE_SPRUCELEAVES;
-			}
-			else if (humidity > 0.7f)
-			{
-				blockLog = BLOCKTYPE_JUNGLELOG;
-				blockLeaves = BLOCKTYPE_JUNGLELEAVES;
-			}
-			else if (humidity < 0.3f)
-			{
-				blockLog = BLOCKTYPE_ACACIALOG;
-				blockLeaves = BLOCKTYPE_ACACIALEAVES;
-			}
-			else if (temperature > 0.8f)
-			{
-				blockLog = BLOCKTYPE_BIRCHLOG;
-				blockLeaves = BLOCKTYPE_BIRCHLEAVES;
-			}
+ChunkVisibility Chunk::BuildVisibilityFromSnapshot(ChunkMeshSnapshot const& snapshot)
+{
+	constexpr int SECTION_NUM_BLOCKS = CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_VISIBILITY_SECTION_HEIGHT;
+	constexpr int SECTION_BITS_XY = CHUNK_BITS_X + CHUNK_BITS_Y;
 
-			// Setting a random trunk height
-			int trunkHeight = 6 + static_cast<int>((Get2dNoiseZeroToOne(chunkGlobalX, chunkGlobalY, GAME_SEED) * 4));
+	ChunkVisibility visibility;
+	std::vector<uint8_t> isUnvisitedOpen(SECTION_NUM_BLOCKS);
+	std::vector<int> floodStack;
+	floodStack.reserve(SECTION_NUM_BLOCKS);
 
-			// Trunk
-			for (int chunkZ = 1; chunkZ <= trunkHeight; ++chunkZ)
-			{
-				int trunkZUp = terrainHeight + chunkZ;
+	for (int section = 0; section < CHUNK_NUM_VISIBILITY_SECTIONS; ++section)
+	{
+		int sectionMinZ = section * CHUNK_VISIBILITY_SECTION_HEIGHT;
+		for (int sectionIndex = 0; sectionIndex < SECTION_NUM_BLOCKS; ++sectionIndex)
+		{
+			int localX = sectionIndex & CHUNK_MASK_X;
+			int localY = (sectionIndex >> CHUNK_BITS_X) & CHUNK_MASK_Y;
+			int localZ = sectionMinZ + (sectionIndex >> SECTION_BITS_XY);
+			BlockDefinition const* blockDef = BlockDefinition::s_blockDefs[snapshot.m_blockTypes[ChunkMeshSnapshot::GetIndex(localX, localY, localZ)]];
+			isUnvisitedOpen[sectionIndex] = (blockDef && blockDef->m_isOpaque) ? 0 : 1;
+		}
 
-				if (trunkZUp >= CHUNK_SIZE_Z)
-				{
-					break;
-				}
+		for (int blockFace = 0; blockFace < NUM_BLOCKFACES; ++blockFace)
+		{
+			visibility.m_connectedFaces[section][blockFace] = 0;
+		}
 
-				int treeBlockIndex = GetBlockIndex(chunkX, chunkY, trunkZUp);
-				m_blocks[treeBlockIndex].m_blockType = blockLog;
+		// Each open region connects every section face it touches to every other one it touches
+		for (int startIndex = 0; startIndex < SECTION_NUM_BLOCKS; ++startIndex)
+		{
+			if (!isUnvisitedOpen[startIndex])
+			{
+				continue;
 			}
 
-			// Leaves
-			for (int treeZ = -2; treeZ <= 2; ++treeZ)
+			uint8_t touchedFaces = 0;
+			isUnvisitedOpen[startIndex] = 0;
+			floodStack.push_back(startIndex);
+			while (!floodStack.empty())
 			{
-				int treeZUp = terrainHeight + trunkHeight + treeZ;
-
-				if (treeZUp < 0 || treeZUp >= CHUNK_SIZE_Z)
+				int sectionIndex = floodStack.back();
+				floodStack.pop_back();
+				int localX = sectionIndex & CHUNK_MASK_X;
+				int localY = (sectionIndex >> CHUNK_BITS_X) & CHUNK_MASK_Y;
+				int sectionZ = sectionIndex >> SECTION_BITS_XY;
+
+				touchedFaces |= (localX == CHUNK_MASK_X) ? (1 << BLOCK_FACE_EAST) : 0;
+				touchedFaces |= (localX == 0) ? (1 << BLOCK_FACE_WEST) : 0;
+				touchedFaces |= (localY == CHUNK_MASK_Y) ? (1 << BLOCK_FACE_NORTH) : 0;
+				touchedFaces |= (localY == 0) ? (1 << BLOCK_FACE_SOUTH) : 0;
+				touchedFaces |= (sectionZ == CHUNK_VISIBILITY_SECTION_HEIGHT - 1) ? (1 << BLOCK_FACE_TOP) : 0;
+				touchedFaces |= (sectionZ == 0) ? (1 << BLOCK_FACE_BOTTOM) : 0;
+
+				int neighborIndexes[NUM_BLOCKFACES] =
 				{
-					continue;
-				}
-
-				for (int treeY = -2; treeY <= 2; ++treeY)
+					(localX < CHUNK_MASK_X) ? sectionIndex + 1 : -1,
+					(localX > 0) ? sectionIndex - 1 : -1,
+					(localY < CHUNK_MASK_Y) ? sectionIndex + CHUNK_SIZE_X : -1,
+					(localY > 0) ? sectionIndex - CHUNK_SIZE_X : -1,
+					(sectionZ < CHUNK_VISIBILITY_SECTION_HEIGHT - 1) ? sectionIndex + (1 << SECTION_BITS_XY) : -1,
+					(sectionZ > 0) ? sectionIndex - (1 << SECTION_BITS_XY) : -1,
+				};
+				for (int neighborIndex : neighborIndexes)
 				{
-					int treeYAcross = chunkY + treeY;
-
-					if (treeYAcross < 0 || treeYAcross >= CHUNK_SIZE_Y)
+					if (neighborIndex >= 0 && isUnvisitedOpen[neighborIndex])
 					{
-						continue;
+						isUnvisitedOpen[neighborIndex] = 0;
+						floodStack.push_back(neighborIndex);
 					}
+				}
+			}
 
-					for (int treeX = -2; treeX <= 2; ++treeX)
-					{
-						int treeXAcross = chunkX + treeX;
-
-						if (treeXAcross < 0 || treeXAcross >= CHUNK_SIZE_X)
-						{
-							continue;
-						}
-
-						float treeSpread = sqrtf(static_cast<float>((treeX * treeX) + (treeY * treeY) + (treeZ * treeZ)));
-						if (treeSpread > 2.5f)
-						{
-							continue;
-						}
-
-						int treeLeafIndex = GetBlockIndex(treeXAcross, treeYAcross, treeZUp);
-						if (m_blocks[treeLeafIndex].m_blockType == BLOCKTYPE_AIR)
-						{
-							m_blocks[treeLeafIndex].m_blockType = blockLeaves;
-						}
-					}
+			for (int blockFace = 0; blockFace < NUM_BLOCKFACES; ++blockFace)
+			{
+				if (touchedFaces & (1 << blockFace))
+				{
+					visibility.m_connectedFaces[section][blockFace] |= touchedFaces;
 				}
 			}
 		}
 	}
+	return visibility;
 }
 
-void Chunk::GenerateChunkMesh()
+MeshingReport Chunk::CompareGreedyMeshing(ChunkMeshSnapshot const& snapshot)
 {
-	m_vertexes.clear();
-	m_indices.clear();
+	MeshingReport report;
+	std::vector<ChunkMeshQuad> perFaceQuads;
+	double perFaceStartTime = GetCurrentTimeSeconds();
+	BuildPerFaceQuads(snapshot, perFaceQuads);
+	report.m_perFaceSeconds = GetCurrentTimeSeconds() - perFaceStartTime;
 
-	for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+	std::vector<ChunkMeshQuad> greedyQuads;
+	double greedyStartTime = GetCurrentTimeSeconds();
+	BuildGreedyQuads(snapshot, greedyQuads);
+	report.m_greedySeconds = GetCurrentTimeSeconds() - greedyStartTime;
+
+	// Every block face each mesh covers, with how it is drawn; the two lists must match exactly
+	auto appendCoveredFaces = [](std::vector<ChunkMeshQuad> const& quads, std::vector<uint64_t>& outFaces, ChunkMeshStats& outStats)
 	{
-		for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+		for (ChunkMeshQuad const& quad : quads)
 		{
-			for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+			uint32_t color = quad.m_lightInfluence | (quad.m_tint << 8) | ((quad.m_isLit ? 1 : 0) << 16);
+			for (int offsetZ = 0; offsetZ < quad.m_size.z; ++offsetZ)
 			{
-				int blockIndex = GetBlockIndex(chunkX, chunkY, chunkZ);
-				BlockIterator blockIterator(this, blockIndex);
-				Block* block = &m_blocks[blockIterator.m_blockIndex];
-				BlockDefinition* blockDef = BlockDefinition::s_blockDefs[block->m_blockType];
-
-				if (!blockDef || !blockDef->m_isVisible)
-				{
-					continue;
-				}
-
-				float blockPosX = static_cast<float>(m_chunkCoords.x * CHUNK_SIZE_X + chunkX);
-				float blockPosY = static_cast<float>(m_chunkCoords.y * CHUNK_SIZE_Y + chunkY);
-				float blockPosZ = static_cast<float>(chunkZ);
-				Vec3  blockPos = Vec3(blockPosX, blockPosY, blockPosZ);
-
-				for (int blockFace = 0; blockFace < NUM_BLOCKFACES; ++blockFace)
+				for (int offsetY = 0; offsetY < quad.m_size.y; ++offsetY)
 				{
-					BlockIterator neighbor = blockIterator.GetNeighbor(static_cast<BlockFace>(blockFace));
-					bool drawFace = true;
-
-					if (neighbor.IsValid()) 
+					for (int offsetX = 0; offsetX < quad.m_size.x; ++offsetX)
 					{
-						Block* neighborBlock = &neighbor.m_chunk->m_blocks[neighbor.m_blockIndex];
-						BlockDefinition* neighborDef = BlockDefinition::s_blockDefs[neighborBlock->m_blockType];
-						if (neighborDef && neighborDef->m_isOpaque) 
-						{
-							drawFace = false;
-						}
-					}
-
-					if (!drawFace)
-					{
-						continue;
+						uint64_t blockIndex = static_cast<uint64_t>((quad.m_mins.x + offsetX) + ((quad.m_mins.y + offsetY) << CHUNK_BITS_X) + ((quad.m_mins.z + offsetZ) << (CHUNK_BITS_X + CHUNK_BITS_Y)));
+						uint64_t appearance = static_cast<uint64_t>(quad.m_spriteCell.x & 0xFF) | (static_cast<uint64_t>(quad.m_spriteCell.y & 0xFF) << 8) | (static_cast<uint64_t>(color) << 16);
+						outFaces.push_back((appearance << 20) | (blockIndex << 3) | quad.m_blockFace);
 					}
+				}
+			}
+			outStats.m_numFaces += quad.m_size.x * quad.m_size.y * quad.m_size.z;
+		}
+		outStats.m_numQuads = static_cast<int>(quads.size());
+	};
 
-					IntVec2 spriteCoords = IntVec2::ZERO;
-					Rgba8	colorTint = Rgba8::WHITE;
+	std::vector<uint64_t> perFaceFaces;
+	std::vector<uint64_t> greedyFaces;
+	appendCoveredFaces(perFaceQuads, perFaceFaces, report.m_perFace);
+	appendCoveredFaces(greedyQuads, greedyFaces, report.m_greedy);
+	std::sort(perFaceFaces.begin(), perFaceFaces.end());
+	std::sort(greedyFaces.begin(), greedyFaces.end());
 
-					switch (blockFace)
-					{
-						case BLOCK_FACE_TOP:
-						{
-							spriteCoords = blockDef->m_topSpriteCoords;
-							colorTint = Rgba8::WHITE;
-							break;
-						}
-						case BLOCK_FACE_BOTTOM:
-						{
-							spriteCoords = blockDef->m_bottomSpriteCoords;
-							colorTint = Rgba8::WHITE;
-							break;
-						}
-						case BLOCK_FACE_EAST:
-						{
-							spriteCoords = blockDef->m_sideSpriteCoords;
-							colorTint = Rgba8(230, 230, 230);
-							break;
-						}
-						case BLOCK_FACE_WEST:
-						{
-							spriteCoords = blockDef->m_sideSpriteCoords;
-							colorTint = Rgba8(230, 230, 230);
-							break;
-						}
-						case BLOCK_FACE_NORTH:
-						{
-							spriteCoords = blockDef->m_sideSpriteCoords;
-							colorTint = Rgba8(200, 200, 200);
-							break;
-						}
-						case BLOCK_FACE_SOUTH:
-						{
-							spriteCoords = blockDef->m_sideSpriteCoords;
-							colorTint = Rgba8(200, 200, 200);
-							break;
-						}
-					}
-					BlockIterator neighborBlockIterator = blockIterator.GetNeighbor(static_cast<BlockFace>(blockFace));
-					Block* neighborBlock = neighborBlockIterator.GetBlock();
-					uint8_t outdoorLight = 0;
-					uint8_t indoorLight = 0;
+	std::vector<uint64_t> mismatchedFaces;
+	std::set_symmetric_difference(perFaceFaces.begin(), perFaceFaces.end(), greedyFaces.begin(), greedyFaces.end(), std::back_inserter(mismatchedFaces));
+	report.m_numMismatchedFaces = static_cast<int>(mismatchedFaces.size());
+	return report;
+}
 
-					if (neighborBlock)
-					{
-						outdoorLight = neighborBlock->GetOutdoorLight();
-						indoorLight = neighborBlock->GetIndoorLight();
-					}
+#if !defined(HEADLESS_WORLDGEN)
+MeshingReport Chunk::MeasureGreedyMeshing() const
+{
+	ChunkMeshSnapshot snapshot;
+	CaptureMeshSnapshot(snapshot);
+	return CompareGreedyMeshing(snapshot);
+}
 
-					uint8_t redOutdoorChannel = (outdoorLight * 255) / 15;
-					uint8_t greenIndoorChannel = (indoorLight * 255) / 15;
-					Rgba8 vertexColor(redOutdoorChannel, greenIndoorChannel, colorTint.b, 255);
-					if (!g_theGame->m_currentWorld->m_lightingEnabled)
-					{
-						vertexColor = colorTint;
-					}
-					AABB2 uv = m_spriteSheet->GetSpriteUVCoords(spriteCoords);
-					AddVertsForBlockFace(blockPos, blockFace, vertexColor, uv);
-				}
-			}
-		}
-	}
+void Chunk::SetMesh(std::vector<ChunkVertex>& vertexes)
+{
+	m_vertexes.swap(vertexes);
 	CreateBuffers();
 }
 
@@ -1074,27 +484,19 @@ void Chunk::CreateBuffers()
 		return;
 	}
 
-	if (m_indices.empty())
-	{
-		return;
-	}
-
 	DeleteBuffers();
 
-	m_vertexBuffer = g_theRenderer->CreateVertexBuffer(static_cast<unsigned int>(m_vertexes.size()) * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
-	m_indexBuffer = g_theRenderer->CreateIndexBuffer(static_cast<unsigned int>(m_indices.size()) * sizeof(unsigned int), sizeof(unsigned int));
-	g_theRenderer->CopyCPUToGPU(m_vertexes.data(), m_vertexBuffer->GetSize(), m_vertexBuffer);
-	g_theRenderer->CopyCPUToGPU(m_indices.data(), m_indexBuffer->GetSize(), m_indexBuffer);
+	unsigned int vertexBytes = static_cast<unsigned int>(m_vertexes.size()) * sizeof(ChunkVertex);
+	m_vertexBuffer = g_theRenderer->CreateVertexBuffer(vertexBytes, sizeof(ChunkVertex));
+	g_theRenderer->CopyCPUToGPU(m_vertexes.data(), vertexBytes, m_vertexBuffer);
 }
 
 void Chunk::DeleteBuffers()
 {
 	delete m_vertexBuffer;
 	m_vertexBuffer = nullptr;
-
-	delete m_indexBuffer;
-	m_indexBuffer = nullptr;
 }
+#endif
 
 int Chunk::GetBlockIndex(int x, int y, int z) const
 {
@@ -1224,68 +626,300 @@ int Chunk::GetVertexCount() const
 
 int Chunk::GetIndexCount() const
 {
-	return static_cast<int>(m_indices.size());
+	return GetQuadCount() * 6;
+}
+
+int Chunk::GetQuadCount() const
+{
+	return static_cast<int>(m_vertexes.size()) / 4;
+}
+
+int Chunk::GetMeshByteCount() const
+{
+	return static_cast<int>(m_vertexes.size() * sizeof(ChunkVertex));
+}
+
+int Chunk::ApplyBlockWrites(std::vector<PendingBlockWrite> const& blockWrites)
+{
+	// Decoration from a neighbor never replaces anything this chunk already placed
+	int numApplied = 0;
+	for (int writeIndex = 0; writeIndex < static_cast<int>(blockWrites.size()); ++writeIndex)
+	{
+		PendingBlockWrite const& blockWrite = blockWrites[writeIndex];
+		Block& block = m_blocks[blockWrite.m_blockIndex];
+		if (block.m_blockType == BLOCKTYPE_AIR)
+		{
+			block.SetBlockType(blockWrite.m_blockType);
+			numApplied += 1;
+		}
+	}
+	return numApplied;
+}
+
+std::string Chunk::GetSaveFilePath(IntVec2 const& chunkCoords)
+{
+	return Stringf("Saves/Chunk(%d,%d).chunk", chunkCoords.x, chunkCoords.y);
+}
+
+void Chunk::WriteBlocksToBuffer(std::vector<uint8_t>& outBuffer) const
+{
+	// Write the header
+	ChunkFileHeader header;
+	outBuffer.push_back(header.m_g);
+	outBuffer.push_back(header.m_c);
+	outBuffer.push_back(header.m_h);
+	outBuffer.push_back(header.m_k);
+	outBuffer.push_back(header.m_version);
+	outBuffer.push_back(header.m_bitsX);
+	outBuffer.push_back(header.m_bitsY);
+	outBuffer.push_back(header.m_bitsZ);
+
+	// Encode the RLE
+	uint8_t currentBlockType = m_blocks[0].GetBlockType();
+	uint8_t runLength = 1;
+
+	for (int blockIndex = 1; blockIndex < CHUNK_BLOCK_TOTAL; ++blockIndex)
+	{
+		uint8_t blockType = m_blocks[blockIndex].GetBlockType();
+		if (blockType == currentBlockType && runLength < 255)
+		{
+			runLength += 1;
+		}
+		else
+		{
+			// Storing the run
+			outBuffer.push_back(currentBlockType);
+			outBuffer.push_back(runLength);
+
+			// Starting a new run
+			currentBlockType = blockType;
+			runLength = 1;
+		}
+	}
+
+	// Storing final run
+	outBuffer.push_back(currentBlockType);
+	outBuffer.push_back(runLength);
+}
+
+bool Chunk::ReadBlocksFromBuffer(std::vector<uint8_t> const& buffer)
+{
+	if (buffer.size() < sizeof(ChunkFileHeader))
+	{
+		return false;
+	}
+
+	// Read the header
+	uint8_t const* bufferPointer = buffer.data();
+	ChunkFileHeader const* header = reinterpret_cast<ChunkFileHeader const*>(bufferPointer);
+	if (header->m_g != 'G' || header->m_c != 'C' || header->m_h != 'H' || header->m_k != 'K')
+	{
+		return false;
+	}
+
+	// Increment the current buffer data pointer by the size of a header
+	bufferPointer += sizeof(ChunkFileHeader);
+
+	// Decode the RLE, a run past the end of the chunk means the file is corrupt
+	int blockIndex = 0;
+	uint8_t const* bufferEnd = buffer.data() + buffer.size();
+	while (bufferPointer + 1 < bufferEnd)
+	{
+		uint8_t blockType = *bufferPointer++;
+		uint8_t runLength = *bufferPointer++;
+		if (blockIndex + runLength > CHUNK_BLOCK_TOTAL)
+		{
+			return false;
+		}
+
+		// Set the blocks
+		for (int setBlockIndex = 0; setBlockIndex < runLength; ++setBlockIndex)
+		{
+			m_blocks[blockIndex++].SetBlockType(blockType);
+		}
+	}
+	return true;
+}
+
+static bool HasPendingWritesFileHeader(std::vector<uint8_t> const& buffer)
+{
+	PendingWritesFileHeader header;
+	return buffer.size() >= sizeof(PendingWritesFileHeader) && buffer[0] == header.m_g && buffer[1] == header.m_c && buffer[2] == header.m_p && buffer[3] == header.m_w;
+}
+
+std::string Chunk::GetPendingWritesFilePath(IntVec2 const& chunkCoords)
+{
+	return Stringf("Saves/Chunk(%d,%d).writes", chunkCoords.x, chunkCoords.y);
+}
+
+void Chunk::AppendPendingWritesToFile(IntVec2 const& chunkCoords, std::vector<PendingBlockWrite> const& blockWrites)
+{
+	// Keeps every whole record already there; a file with a bad header is started over. Only the first
+	// write to a block can ever apply, so later ones for the same block are not stored
+	std::string filename = GetPendingWritesFilePath(chunkCoords);
+	std::vector<uint8_t> buffer;
+	if (DoesFileExist(filename))
+	{
+		FileReadToBuffer(buffer, filename);
+	}
+	if (HasPendingWritesFileHeader(buffer))
+	{
+		buffer.resize(buffer.size() - (buffer.size() - sizeof(PendingWritesFileHeader)) % PENDING_WRITE_RECORD_BYTES);
+	}
+	else
+	{
+		PendingWritesFileHeader header;
+		buffer = { static_cast<uint8_t>(header.m_g), static_cast<uint8_t>(header.m_c), static_cast<uint8_t>(header.m_p), static_cast<uint8_t>(header.m_w), header.m_version };
+	}
+
+	std::vector<uint8_t> isBlockWritten(CHUNK_BLOCK_TOTAL, 0);
+	for (size_t offset = sizeof(PendingWritesFileHeader); offset + PENDING_WRITE_RECORD_BYTES <= buffer.size(); offset += PENDING_WRITE_RECORD_BYTES)
+	{
+		int blockIndex = buffer[offset] | (buffer[offset + 1] << 8) | (buffer[offset + 2] << 16);
+		if (blockIndex < CHUNK_BLOCK_TOTAL)
+		{
+			isBlockWritten[blockIndex] = 1;
+		}
+	}
+
+	for (PendingBlockWrite const& blockWrite : blockWrites)
+	{
+		if (isBlockWritten[blockWrite.m_blockIndex] != 0)
+		{
+			continue;
+		}
+		isBlockWritten[blockWrite.m_blockIndex] = 1;
+		buffer.push_back(static_cast<uint8_t>(blockWrite.m_blockIndex & 0xFF));
+		buffer.push_back(static_cast<uint8_t>((blockWrite.m_blockIndex >> 8) & 0xFF));
+		buffer.push_back(static_cast<uint8_t>(blockWrite.m_blockIndex >> 16));
+		buffer.push_back(blockWrite.m_blockType);
+	}
+	WriteBufferToFile(buffer, filename);
+}
+
+bool Chunk::ReadPendingWritesFromFile(IntVec2 const& chunkCoords, std::vector<PendingBlockWrite>& outBlockWrites)
+{
+	std::vector<uint8_t> buffer;
+	FileReadToBuffer(buffer, GetPendingWritesFilePath(chunkCoords));
+	if (!HasPendingWritesFileHeader(buffer))
+	{
+		return false;
+	}
+
+	for (size_t offset = sizeof(PendingWritesFileHeader); offset + PENDING_WRITE_RECORD_BYTES <= buffer.size(); offset += PENDING_WRITE_RECORD_BYTES)
+	{
+		PendingBlockWrite blockWrite;
+		blockWrite.m_targetChunkCoords = chunkCoords;
+		blockWrite.m_blockIndex = buffer[offset] | (buffer[offset + 1] << 8) | (buffer[offset + 2] << 16);
+		blockWrite.m_blockType = buffer[offset + 3];
+		if (blockWrite.m_blockIndex >= CHUNK_BLOCK_TOTAL)
+		{
+			return false;
+		}
+		outBlockWrites.push_back(blockWrite);
+	}
+	return true;
 }
 
-void Chunk::AddVertsForBlockFace(Vec3 const& blockPos, int blockFace, Rgba8 const& blockTint, AABB2 const& blockUVs)
+uint64_t Chunk::ComputeContentHash() const
 {
-	Vec3 mins = blockPos;
-	Vec3 maxs = blockPos + Vec3::ONE;
-	Vec3 bl, br, tr, tl;
+	// FNV-1a over the block types, then over any decoration writes bound for neighboring chunks
+	uint64_t hash = 14695981039346656037ULL;
+	constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+	for (int blockIndex = 0; blockIndex < CHUNK_BLOCK_TOTAL; ++blockIndex)
+	{
+		hash = (hash ^ m_blocks[blockIndex].m_blockType) * FNV_PRIME;
+	}
+	for (PendingBlockWrite const& write : m_outgoingBlockWrites)
+	{
+		uint32_t writeFields[4] = { static_cast<uint32_t>(write.m_targetChunkCoords.x), static_cast<uint32_t>(write.m_targetChunkCoords.y),
+			                        static_cast<uint32_t>(write.m_blockIndex), write.m_blockType };
+		for (uint32_t field : writeFields)
+		{
+			for (int byteIndex = 0; byteIndex < 4; ++byteIndex)
+			{
+				hash = (hash ^ ((field >> (byteIndex * 8)) & 0xFF)) * FNV_PRIME;
+			}
+		}
+	}
+	return hash;
+}
+
+#if !defined(HEADLESS_WORLDGEN)
+void Chunk::AddVertsForMeshQuad(std::vector<ChunkVertex>& verts, ChunkMeshQuad const& quad)
+{
+	IntVec3 mins = quad.m_mins;
+	IntVec3 maxs = quad.m_mins + quad.m_size;
+	IntVec3 bl, br, tr, tl;
 
-	switch (blockFace)
+	// Same corner order as AddVertsForQuad3D, which the shared quad index buffer assumes; the shader derives the sprite UV from position and face
+	switch (quad.m_blockFace)
 	{
 		case BLOCK_FACE_EAST:
 		{
-			bl = Vec3(maxs.x, mins.y, mins.z);
-			br = Vec3(maxs.x, maxs.y, mins.z);
-			tr = Vec3(maxs.x, maxs.y, maxs.z);
-			tl = Vec3(maxs.x, mins.y, maxs.z);
+			bl = IntVec3(maxs.x, mins.y, mins.z);
+			br = IntVec3(maxs.x, maxs.y, mins.z);
+			tr = IntVec3(maxs.x, maxs.y, maxs.z);
+			tl = IntVec3(maxs.x, mins.y, maxs.z);
 			break;
 		}
 		case BLOCK_FACE_WEST:
 		{
-			bl = Vec3(mins.x, maxs.y, mins.z);
-			br = Vec3(mins.x, mins.y, mins.z);
-			tr = Vec3(mins.x, mins.y, maxs.z);
-			tl = Vec3(mins.x, maxs.y, maxs.z);
+			bl = IntVec3(mins.x, maxs.y, mins.z);
+			br = IntVec3(mins.x, mins.y, mins.z);
+			tr = IntVec3(mins.x, mins.y, maxs.z);
+			tl = IntVec3(mins.x, maxs.y, maxs.z);
 			break;
 		}
 		case BLOCK_FACE_NORTH:
 		{
-			bl = Vec3(maxs.x, maxs.y, mins.z);
-			br = Vec3(mins.x, maxs.y, mins.z);
-			tr = Vec3(mins.x, maxs.y, maxs.z);
-			tl = Vec3(maxs.x, maxs.y, maxs.z);
+			bl = IntVec3(maxs.x, maxs.y, mins.z);
+			br = IntVec3(mins.x, maxs.y, mins.z);
+			tr = IntVec3(mins.x, maxs.y, maxs.z);
+			tl = IntVec3(maxs.x, maxs.y, maxs.z);
 			break;
 		}
 		case BLOCK_FACE_SOUTH:
 		{
-			bl = Vec3(mins.x, mins.y, mins.z);
-			br = Vec3(maxs.x, mins.y, mins.z);
-			tr = Vec3(maxs.x, mins.y, maxs.z);
-			tl = Vec3(mins.x, mins.y, maxs.z);
+			bl = IntVec3(mins.x, mins.y, mins.z);
+			br = IntVec3(maxs.x, mins.y, mins.z);
+			tr = IntVec3(maxs.x, mins.y, maxs.z);
+			tl = IntVec3(mins.x, mins.y, maxs.z);
 			break;
 		}
 		case BLOCK_FACE_TOP:
 		{
-			bl = Vec3(mins.x, mins.y, maxs.z);
-			br = Vec3(maxs.x, mins.y, maxs.z);
-			tr = Vec3(maxs.x, maxs.y, maxs.z);
-			tl = Vec3(mins.x, maxs.y, maxs.z);
+			bl = IntVec3(mins.x, mins.y, maxs.z);
+			br = IntVec3(maxs.x, mins.y, maxs.z);
+			tr = IntVec3(maxs.x, maxs.y, maxs.z);
+			tl = IntVec3(mins.x, maxs.y, maxs.z);
 			break;
 		}
 		case BLOCK_FACE_BOTTOM:
 		{
-			bl = Vec3(mins.x, maxs.y, mins.z);
-			br = Vec3(maxs.x, maxs.y, mins.z);
-			tr = Vec3(maxs.x, mins.y, mins.z);
-			tl = Vec3(mins.x, mins.y, mins.z);
+			bl = IntVec3(mins.x, maxs.y, mins.z);
+			br = IntVec3(maxs.x, maxs.y, mins.z);
+			tr = IntVec3(maxs.x, mins.y, mins.z);
+			tl = IntVec3(mins.x, mins.y, mins.z);
 			break;
 		}
 	}
 
-	AddVertsForQuad3D(m_vertexes, m_indices, bl, br, tr, tl, blockTint, blockUVs);
+	ChunkVertex vertex;
+	vertex.m_blockFace = quad.m_blockFace;
+	vertex.m_spriteIndex = static_cast<uint8_t>(quad.m_spriteCell.y * CHUNK_SPRITE_GRID_SIZE + quad.m_spriteCell.x);
+	vertex.m_lightInfluence = quad.m_lightInfluence;
+	vertex.m_tint = quad.m_tint;
+	vertex.m_flags = static_cast<uint8_t>(quad.m_isLit ? 0 : CHUNK_VERTEX_UNLIT);
+
+	IntVec3 const corners[4] = { bl, br, tr, tl };
+	for (IntVec3 const& corner : corners)
+	{
+		vertex.m_localX = static_cast<uint8_t>(corner.x);
+		vertex.m_localY = static_cast<uint8_t>(corner.y);
+		vertex.m_localZ = static_cast<uint8_t>(corner.z);
+		verts.push_back(vertex);
+	}
 }
 
 void Chunk::SetBlockType(int x, int y, int z, uint8_t newBlockType)
@@ -1309,7 +943,7 @@ void Chunk::SetBlockType(int x, int y, int z, uint8_t newBlockType)
 	BlockIterator aboveBlockIterator = currentBlockIterator.GetUpNeighbor();
 
 	block->SetBlockType(newBlockType);
-	m_isMeshDirty = true;
+	g_theGame->m_currentWorld->MarkChunkMeshDirty(this);
 	m_needsSaving = true;
 
 	g_theGame->m_currentWorld->MarkLightingDirty(currentBlockIterator);
@@ -1335,3 +969,4 @@ void Chunk::SetBlockType(int x, int y, int z, uint8_t newBlockType)
 		g_theGame->m_currentWorld->ClearSkyDown(currentBlockIterator.GetDownNeighbor());
 	}
 }
+#endif
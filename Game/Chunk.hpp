@@ -5,15 +5,85 @@
 #include "Engine/Math/Vec3.h"
 #include "Engine/Math/AABB2.h"
 #include "Engine/Math/AABB3.hpp"
-#include "Engine/Core/Vertex_PCUTBN.hpp"
 #include <vector>
 #include <atomic>
 // -----------------------------------------------------------------------------
 class Block;
+struct BiomeLookup;
 class VertexBuffer;
 class IndexBuffer;
-class Texture;
-class SpriteSheet;
+class WorldRenderContext;
+// -----------------------------------------------------------------------------
+struct DensityErrorReport
+{
+	int    m_numSamples = 0;
+	int    m_numLatticeSamples = 0;
+	int    m_numMismatchedBlocks = 0;    // Blocks whose solid/air classification differs from the per-block path
+	float  m_maxAbsError = 0.f;
+	float  m_meanAbsError = 0.f;
+	float  m_maxNodeError = 0.f;        // Error at blocks on lattice nodes, where interpolation must return the sample itself
+	double m_perBlockSeconds = 0.0;
+	double m_latticeSeconds = 0.0;
+};
+// -----------------------------------------------------------------------------
+struct ColumnBoundsReport
+{
+	int    m_numBlocks = 0;
+	int    m_numBlocksEvaluated = 0;     // Blocks inside a column's uncertain band, the only ones that need density noise
+	int    m_numMismatchedBlocks = 0;    // Blocks whose solid/air classification differs from the full path
+	double m_fullSeconds = 0.0;
+	double m_boundedSeconds = 0.0;
+};
+// -----------------------------------------------------------------------------
+struct ClimateCacheReport
+{
+	int   m_numColumns = 0;
+	int   m_numBiomeMismatches = 0;     // Columns whose biome or surface blocks differ from per-block climate noise
+	int   m_numCavernMismatches = 0;    // Caverns the cache lists differently from AppendCavernsForChunk
+	float m_maxAbsError = 0.f;          // Largest difference of any climate field between the cache and per-block noise
+	float m_meanAbsError = 0.f;
+	float m_maxSampleError = 0.f;       // Largest difference on the cache's own sample points, where it must be exact
+};
+// -----------------------------------------------------------------------------
+struct CaveStageStats
+{
+	int m_numCandidateBlocks = 0;     // Blocks below the terrain top, the only ones caves may carve
+	int m_numBlocksEvaluated = 0;     // Blocks that actually had worm/cheese noise evaluated
+	int m_numBlocksCarved = 0;
+};
+// -----------------------------------------------------------------------------
+struct ChunkCaves
+{
+	bool m_hasTunnels = false;    // Worm and cheese caves only appear in some chunks
+	std::vector<CavernSphere> m_caverns;
+	CaveStageStats m_stats;
+};
+// -----------------------------------------------------------------------------
+struct OreStageStats
+{
+	int    m_numCandidateBlocks = 0;    // Stone fill blocks that may become ore
+	int    m_numCoarseSamples = 0;
+	int    m_numBlocksEvaluated = 0;    // Blocks whose exact ore noise was evaluated
+	int    m_numOreBlocksPlaced = 0;
+	double m_seconds = 0.0;
+};
+// -----------------------------------------------------------------------------
+struct GenerationStageTimes
+{
+	double m_noiseMapSeconds = 0.0;    // 2D climate, continent and tree maps
+	double m_densitySeconds = 0.0;     // Column shaping, density noise and block fill
+	double m_caveSeconds = 0.0;
+	double m_oreSeconds = 0.0;
+	double m_treeSeconds = 0.0;
+};
+// -----------------------------------------------------------------------------
+struct OreMeasurement
+{
+	OreStageStats m_perBlock;
+	OreStageStats m_coarseGrid;
+	int m_numMismatchedBlocks = 0;
+	int m_numFalseOreBlocks = 0;       // Coarse grid ore where the per-block reference keeps stone
+};
 // -----------------------------------------------------------------------------
 struct BiomeParams
 {
@@ -53,6 +123,27 @@ struct SurfaceBlocks
 	BlockType underwater;
 };
 // -----------------------------------------------------------------------------
+struct BiomeLookupReport
+{
+	int    m_numSamples = 0;
+	int    m_numMismatches = 0;      // Columns where the lookup table disagrees with the original branching code
+	double m_branchingSeconds = 0.0;
+	double m_lookupSeconds = 0.0;
+};
+// -----------------------------------------------------------------------------
+struct TreePlacement
+{
+	TreeStampType m_stampType = TREE_STAMP_NONE;
+	IntVec3 m_localCoords = IntVec3(0, 0, 0);   // Base of the trunk, one above the surface block
+};
+// -----------------------------------------------------------------------------
+struct PendingBlockWrite
+{
+	IntVec2 m_targetChunkCoords = IntVec2::ZERO;
+	int     m_blockIndex = 0;
+	uint8_t m_blockType = BLOCKTYPE_AIR;      // Only written if the target block is still air
+};
+// -----------------------------------------------------------------------------
 struct ChunkFileHeader
 {
 	char m_g = 'G';
@@ -65,29 +156,164 @@ struct ChunkFileHeader
 	uint8_t m_bitsZ = 7;
 };
 // -----------------------------------------------------------------------------
+// Decoration for a chunk that was not loaded when its neighbor generated it
+struct PendingWritesFileHeader
+{
+	char m_g = 'G';
+	char m_c = 'C';
+	char m_p = 'P';
+	char m_w = 'W';
+	uint8_t m_version = 1;
+};
+constexpr int PENDING_WRITE_RECORD_BYTES = 4;    // Block index in three bytes, low first, then block type
+static_assert(CHUNK_BLOCK_TOTAL <= (1 << 24), "A pending write record stores the block index in three bytes");
+// -----------------------------------------------------------------------------
 struct Run
 {
 	uint8_t m_blockType = 0;
 	uint8_t m_runLength = 0;
 };
 // -----------------------------------------------------------------------------
+// Mesh snapshot covers the chunk plus a one-block border on each side in X and Y
+constexpr int MESH_SNAPSHOT_SIZE_X = CHUNK_SIZE_X + 2;
+constexpr int MESH_SNAPSHOT_SIZE_Y = CHUNK_SIZE_Y + 2;
+constexpr int MESH_SNAPSHOT_NUM_BLOCKS = MESH_SNAPSHOT_SIZE_X * MESH_SNAPSHOT_SIZE_Y * CHUNK_SIZE_Z;
+// -----------------------------------------------------------------------------
+enum SnapshotFaceUV
+{
+	SNAPSHOT_FACE_UV_TOP,
+	SNAPSHOT_FACE_UV_BOTTOM,
+	SNAPSHOT_FACE_UV_SIDE,
+	NUM_SNAPSHOT_FACE_UVS
+};
+// -----------------------------------------------------------------------------
+// Everything a worker needs to mesh a chunk without touching the live world
+struct ChunkMeshSnapshot
+{
+	IntVec2  m_chunkCoords = IntVec2::ZERO;
+	uint64_t m_editGeneration = 0;        // Chunk's generation when captured; older results are discarded
+	bool     m_lightingEnabled = true;
+	MeshingMode m_meshingMode = MeshingMode::PER_FACE;
+	std::vector<uint8_t> m_blockTypes;
+	std::vector<uint8_t> m_lightInfluence;
+	std::vector<IntVec2> m_faceSpriteCells;    // NUM_SNAPSHOT_FACE_UVS per block type
+
+	static int GetIndex(int localX, int localY, int localZ)
+	{
+		return (localX + 1) + (localY + 1) * MESH_SNAPSHOT_SIZE_X + localZ * MESH_SNAPSHOT_SIZE_X * MESH_SNAPSHOT_SIZE_Y;
+	}
+	void CopyBlock(int localX, int localY, int localZ, Block const& block);
+};
+// -----------------------------------------------------------------------------
+// Axis-aligned quad over one or more block faces, before it is turned into vertexes
+struct ChunkMeshQuad
+{
+	IntVec3 m_mins = IntVec3(0, 0, 0);    // Local coords of the lowest block covered
+	IntVec3 m_size = IntVec3(1, 1, 1);    // Blocks covered along each axis, always 1 along the face normal
+	uint8_t m_blockFace = 0;
+	IntVec2 m_spriteCell = IntVec2::ZERO;
+	uint8_t m_lightInfluence = 0;    // Outdoor light in the high nibble, indoor in the low, from the block in front of the face
+	uint8_t m_tint = 255;            // Per-direction shading
+	bool    m_isLit = true;          // Unlit faces draw at their tint, for when lighting is toggled off
+};
+// -----------------------------------------------------------------------------
+enum ChunkVertexFlags : uint8_t
+{
+	CHUNK_VERTEX_UNLIT = 1 << 0,
+};
+// -----------------------------------------------------------------------------
+// Packed world vertex, decoded in WorldShader.hlsl. Positions are local to the chunk, whose origin
+// goes in the model constants, and the UV is rebuilt from the position and face
+struct ChunkVertex
+{
+	uint8_t m_localX = 0;
+	uint8_t m_localY = 0;
+	uint8_t m_localZ = 0;
+	uint8_t m_blockFace = 0;         // BlockFace
+	uint8_t m_spriteIndex = 0;       // spriteCell.y * CHUNK_SPRITE_GRID_SIZE + spriteCell.x
+	uint8_t m_lightInfluence = 0;
+	uint8_t m_tint = 255;
+	uint8_t m_flags = 0;             // ChunkVertexFlags
+};
+static_assert(sizeof(ChunkVertex) == 8, "WorldShader.hlsl reads a chunk vertex as one R32G32_UINT element");
+// -----------------------------------------------------------------------------
+// Per vertical section, the faces each face can see through non-opaque blocks (bit per BlockFace).
+// Defaults to fully open so chunks without a mesh yet never hide anything behind them
+struct ChunkVisibility
+{
+	uint8_t m_connectedFaces[CHUNK_NUM_VISIBILITY_SECTIONS][NUM_BLOCKFACES];
+
+	ChunkVisibility()
+	{
+		for (int section = 0; section < CHUNK_NUM_VISIBILITY_SECTIONS; ++section)
+		{
+			for (int blockFace = 0; blockFace < NUM_BLOCKFACES; ++blockFace)
+			{
+				m_connectedFaces[section][blockFace] = (1 << NUM_BLOCKFACES) - 1;
+			}
+		}
+	}
+	bool AreFacesConnected(int section, int fromFace, int toFace) const
+	{
+		return (m_connectedFaces[section][fromFace] & (1 << toFace)) != 0;
+	}
+};
+// -----------------------------------------------------------------------------
+struct ChunkMeshStats
+{
+	int m_numFaces = 0;    // Visible block faces, one quad each in the per-face mesh
+	int m_numQuads = 0;
+};
+// -----------------------------------------------------------------------------
+struct MeshingReport
+{
+	ChunkMeshStats m_perFace;
+	ChunkMeshStats m_greedy;
+	int    m_numMismatchedFaces = 0;    // Block faces covered by one mesh but not the other, or drawn differently
+	double m_perFaceSeconds = 0.0;
+	double m_greedySeconds = 0.0;
+};
+// -----------------------------------------------------------------------------
 class Chunk
 {
 public:
 
 	// Add constructor after creating World data structure
 	Chunk(IntVec2 const& chunkCoords);
+	Chunk(IntVec2 const& chunkCoords, Block* recycledBlocks);    // Takes ownership of blocks already cleared by the chunk pool
 	~Chunk();
 
 	void Update(float deltaseconds);
-	void Render() const;
+	bool Render(WorldRenderContext& context, IndexBuffer* quadIndexBuffer) const;
 
 	// Terrain Gen w/Density (NEW)
-	void PopulateWithDensityNoise();
+	void PopulateWithDensityNoise(WorldGenSettings const& settings);
+
+	// Density noise sampling
+	void  ComputeDensityNoiseColumn(int localX, int localY, float* outNoiseColumn, int minZ = 0, int maxZ = CHUNK_SIZE_Z - 1) const;
+	void  Compute3dNoiseColumn(int localX, int localY, int startZ, int numZ, float coordScale, unsigned int numOctaves, unsigned int seed, float* outNoiseColumn) const;
+	void  ComputeDensityLattice(WorldGenSettings const& settings, std::vector<float>& outLattice, int minZ = 0, int maxZ = CHUNK_SIZE_Z - 1) const;
+	void  SampleDensityLatticeColumn(WorldGenSettings const& settings, std::vector<float> const& lattice, int localX, int localY, float* outNoiseColumn,
+		                             int minZ = 0, int maxZ = CHUNK_SIZE_Z - 1) const;
+	void  GetContinentShaping(WorldGenSettings const& settings, float continentNoise, float& outHeightOffset, float& outSquashingFactor, float& outBaseHeight) const;
+	float ComputeShapedDensity(float noiseValue, int globalZ, float heightOffset, float squashingFactor, float baseHeight) const;
+	void  GetColumnDensityBounds(float heightOffset, float squashingFactor, float baseHeight, int& outMinUncertainZ, int& outMaxUncertainZ) const;
+	ColumnBoundsReport MeasureColumnBounds(WorldGenSettings const& settings) const;
+	DensityErrorReport MeasureDensityLatticeError(WorldGenSettings const& settings) const;
+
+	// Cave stage
+	void BuildChunkCaves(WorldGenSettings const& settings, ChunkCaves& outCaves) const;
+	void CarveCaveColumn(ChunkCaves& caves, int localX, int localY, int numZ, bool* outCaveColumn) const;
 
 	// Structure/cool stuff
-	void OreChance(int globalX, int globalY, int globalZ, Block* block);
-	void TryToPlaceTreeStamp(TreeStamp const& treeStamp, int localX, int localY, int localZ);
+	void OreChance(int globalX, int globalY, int globalZ, Block* block) const;
+	OreStageStats PlaceOres(WorldGenSettings const& settings, std::vector<uint8_t> const& oreCandidates, Block* blocks) const;
+	OreMeasurement MeasureOrePlacement(WorldGenSettings const& settings) const;
+
+	// Decoration stage
+	void DecorateChunk(std::vector<TreePlacement> const& treePlacements);
+	void TryToPlaceTreeStamp(TreeStampType stampType, int localX, int localY, int localZ);
+	int  ApplyBlockWrites(std::vector<PendingBlockWrite> const& blockWrites);
 
 	// Biomes
 	int  GetTemperatureBand(float v);
@@ -95,6 +321,9 @@ public:
 	int  GetContinentalnessBand(float v);
 	BiomeType GetBiomeType(BiomeParams const& biome);
 	SurfaceBlocks GetSurfaceBlocks(BiomeType biome);
+	BiomeLookup const& GetBiomeLookup(BiomeParams const& biome);
+	BiomeLookupReport MeasureBiomeLookup(int numSamples, unsigned int seed);
+	ClimateCacheReport MeasureClimateCache(ClimateCache& climateCache);
 
 	// Terrain Generation A02 (OLD)
 	void PopulateChunksWithNoise();
@@ -103,7 +332,18 @@ public:
 	void PopulateTerrainBlocks(std::vector<int> heightMapXY, std::vector<int> dirtDepthXY, std::vector<float> humidityMapXY, std::vector<float> tempMapXY, unsigned int terrainSeed);
 	void PopulateTrees(std::vector<int> heightMapXY, std::vector<float> humidityMapXY, std::vector<float> tempMapXY);
 	
+	// Meshing: capture on the main thread, build anywhere, upload on the main thread
 	void GenerateChunkMesh();
+	void CaptureMeshSnapshot(ChunkMeshSnapshot& outSnapshot) const;
+	static ChunkMeshStats BuildMeshFromSnapshot(ChunkMeshSnapshot const& snapshot, std::vector<ChunkVertex>& outVertexes);
+	static void BuildPerFaceQuads(ChunkMeshSnapshot const& snapshot, std::vector<ChunkMeshQuad>& outQuads);
+	static void BuildGreedyQuads(ChunkMeshSnapshot const& snapshot, std::vector<ChunkMeshQuad>& outQuads);
+	static uint32_t GetFaceAppearanceKey(ChunkMeshSnapshot const& snapshot, int localX, int localY, int localZ, int blockFace);
+	static void SetQuadAppearance(ChunkMeshSnapshot const& snapshot, uint32_t appearanceKey, ChunkMeshQuad& quad);
+	static ChunkVisibility BuildVisibilityFromSnapshot(ChunkMeshSnapshot const& snapshot);
+	static MeshingReport CompareGreedyMeshing(ChunkMeshSnapshot const& snapshot);
+	MeshingReport MeasureGreedyMeshing() const;
+	void SetMesh(std::vector<ChunkVertex>& vertexes);
 
 	void CreateBuffers();
 	void DeleteBuffers();
@@ -129,12 +369,43 @@ public:
 	AABB3	GetWorldBounds() const;
 	int		GetVertexCount() const;
 	int		GetIndexCount()  const;
-	void	AddVertsForBlockFace(Vec3 const& blockPos, int blockFace, Rgba8 const& blockTint, AABB2 const& blockUVs);
+	int		GetQuadCount()   const;
+	int		GetMeshByteCount() const;
+	uint64_t ComputeContentHash() const;
+
+	// Save files: GCHK header followed by (block type, run length) pairs
+	static std::string GetSaveFilePath(IntVec2 const& chunkCoords);
+	void	WriteBlocksToBuffer(std::vector<uint8_t>& outBuffer) const;
+	bool	ReadBlocksFromBuffer(std::vector<uint8_t> const& buffer);
+
+	// Pending write files: GCPW header followed by records, appended to by whoever could not deliver them
+	static std::string GetPendingWritesFilePath(IntVec2 const& chunkCoords);
+	static void AppendPendingWritesToFile(IntVec2 const& chunkCoords, std::vector<PendingBlockWrite> const& blockWrites);
+	static bool ReadPendingWritesFromFile(IntVec2 const& chunkCoords, std::vector<PendingBlockWrite>& outBlockWrites);
+	static void AddVertsForMeshQuad(std::vector<ChunkVertex>& verts, ChunkMeshQuad const& quad);
 	void	SetBlockType(int x, int y, int z, uint8_t newBlockType);
 
 public:
 	bool m_isMeshDirty = false;
 	bool m_needsSaving = false;
+
+	// [main thread] Mesh build queue bookkeeping, owned by the world
+	int    m_meshDirtyIndex = -1;           // Slot in the world's dirty mesh list, -1 when clean
+	bool   m_isInMeshBuildHeap = false;
+	double m_meshDirtyTime = 0.0;
+	uint64_t m_meshEditGeneration = 0;      // Bumped on every dirty mark
+	bool   m_isMeshJobInFlight = false;
+	int    m_numQueuedLightBlocks = 0;      // Entries in the world's dirty light queue that point into this chunk
+	ChunkMeshStats m_meshStats;
+	ChunkVisibility m_visibility;
+
+	// [main thread] Frame stamps from the world's visibility search, compared against its current frame
+	uint32_t m_sectionVisitedFrame[CHUNK_NUM_VISIBILITY_SECTIONS] = {};
+	uint32_t m_visibleFrame = 0;
+
+	CaveStageStats m_caveStats;
+	OreStageStats m_oreStats;
+	GenerationStageTimes m_stageTimes;
 	IntVec2 m_chunkCoords = IntVec2::ZERO;
 
 	// Neighbor pointers
@@ -146,19 +417,16 @@ public:
 	// Single 1D array of blocks
 	Block* m_blocks = nullptr;
 
+	// [generator thread] Decoration blocks that land in other chunks, handed to the world when this chunk activates
+	std::vector<PendingBlockWrite> m_outgoingBlockWrites;
+
 	// Atomic chunk state type
 	std::atomic<ChunkState> m_chunkState = ChunkState::CONSTRUCTING;
 private:
 	// Each chunk has its own chunk coordinates and bounds
 	AABB3   m_chunkWorldBounds = AABB3(Vec3::ZERO, Vec3::ZERO);
 
-	// Each chunk owns a vertexbuffer and vertex array
+	// Each chunk owns a vertexbuffer and vertex array; every chunk draws with the world's shared quad index buffer
 	VertexBuffer* m_vertexBuffer = nullptr;
-	IndexBuffer* m_indexBuffer = nullptr;
-	std::vector<Vertex_PCUTBN> m_vertexes;
-	std::vector<unsigned int> m_indices;
-
-	// All chunk blocks are textured with the same single spritesheet
-	Texture* m_spriteImage = nullptr;
-	SpriteSheet* m_spriteSheet = nullptr;
+	std::vector<ChunkVertex> m_vertexes;
 };
\ No newline at end of file
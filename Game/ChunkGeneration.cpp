@@ -0,0 +1,1726 @@
+#include "Game/Chunk.hpp"
+#include "Game/Block.hpp"
+#include "Game/BatchNoise.hpp"
+#include "Game/ClimateCache.hpp"
+#include "Game/WorldGenTables.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/SmoothNoise.hpp"
+#include "Engine/Math/RawNoise.hpp"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Math/Splines.hpp"
+// -----------------------------------------------------------------------------
+// Chunk terrain generation. Kept apart from Chunk.cpp so that it only depends
+// on the Engine's math and core code, which lets the headless tools link it
+// without the renderer, window or input systems.
+// -----------------------------------------------------------------------------
+// Ore fields in placement priority order; the first field above its threshold wins
+static OreField const ORE_FIELDS[NUM_ORE_FIELDS] =
+{
+	{ BLOCKTYPE_DIAMOND, 0.09f,  3, GAME_SEED + 20100, 0.75f, 20 },
+	{ BLOCKTYPE_GOLD,    0.09f,  3, GAME_SEED + 20200, 0.65f, 40 },
+	{ BLOCKTYPE_IRON,    0.08f,  4, GAME_SEED + 20300, 0.5f,  CHUNK_SIZE_Z },
+	{ BLOCKTYPE_COAL,    0.075f, 3, GAME_SEED + 20400, 0.45f, CHUNK_SIZE_Z },
+};
+// -----------------------------------------------------------------------------
+// Reference copies of the original branching biome code, kept only so MeasureBiomeLookup compares the
+// baked table against what chunks generated before it, not against the constexpr code that fills it
+// -----------------------------------------------------------------------------
+static BiomeType GetBiomeTypeReference(int temp, int humidity, int continent)
+{
+	// Oceanic regions
+	if (continent <= 2) 
+	{
+		if (temp == 0) return BIOME_FROZEN_OCEAN;
+		if (continent <= 1) return BIOME_DEEP_OCEAN;
+		return BIOME_OCEAN;
+	}
+
+	// Coasts / beaches
+	if (continent == 3) 
+	{
+		if (temp == 0) return BIOME_SNOWY_BEACH;
+		if (temp < 4) return BIOME_BEACH;
+		return BIOME_DESERT;
+	}
+
+	// Inland regions
+	// Temperature + Humidity table
+	if (temp == 0) 
+	{
+		if (humidity <= 1)
+		{
+			return BIOME_SNOWY_PLAINS;
+		}
+		if (humidity == 3)
+		{
+			return BIOME_SNOWY_TAIGA;
+		}
+		else
+		{
+			return BIOME_TAIGA;
+		}
+	}
+	else if (temp == 1) 
+	{
+		if (humidity <= 1)
+		{
+			return BIOME_PLAINS;
+		}
+		if (humidity >= 3)
+		{
+			return BIOME_FOREST;
+		}
+		else
+		{
+			return BIOME_TAIGA;
+		}
+	}
+	else if (temp == 2) 
+	{
+		if (humidity <= 1)
+		{
+			return BIOME_PLAINS;
+		}
+		if (humidity >= 3)
+		{
+			return BIOME_FOREST;
+		}
+		else
+		{
+			return BIOME_FOREST;
+		}
+	}
+	else if (temp == 3) 
+	{
+		if (humidity <= 1)
+		{
+			return BIOME_SAVANNA;
+		}
+		if (humidity >= 3)
+		{
+			return BIOME_JUNGLE;
+		}
+		else
+		{
+			return BIOME_FOREST;
+		}
+	}
+	else 
+	{
+		if (humidity <= 2)
+		{
+			return BIOME_DESERT;
+		}
+		else
+		{
+			return BIOME_BADLANDS;
+		}
+	}
+}
+
+static SurfaceBlocks GetSurfaceBlocksReference(BiomeType biome)
+{
+	switch (biome)
+	{
+	// Oceans & Beaches
+		case BIOME_OCEAN:
+		case BIOME_DEEP_OCEAN:
+			return { BLOCKTYPE_SAND, BLOCKTYPE_ICE, BLOCKTYPE_SAND };
+		case BIOME_FROZEN_OCEAN:
+			return { BLOCKTYPE_SNOW, BLOCKTYPE_ICE, BLOCKTYPE_SAND };
+		case BIOME_BEACH:
+			return { BLOCKTYPE_SAND, BLOCKTYPE_SAND, BLOCKTYPE_SAND };
+		case BIOME_SNOWY_BEACH:
+			return { BLOCKTYPE_SNOW, BLOCKTYPE_SNOW, BLOCKTYPE_SAND };
+
+	// Hot desert areas
+		case BIOME_DESERT:
+			return { BLOCKTYPE_SAND, BLOCKTYPE_SAND, BLOCKTYPE_SAND };
+		case BIOME_BADLANDS:
+			return { BLOCKTYPE_GRASSLIGHT, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
+
+	// Forests
+		case BIOME_PLAINS:
+			return { BLOCKTYPE_GRASS, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
+		case BIOME_FOREST:
+			return { BLOCKTYPE_GRASS, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
+		case BIOME_TAIGA:
+			return { BLOCKTYPE_GRASSLIGHT, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
+		case BIOME_SNOWY_TAIGA:
+			return { BLOCKTYPE_SNOW, BLOCKTYPE_ICE, BLOCKTYPE_STONE };
+		case BIOME_SNOWY_PLAINS:
+			return { BLOCKTYPE_SNOW, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
+
+	// Jungle / Savanna
+		case BIOME_JUNGLE:
+			return { BLOCKTYPE_GRASSDARK, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
+		case BIOME_SAVANNA:
+			return { BLOCKTYPE_GRASSYELLOW, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
+
+		default:
+			return { BLOCKTYPE_STONE, BLOCKTYPE_STONE, BLOCKTYPE_STONE };
+	}
+}
+
+// The original tree branches, with the stamp names replaced by their stamp types
+static TreeStampType GetTreeStampReference(BiomeType biome, uint8_t surfaceType, float treeVariantNoise)
+{
+	TreeStampType stamp = TREE_STAMP_NONE;
+	if (biome == BIOME_FOREST)
+	{
+		if (surfaceType == BLOCKTYPE_GRASS || surfaceType == BLOCKTYPE_DIRT)
+		{
+
+			if (treeVariantNoise < 0.33f)
+			{
+				stamp = TREE_STAMP_OAK_SMALL;
+			}
+			else if (treeVariantNoise < 0.66f)
+			{
+				stamp = TREE_STAMP_OAK_LARGE;
+			}
+			else
+			{
+				stamp = TREE_STAMP_BIRCH;
+			}
+		}
+	}
+	else if (biome == BIOME_TAIGA)
+	{
+		if (surfaceType == BLOCKTYPE_GRASSLIGHT)
+		{
+			stamp = TREE_STAMP_SPRUCE;
+		}
+	}
+	else if (biome == BIOME_SNOWY_TAIGA)
+	{
+		if (surfaceType == BLOCKTYPE_SNOW)
+		{
+			stamp = TREE_STAMP_SNOWY_SPRUCE;
+		}
+	}
+	else if (biome == BIOME_DESERT)
+	{
+		if (surfaceType == BLOCKTYPE_SAND)
+		{
+			stamp = TREE_STAMP_CACTUS;
+		}
+	}
+	else if (biome == BIOME_SAVANNA)
+	{
+		if (surfaceType == BLOCKTYPE_GRASSYELLOW)
+		{
+			stamp = TREE_STAMP_ACACIA;
+		}
+	}
+	else if (biome == BIOME_JUNGLE)
+	{
+		if (surfaceType == BLOCKTYPE_GRASSDARK)
+		{
+			stamp = TREE_STAMP_JUNGLE;
+		}
+	}
+	return stamp;
+}
+// -----------------------------------------------------------------------------
+void Chunk::PopulateWithDensityNoise(WorldGenSettings const& settings)
+{
+	const int numXY = CHUNK_SIZE_X * CHUNK_SIZE_Y;
+	double noiseMapStartTime = GetCurrentTimeSeconds();
+
+	// Noise maps for this chunk
+	std::vector<float> continentNoiseMap(numXY);
+	std::vector<float> continentalnessNoiseMap(numXY);
+	std::vector<float> erosionMap(numXY);
+	std::vector<float> peaksValleysMap(numXY);
+	std::vector<float> temperatureMap(numXY);
+	std::vector<float> humidityMap(numXY);
+	std::vector<float> treeNoiseMap(numXY);
+	std::vector<float> treeVariantNoiseMap(numXY);
+
+	// Biome climate maps come from the shared region cache when available
+	bool useClimateCache = (settings.m_climateCache != nullptr);
+	if (useClimateCache)
+	{
+		settings.m_climateCache->SampleChunkClimate(m_chunkCoords, continentalnessNoiseMap.data(), erosionMap.data(), peaksValleysMap.data(),
+			                                        temperatureMap.data(), humidityMap.data());
+	}
+
+	// Precomputation caching, one batched noise call per map row
+	float rowPosX[CHUNK_SIZE_X];
+	float rowPosY[CHUNK_SIZE_X];
+	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+	{
+		int rowStart = chunkY * CHUNK_SIZE_X;
+		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+		{
+			rowPosX[chunkX] = static_cast<float>(m_chunkCoords.x * CHUNK_SIZE_X + chunkX);
+			rowPosY[chunkX] = static_cast<float>(m_chunkCoords.y * CHUNK_SIZE_Y + chunkY);
+		}
+
+		Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &continentNoiseMap[rowStart], CHUNK_SIZE_X, CONTINENT_SCALE, CONTINENT_OCTAVES,
+			DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 100);
+		if (!useClimateCache)
+		{
+			Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &continentalnessNoiseMap[rowStart], CHUNK_SIZE_X, CONTINENTALNESS_SCALE, BIOME_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 100);
+			Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &erosionMap[rowStart], CHUNK_SIZE_X, EROSIION_SCALE, BIOME_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 200);
+			Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &peaksValleysMap[rowStart], CHUNK_SIZE_X, PEAKVALLEY_SCALE, BIOME_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 300);
+			Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &temperatureMap[rowStart], CHUNK_SIZE_X, TEMPERATURE_SCALE, BIOME_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 400);
+			Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &humidityMap[rowStart], CHUNK_SIZE_X, HUMIDITY_SCALE, BIOME_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 500);
+		}
+
+		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+		{
+			int chunkIndex = rowStart + chunkX;
+			int globalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
+			int globalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
+
+			treeNoiseMap[chunkIndex] = Get2dNoiseZeroToOne(globalX, globalY, GAME_SEED + 42);
+			treeVariantNoiseMap[chunkIndex] = Get2dNoiseZeroToOne(globalX, globalY, GAME_SEED + 1337);
+		}
+	}
+
+	double densityStartTime = GetCurrentTimeSeconds();
+	m_stageTimes.m_noiseMapSeconds = densityStartTime - noiseMapStartTime;
+
+	// Continent shaping per column, and the Z band where density noise can still decide solid vs air
+	std::vector<float> heightOffsetMap(numXY);
+	std::vector<float> squashingFactorMap(numXY);
+	std::vector<float> baseHeightMap(numXY);
+	std::vector<int> minUncertainZMap(numXY);
+	std::vector<int> maxUncertainZMap(numXY);
+	int chunkMinUncertainZ = CHUNK_SIZE_Z;
+	int chunkMaxUncertainZ = -1;
+	for (int chunkIndex = 0; chunkIndex < numXY; ++chunkIndex)
+	{
+		GetContinentShaping(settings, continentNoiseMap[chunkIndex], heightOffsetMap[chunkIndex], squashingFactorMap[chunkIndex], baseHeightMap[chunkIndex]);
+		if (settings.m_useColumnBounds)
+		{
+			GetColumnDensityBounds(heightOffsetMap[chunkIndex], squashingFactorMap[chunkIndex], baseHeightMap[chunkIndex],
+				minUncertainZMap[chunkIndex], maxUncertainZMap[chunkIndex]);
+		}
+		else
+		{
+			minUncertainZMap[chunkIndex] = 0;
+			maxUncertainZMap[chunkIndex] = CHUNK_SIZE_Z - 1;
+		}
+		chunkMinUncertainZ = GetMin(chunkMinUncertainZ, minUncertainZMap[chunkIndex]);
+		chunkMaxUncertainZ = GetMax(chunkMaxUncertainZ, maxUncertainZMap[chunkIndex]);
+	}
+
+	// Density noise is either sampled on a coarse lattice once per chunk, or per block for each column
+	bool useDensityLattice = (settings.m_densityMode == DensitySampleMode::LATTICE);
+	std::vector<float> densityLattice;
+	if (useDensityLattice && chunkMinUncertainZ <= chunkMaxUncertainZ)
+	{
+		ComputeDensityLattice(settings, densityLattice, chunkMinUncertainZ, chunkMaxUncertainZ);
+	}
+	float densityNoiseColumn[CHUNK_SIZE_Z];
+	float densityColumn[CHUNK_SIZE_Z];
+	bool caveColumn[CHUNK_SIZE_Z];
+	std::vector<uint8_t> oreCandidates(CHUNK_BLOCK_TOTAL, 0);
+	std::vector<TreePlacement> treePlacements;
+
+	// Cave stage setup: whether this chunk has tunnels, and the caverns that fall inside it
+	double caveSetupStartTime = GetCurrentTimeSeconds();
+	ChunkCaves caves;
+	BuildChunkCaves(settings, caves);
+	double columnsStartTime = GetCurrentTimeSeconds();
+	double caveSeconds = columnsStartTime - caveSetupStartTime;
+	double columnCaveSeconds = 0.0;
+
+	// Using cached maps during block population
+	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+	{
+		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+		{
+			int chunkIndex = chunkY * CHUNK_SIZE_X + chunkX;
+
+			// Grabbing noise maps
+			float continentalness = continentalnessNoiseMap[chunkIndex];
+			float erosion = erosionMap[chunkIndex];
+			float peaksValleys = peaksValleysMap[chunkIndex];
+			float temperature = temperatureMap[chunkIndex];
+			float humidity = humidityMap[chunkIndex];
+
+			// Computing biomes once per column
+			BiomeParams biomeParams = { continentalness, erosion, peaksValleys, temperature, humidity };
+			BiomeLookup const& biomeLookup = GetBiomeLookup(biomeParams);
+			SurfaceBlocks const& surface = biomeLookup.m_surface;
+
+			// Continent shaping
+			float heightOffset = heightOffsetMap[chunkIndex];
+			float squashingFactor = squashingFactorMap[chunkIndex];
+			float baseHeight = baseHeightMap[chunkIndex];
+
+			// Density noise only inside the column's uncertain band
+			int minUncertainZ = minUncertainZMap[chunkIndex];
+			int maxUncertainZ = maxUncertainZMap[chunkIndex];
+			if (minUncertainZ <= maxUncertainZ)
+			{
+				if (useDensityLattice)
+				{
+					SampleDensityLatticeColumn(settings, densityLattice, chunkX, chunkY, densityNoiseColumn, minUncertainZ, maxUncertainZ);
+				}
+				else
+				{
+					ComputeDensityNoiseColumn(chunkX, chunkY, densityNoiseColumn, minUncertainZ, maxUncertainZ);
+				}
+			}
+
+			// Shaped density for the column; caves only ever carve below the topmost solid block.
+			// Outside the band the shaping alone already has the sign any noise value would give.
+			int terrainTopZ = -1;
+			for (int chunkZ = CHUNK_SIZE_Z - 1; chunkZ >= 0; --chunkZ)
+			{
+				bool isUncertain = (chunkZ >= minUncertainZ && chunkZ <= maxUncertainZ);
+				float noiseValue = isUncertain ? densityNoiseColumn[chunkZ] : 0.f;
+				densityColumn[chunkZ] = ComputeShapedDensity(noiseValue, chunkZ, heightOffset, squashingFactor, baseHeight);
+				if (terrainTopZ == -1 && densityColumn[chunkZ] < 0.f)
+				{
+					terrainTopZ = chunkZ;
+				}
+			}
+
+			// Cave air for every block below the terrain top
+			double carveStartTime = GetCurrentTimeSeconds();
+			int numBelowTop = GetMax(terrainTopZ, 0);
+			CarveCaveColumn(caves, chunkX, chunkY, numBelowTop, caveColumn);
+			columnCaveSeconds += GetCurrentTimeSeconds() - carveStartTime;
+
+			int surfaceDepthCounter = 0;
+			int surfaceZ = -1;
+
+			for (int chunkZ = CHUNK_SIZE_Z - 1; chunkZ >= 0; --chunkZ)
+			{
+				int blockIndex = GetBlockIndex(chunkX, chunkY, chunkZ);
+				Block* block = &m_blocks[blockIndex];
+				int globalZ = chunkZ;
+
+				// Terrain density bias and continental shaping
+				// -----------------------------------------------------------------------------
+				float densityValue = densityColumn[chunkZ];
+				// -----------------------------------------------------------------------------
+
+				// Caves
+				// -----------------------------------------------------------------------------
+				bool isCave = false;
+				bool belowSurface = (surfaceZ != -1 && chunkZ < surfaceZ);
+
+				if (belowSurface && caveColumn[chunkZ])
+				{
+					densityValue = 1.0f;
+					isCave = true;
+				}
+
+				// -----------------------------------------------------------------------------
+
+				// Block type assignemnt
+				// -----------------------------------------------------------------------------
+				if (densityValue < 0.f)
+				{
+					if (surfaceDepthCounter < SURFACE_LAYER_DEPTH)
+					{
+						if (globalZ >= SEA_LEVEL)
+						{
+							if (surfaceDepthCounter == 0)
+							{
+								block->SetBlockType(surface.top);
+							}
+							else
+							{
+								block->SetBlockType(surface.sub);
+							}
+						}
+						else
+						{
+							block->SetBlockType(surface.underwater);
+						}
+						surfaceDepthCounter += 1;
+					}
+					else
+					{
+						if (globalZ == OBSIDIAN_Z)
+						{
+							block->SetBlockType(BLOCKTYPE_OBSIDIAN);
+						}
+						else if (globalZ == LAVA_Z)
+						{
+							block->SetBlockType(BLOCKTYPE_LAVA);
+						}
+						else
+						{
+							// Stone fill, ores are placed by a separate pass once the chunk is filled
+							block->SetBlockType(BLOCKTYPE_STONE);
+							oreCandidates[blockIndex] = 1;
+						}
+					}
+					if (surfaceZ == -1)
+					{
+						surfaceZ = chunkZ;
+					}
+				}
+				else
+				{
+					surfaceDepthCounter = 0;
+					if (globalZ < SEA_LEVEL)
+					{
+						if (!isCave)
+						{
+							block->SetBlockType(BLOCKTYPE_WATER);
+						}
+						else if (block->m_blockType != BLOCKTYPE_WATER)
+						{
+							block->SetBlockType(BLOCKTYPE_AIR);
+						}
+					}
+					else
+					{
+						block->SetBlockType(BLOCKTYPE_AIR);
+					}
+				}
+				// -----------------------------------------------------------------------------
+
+				// Trees
+				// -----------------------------------------------------------------------------
+				if (surfaceZ >= 0 && surfaceZ == chunkZ)
+				{
+					float treeNoise = treeNoiseMap[chunkIndex];
+					if (treeNoise > 0.975f)
+					{
+						Block* surfaceBlock = &m_blocks[GetBlockIndex(chunkX, chunkY, surfaceZ)];
+						uint8_t surfaceType = surfaceBlock->m_blockType;
+
+						if (surfaceBlock->m_blockType != BLOCKTYPE_WATER)
+						{
+							// Candidate stamps come straight from the biome lookup
+							int treeVariant = GetTreeVariant(treeVariantNoiseMap[chunkIndex]);
+							TreeStampType stampType = TREE_STAMP_NONE;
+							if (surfaceType == biomeLookup.m_treeSurfaceTypes[0] || surfaceType == biomeLookup.m_treeSurfaceTypes[1])
+							{
+								stampType = biomeLookup.m_treeStamps[treeVariant];
+							}
+
+							if (stampType != TREE_STAMP_NONE)
+							{
+								int aboveSurfaceIndex = GetBlockIndex(chunkX, chunkY, surfaceZ + 1);
+								Block* aboveSurfaceBlock = &m_blocks[aboveSurfaceIndex];
+
+								if (aboveSurfaceBlock->m_blockType == BLOCKTYPE_WATER)
+								{
+									continue;
+								}
+
+								// Stamped by the decoration stage once every column has its terrain
+								TreePlacement placement;
+								placement.m_stampType = stampType;
+								placement.m_localCoords = IntVec3(chunkX, chunkY, surfaceZ + 1);
+								treePlacements.push_back(placement);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// Column carving is timed inside the column loop, everything else there counts as density
+	double oreStartTime = GetCurrentTimeSeconds();
+	m_stageTimes.m_densitySeconds = (caveSetupStartTime - densityStartTime) + (oreStartTime - columnsStartTime - columnCaveSeconds);
+	m_stageTimes.m_caveSeconds = caveSeconds + columnCaveSeconds;
+
+	m_caveStats = caves.m_stats;
+	m_oreStats = PlaceOres(settings, oreCandidates, m_blocks);
+
+	double treeStartTime = GetCurrentTimeSeconds();
+	m_stageTimes.m_oreSeconds = treeStartTime - oreStartTime;
+	DecorateChunk(treePlacements);
+	m_stageTimes.m_treeSeconds = GetCurrentTimeSeconds() - treeStartTime;
+}
+
+void Chunk::ComputeDensityNoiseColumn(int localX, int localY, float* outNoiseColumn, int minZ, int maxZ) const
+{
+	float columnPosX[CHUNK_SIZE_Z];
+	float columnPosY[CHUNK_SIZE_Z];
+	float columnPosZ[CHUNK_SIZE_Z];
+	for (int chunkZ = minZ; chunkZ <= maxZ; ++chunkZ)
+	{
+		columnPosX[chunkZ] = static_cast<float>(m_chunkCoords.x * CHUNK_SIZE_X + localX);
+		columnPosY[chunkZ] = static_cast<float>(m_chunkCoords.y * CHUNK_SIZE_Y + localY);
+		columnPosZ[chunkZ] = static_cast<float>(chunkZ);
+	}
+
+	Compute3dPerlinNoiseBatch(&columnPosX[minZ], &columnPosY[minZ], &columnPosZ[minZ], &outNoiseColumn[minZ], maxZ - minZ + 1,
+		                      DENSITY_NOISE_SCALE, DENSITY_OCTAVES, DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED);
+}
+
+void Chunk::Compute3dNoiseColumn(int localX, int localY, int startZ, int numZ, float coordScale, unsigned int numOctaves, unsigned int seed, float* outNoiseColumn) const
+{
+	float columnPosX[CHUNK_SIZE_Z];
+	float columnPosY[CHUNK_SIZE_Z];
+	float columnPosZ[CHUNK_SIZE_Z];
+	for (int columnIndex = 0; columnIndex < numZ; ++columnIndex)
+	{
+		columnPosX[columnIndex] = static_cast<float>(m_chunkCoords.x * CHUNK_SIZE_X + localX) * coordScale;
+		columnPosY[columnIndex] = static_cast<float>(m_chunkCoords.y * CHUNK_SIZE_Y + localY) * coordScale;
+		columnPosZ[columnIndex] = static_cast<float>(startZ + columnIndex) * coordScale;
+	}
+
+	Compute3dPerlinNoiseBatch(columnPosX, columnPosY, columnPosZ, outNoiseColumn, numZ, 1.0f, numOctaves, 0.5f, 2.0f, true, seed);
+}
+
+void Chunk::BuildChunkCaves(WorldGenSettings const& settings, ChunkCaves& outCaves) const
+{
+	outCaves.m_stats = CaveStageStats();
+	outCaves.m_caverns.clear();
+
+	// Caverns are sparse and fully contained in a single chunk, so only this chunk's list is needed
+	if (settings.m_climateCache != nullptr)
+	{
+		settings.m_climateCache->GetChunkCaverns(m_chunkCoords, outCaves.m_caverns);
+	}
+	else
+	{
+		AppendCavernsForChunk(m_chunkCoords, outCaves.m_caverns);
+	}
+
+	// Worm and cheese caves only exist in a fraction of chunks
+	outCaves.m_hasTunnels = (Get2dNoiseZeroToOne(m_chunkCoords.x, m_chunkCoords.y, GAME_SEED + 9999) > CAVE_CHUNK_THRESHOLD);
+}
+
+void Chunk::CarveCaveColumn(ChunkCaves& caves, int localX, int localY, int numZ, bool* outCaveColumn) const
+{
+	for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+	{
+		outCaveColumn[chunkZ] = false;
+	}
+
+	// Worm tunnels and cheese caves, batched over the blocks below the terrain top
+	if (caves.m_hasTunnels && numZ > 0)
+	{
+		float wormNoiseColumn[CHUNK_SIZE_Z];
+		float cheeseNoiseColumn[CHUNK_SIZE_Z];
+		Compute3dNoiseColumn(localX, localY, 0, numZ, WORM_CAVE_COORD_SCALE, WORM_CAVE_OCTAVES, GAME_SEED + 777, wormNoiseColumn);
+		Compute3dNoiseColumn(localX, localY, 0, numZ, CHEESE_CAVE_COORD_SCALE, CHEESE_CAVE_OCTAVES, GAME_SEED + 900, cheeseNoiseColumn);
+		for (int chunkZ = 0; chunkZ < numZ; ++chunkZ)
+		{
+			outCaveColumn[chunkZ] = (fabsf(wormNoiseColumn[chunkZ]) < WORM_CAVE_THRESHOLD) || (cheeseNoiseColumn[chunkZ] > CHEESE_CAVE_THRESHOLD);
+		}
+		caves.m_stats.m_numBlocksEvaluated += numZ;
+	}
+
+	// Spherical caverns, carved directly from the sparse cavern list
+	float blockX = static_cast<float>(m_chunkCoords.x * CHUNK_SIZE_X + localX);
+	float blockY = static_cast<float>(m_chunkCoords.y * CHUNK_SIZE_Y + localY);
+	for (CavernSphere const& cavern : caves.m_caverns)
+	{
+		float distXYSquared = GetDistanceSquared2D(Vec2(blockX, blockY), Vec2(cavern.m_center.x, cavern.m_center.y));
+		float radiusSquared = cavern.m_radius * cavern.m_radius;
+		if (distXYSquared >= radiusSquared)
+		{
+			continue;
+		}
+
+		float halfHeight = sqrtf(radiusSquared - distXYSquared);
+		int minZ = GetMax(static_cast<int>(ceilf(cavern.m_center.z - halfHeight)), 0);
+		int maxZ = GetMin(static_cast<int>(floorf(cavern.m_center.z + halfHeight)), numZ - 1);
+		for (int chunkZ = minZ; chunkZ <= maxZ; ++chunkZ)
+		{
+			outCaveColumn[chunkZ] = true;
+		}
+	}
+
+	for (int chunkZ = 0; chunkZ < numZ; ++chunkZ)
+	{
+		if (outCaveColumn[chunkZ])
+		{
+			caves.m_stats.m_numBlocksCarved += 1;
+		}
+	}
+	caves.m_stats.m_numCandidateBlocks += numZ;
+}
+
+void Chunk::ComputeDensityLattice(WorldGenSettings const& settings, std::vector<float>& outLattice, int minZ, int maxZ) const
+{
+	int stepXY = settings.m_densityLatticeStepXY;
+	int stepZ = settings.m_densityLatticeStepZ;
+
+	// Lattice includes the far chunk edge so neighboring chunks interpolate between identical samples
+	int numLatticeX = (CHUNK_SIZE_X / stepXY) + 1;
+	int numLatticeY = (CHUNK_SIZE_Y / stepXY) + 1;
+	int numLatticeZ = (CHUNK_SIZE_Z / stepZ) + 1;
+	outLattice.resize(numLatticeX * numLatticeY * numLatticeZ);
+
+	int chunkGlobalX = m_chunkCoords.x * CHUNK_SIZE_X;
+	int chunkGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y;
+
+	// Only the levels that blocks in [minZ, maxZ] interpolate between are sampled
+	int minLatticeZ = minZ / stepZ;
+	int maxLatticeZ = GetMin(maxZ / stepZ + 1, numLatticeZ - 1);
+
+	// Lattice rows along X are contiguous, so each row is one batched noise call
+	float rowPosX[CHUNK_SIZE_X + 1];
+	float rowPosY[CHUNK_SIZE_X + 1];
+	float rowPosZ[CHUNK_SIZE_X + 1];
+	for (int latticeZ = minLatticeZ; latticeZ <= maxLatticeZ; ++latticeZ)
+	{
+		for (int latticeY = 0; latticeY < numLatticeY; ++latticeY)
+		{
+			for (int latticeX = 0; latticeX < numLatticeX; ++latticeX)
+			{
+				rowPosX[latticeX] = static_cast<float>(chunkGlobalX + latticeX * stepXY);
+				rowPosY[latticeX] = static_cast<float>(chunkGlobalY + latticeY * stepXY);
+				rowPosZ[latticeX] = static_cast<float>(latticeZ * stepZ);
+			}
+
+			int rowStart = (latticeZ * numLatticeY + latticeY) * numLatticeX;
+			Compute3dPerlinNoiseBatch(rowPosX, rowPosY, rowPosZ, &outLattice[rowStart], numLatticeX,
+				                      DENSITY_NOISE_SCALE, DENSITY_OCTAVES, DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED);
+		}
+	}
+}
+
+void Chunk::SampleDensityLatticeColumn(WorldGenSettings const& settings, std::vector<float> const& lattice, int localX, int localY, float* outNoiseColumn,
+	                                   int minZ, int maxZ) const
+{
+	int stepXY = settings.m_densityLatticeStepXY;
+	int stepZ = settings.m_densityLatticeStepZ;
+	int numLatticeX = (CHUNK_SIZE_X / stepXY) + 1;
+	int numLatticeY = (CHUNK_SIZE_Y / stepXY) + 1;
+	int numLatticeZ = (CHUNK_SIZE_Z / stepZ) + 1;
+
+	int cellX = localX / stepXY;
+	int cellY = localY / stepXY;
+	float fractionX = static_cast<float>(localX - cellX * stepXY) / static_cast<float>(stepXY);
+	float fractionY = static_cast<float>(localY - cellY * stepXY) / static_cast<float>(stepXY);
+
+	// Bilinear blend in XY at every lattice Z level the range touches
+	float levelNoise[CHUNK_SIZE_Z + 1];
+	int minLatticeZ = minZ / stepZ;
+	int maxLatticeZ = GetMin(maxZ / stepZ + 1, numLatticeZ - 1);
+	for (int latticeZ = minLatticeZ; latticeZ <= maxLatticeZ; ++latticeZ)
+	{
+		int southWestIndex = (latticeZ * numLatticeY + cellY) * numLatticeX + cellX;
+		int northWestIndex = southWestIndex + numLatticeX;
+
+		float south = Interpolate(lattice[southWestIndex], lattice[southWestIndex + 1], fractionX);
+		float north = Interpolate(lattice[northWestIndex], lattice[northWestIndex + 1], fractionX);
+		levelNoise[latticeZ] = Interpolate(south, north, fractionY);
+	}
+
+	// Linear blend in Z between lattice levels
+	for (int chunkZ = minZ; chunkZ <= maxZ; ++chunkZ)
+	{
+		int cellZ = chunkZ / stepZ;
+		float fractionZ = static_cast<float>(chunkZ - cellZ * stepZ) / static_cast<float>(stepZ);
+		outNoiseColumn[chunkZ] = Interpolate(levelNoise[cellZ], levelNoise[cellZ + 1], fractionZ);
+	}
+}
+
+void Chunk::GetContinentShaping(WorldGenSettings const& settings, float continentNoise, float& outHeightOffset, float& outSquashingFactor, float& outBaseHeight) const
+{
+	float normalizedNoise = (continentNoise + 1.0f) * 0.5f;
+	outHeightOffset = settings.m_continentHeightOffsetCurve->EvaluateAtParametric(normalizedNoise).y;
+	outSquashingFactor = settings.m_continentSquashCurve->EvaluateAtParametric(normalizedNoise).y;
+	outBaseHeight = DEFAULT_TERRAIN_HEIGHT + (outHeightOffset * (CHUNK_SIZE_Z / 8.5f));
+}
+
+void Chunk::GetColumnDensityBounds(float heightOffset, float squashingFactor, float baseHeight, int& outMinUncertainZ, int& outMaxUncertainZ) const
+{
+	// Density is noise plus a shaping term, and the noise never leaves [-1, 1]. Wherever the
+	// shaping term alone is further than DENSITY_NOISE_BOUND from zero, no noise value can
+	// change the block from solid to air or back.
+	outMinUncertainZ = CHUNK_SIZE_Z;
+	outMaxUncertainZ = -1;
+	for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+	{
+		float shapingDensity = ComputeShapedDensity(0.f, chunkZ, heightOffset, squashingFactor, baseHeight);
+		if (fabsf(shapingDensity) <= DENSITY_NOISE_BOUND)
+		{
+			outMinUncertainZ = GetMin(outMinUncertainZ, chunkZ);
+			outMaxUncertainZ = chunkZ;
+		}
+	}
+}
+
+ColumnBoundsReport Chunk::MeasureColumnBounds(WorldGenSettings const& settings) const
+{
+	ColumnBoundsReport report;
+	const int numXY = CHUNK_SIZE_X * CHUNK_SIZE_Y;
+	bool useDensityLattice = (settings.m_densityMode == DensitySampleMode::LATTICE);
+
+	std::vector<float> heightOffsetMap(numXY);
+	std::vector<float> squashingFactorMap(numXY);
+	std::vector<float> baseHeightMap(numXY);
+	for (int columnIndex = 0; columnIndex < numXY; ++columnIndex)
+	{
+		int globalX = m_chunkCoords.x * CHUNK_SIZE_X + (columnIndex & CHUNK_MASK_X);
+		int globalY = m_chunkCoords.y * CHUNK_SIZE_Y + (columnIndex >> CHUNK_BITS_X);
+		float continentNoise = Compute2dPerlinNoise(static_cast<float>(globalX), static_cast<float>(globalY), CONTINENT_SCALE, CONTINENT_OCTAVES,
+			DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 100);
+		GetContinentShaping(settings, continentNoise, heightOffsetMap[columnIndex], squashingFactorMap[columnIndex], baseHeightMap[columnIndex]);
+	}
+
+	// Full path, every block's density evaluated
+	std::vector<uint8_t> fullSolid(CHUNK_BLOCK_TOTAL);
+	std::vector<float> lattice;
+	float noiseColumn[CHUNK_SIZE_Z];
+	double fullStartTime = GetCurrentTimeSeconds();
+	if (useDensityLattice)
+	{
+		ComputeDensityLattice(settings, lattice);
+	}
+	for (int columnIndex = 0; columnIndex < numXY; ++columnIndex)
+	{
+		if (useDensityLattice)
+		{
+			SampleDensityLatticeColumn(settings, lattice, columnIndex & CHUNK_MASK_X, columnIndex >> CHUNK_BITS_X, noiseColumn);
+		}
+		else
+		{
+			ComputeDensityNoiseColumn(columnIndex & CHUNK_MASK_X, columnIndex >> CHUNK_BITS_X, noiseColumn);
+		}
+		for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+		{
+			float density = ComputeShapedDensity(noiseColumn[chunkZ], chunkZ, heightOffsetMap[columnIndex], squashingFactorMap[columnIndex], baseHeightMap[columnIndex]);
+			fullSolid[columnIndex * CHUNK_SIZE_Z + chunkZ] = (density < 0.f) ? 1 : 0;
+		}
+	}
+	report.m_fullSeconds = GetCurrentTimeSeconds() - fullStartTime;
+
+	// Bounded path, noise only inside each column's uncertain band
+	std::vector<uint8_t> boundedSolid(CHUNK_BLOCK_TOTAL);
+	std::vector<int> minUncertainZMap(numXY);
+	std::vector<int> maxUncertainZMap(numXY);
+	double boundedStartTime = GetCurrentTimeSeconds();
+	int chunkMinUncertainZ = CHUNK_SIZE_Z;
+	int chunkMaxUncertainZ = -1;
+	for (int columnIndex = 0; columnIndex < numXY; ++columnIndex)
+	{
+		GetColumnDensityBounds(heightOffsetMap[columnIndex], squashingFactorMap[columnIndex], baseHeightMap[columnIndex],
+			minUncertainZMap[columnIndex], maxUncertainZMap[columnIndex]);
+		chunkMinUncertainZ = GetMin(chunkMinUncertainZ, minUncertainZMap[columnIndex]);
+		chunkMaxUncertainZ = GetMax(chunkMaxUncertainZ, maxUncertainZMap[columnIndex]);
+	}
+	if (useDensityLattice && chunkMinUncertainZ <= chunkMaxUncertainZ)
+	{
+		ComputeDensityLattice(settings, lattice, chunkMinUncertainZ, chunkMaxUncertainZ);
+	}
+	for (int columnIndex = 0; columnIndex < numXY; ++columnIndex)
+	{
+		int minUncertainZ = minUncertainZMap[columnIndex];
+		int maxUncertainZ = maxUncertainZMap[columnIndex];
+		if (minUncertainZ <= maxUncertainZ)
+		{
+			if (useDensityLattice)
+			{
+				SampleDensityLatticeColumn(settings, lattice, columnIndex & CHUNK_MASK_X, columnIndex >> CHUNK_BITS_X, noiseColumn, minUncertainZ, maxUncertainZ);
+			}
+			else
+			{
+				ComputeDensityNoiseColumn(columnIndex & CHUNK_MASK_X, columnIndex >> CHUNK_BITS_X, noiseColumn, minUncertainZ, maxUncertainZ);
+			}
+			report.m_numBlocksEvaluated += maxUncertainZ - minUncertainZ + 1;
+		}
+		for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+		{
+			bool isUncertain = (chunkZ >= minUncertainZ && chunkZ <= maxUncertainZ);
+			float noiseValue = isUncertain ? noiseColumn[chunkZ] : 0.f;
+			float density = ComputeShapedDensity(noiseValue, chunkZ, heightOffsetMap[columnIndex], squashingFactorMap[columnIndex], baseHeightMap[columnIndex]);
+			boundedSolid[columnIndex * CHUNK_SIZE_Z + chunkZ] = (density < 0.f) ? 1 : 0;
+		}
+	}
+	report.m_boundedSeconds = GetCurrentTimeSeconds() - boundedStartTime;
+
+	for (int blockIndex = 0; blockIndex < CHUNK_BLOCK_TOTAL; ++blockIndex)
+	{
+		if (fullSolid[blockIndex] != boundedSolid[blockIndex])
+		{
+			report.m_numMismatchedBlocks += 1;
+		}
+	}
+	report.m_numBlocks = CHUNK_BLOCK_TOTAL;
+	return report;
+}
+
+float Chunk::ComputeShapedDensity(float noiseValue, int globalZ, float heightOffset, float squashingFactor, float baseHeight) const
+{
+	const float densityBiasPerBlock = 2.f / static_cast<float>(CHUNK_SIZE_Z);
+
+	// Terrain density bias
+	float noiseBias = densityBiasPerBlock * (static_cast<float>(globalZ) - DEFAULT_TERRAIN_HEIGHT);
+	float densityValue = noiseValue + noiseBias;
+
+	// Applying continental shaping
+	float offset = (static_cast<float>(globalZ) - baseHeight) / baseHeight;
+	densityValue -= heightOffset;
+	densityValue += (squashingFactor * SQUASH_MULT) * offset;
+	return densityValue;
+}
+
+DensityErrorReport Chunk::MeasureDensityLatticeError(WorldGenSettings const& settings) const
+{
+	DensityErrorReport report;
+	const int numXY = CHUNK_SIZE_X * CHUNK_SIZE_Y;
+
+	// Reference path, every block sampled
+	std::vector<float> referenceNoise(CHUNK_BLOCK_TOTAL);
+	double perBlockStartTime = GetCurrentTimeSeconds();
+	for (int columnIndex = 0; columnIndex < numXY; ++columnIndex)
+	{
+		ComputeDensityNoiseColumn(columnIndex & CHUNK_MASK_X, columnIndex >> CHUNK_BITS_X, &referenceNoise[columnIndex * CHUNK_SIZE_Z]);
+	}
+	report.m_perBlockSeconds = GetCurrentTimeSeconds() - perBlockStartTime;
+
+	// Lattice path
+	std::vector<float> latticeNoise(CHUNK_BLOCK_TOTAL);
+	std::vector<float> lattice;
+	double latticeStartTime = GetCurrentTimeSeconds();
+	ComputeDensityLattice(settings, lattice);
+	for (int columnIndex = 0; columnIndex < numXY; ++columnIndex)
+	{
+		SampleDensityLatticeColumn(settings, lattice, columnIndex & CHUNK_MASK_X, columnIndex >> CHUNK_BITS_X, &latticeNoise[columnIndex * CHUNK_SIZE_Z]);
+	}
+	report.m_latticeSeconds = GetCurrentTimeSeconds() - latticeStartTime;
+	report.m_numLatticeSamples = static_cast<int>(lattice.size());
+
+	// Compare noise values and the resulting solid/air classification
+	double totalAbsError = 0.0;
+	for (int columnIndex = 0; columnIndex < numXY; ++columnIndex)
+	{
+		int globalX = m_chunkCoords.x * CHUNK_SIZE_X + (columnIndex & CHUNK_MASK_X);
+		int globalY = m_chunkCoords.y * CHUNK_SIZE_Y + (columnIndex >> CHUNK_BITS_X);
+		float continentNoise = Compute2dPerlinNoise(static_cast<float>(globalX), static_cast<float>(globalY), CONTINENT_SCALE, CONTINENT_OCTAVES,
+			DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 100);
+
+		float heightOffset = 0.f;
+		float squashingFactor = 0.f;
+		float baseHeight = 0.f;
+		GetContinentShaping(settings, continentNoise, heightOffset, squashingFactor, baseHeight);
+
+		for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+		{
+			float referenceValue = referenceNoise[columnIndex * CHUNK_SIZE_Z + chunkZ];
+			float latticeValue = latticeNoise[columnIndex * CHUNK_SIZE_Z + chunkZ];
+			float absError = fabsf(referenceValue - latticeValue);
+
+			totalAbsError += absError;
+			report.m_maxAbsError = GetMax(report.m_maxAbsError, absError);
+			bool isLatticeNode = ((columnIndex & CHUNK_MASK_X) % settings.m_densityLatticeStepXY == 0) &&
+				                 ((columnIndex >> CHUNK_BITS_X) % settings.m_densityLatticeStepXY == 0) && (chunkZ % settings.m_densityLatticeStepZ == 0);
+			if (isLatticeNode)
+			{
+				report.m_maxNodeError = GetMax(report.m_maxNodeError, absError);
+			}
+
+			bool isReferenceSolid = ComputeShapedDensity(referenceValue, chunkZ, heightOffset, squashingFactor, baseHeight) < 0.f;
+			bool isLatticeSolid = ComputeShapedDensity(latticeValue, chunkZ, heightOffset, squashingFactor, baseHeight) < 0.f;
+			if (isReferenceSolid != isLatticeSolid)
+			{
+				report.m_numMismatchedBlocks += 1;
+			}
+		}
+	}
+
+	report.m_numSamples = CHUNK_BLOCK_TOTAL;
+	report.m_meanAbsError = static_cast<float>(totalAbsError / static_cast<double>(CHUNK_BLOCK_TOTAL));
+	return report;
+}
+
+void Chunk::OreChance(int globalX, int globalY, int globalZ, Block* block) const
+{
+	// Reference path: every ore field evaluated per block, in priority order
+	for (int oreIndex = 0; oreIndex < NUM_ORE_FIELDS; ++oreIndex)
+	{
+		OreField const& ore = ORE_FIELDS[oreIndex];
+		float oreNoise = Compute3dPerlinNoise(globalX * ore.m_coordScale, globalY * ore.m_coordScale, globalZ * ore.m_coordScale,
+			1.0f, ore.m_octaves, 0.5f, 2.0f, true, ore.m_seed);
+
+		if (oreNoise > ore.m_threshold && globalZ < ore.m_maxZ)
+		{
+			block->SetBlockType(ore.m_blockType);
+			return;
+		}
+	}
+
+	block->SetBlockType(BLOCKTYPE_STONE);
+}
+
+OreStageStats Chunk::PlaceOres(WorldGenSettings const& settings, std::vector<uint8_t> const& oreCandidates, Block* blocks) const
+{
+	OreStageStats stats;
+	double startTime = GetCurrentTimeSeconds();
+
+	int numCandidateLayers = 0;
+	for (int blockIndex = 0; blockIndex < CHUNK_BLOCK_TOTAL; ++blockIndex)
+	{
+		if (oreCandidates[blockIndex] != 0)
+		{
+			stats.m_numCandidateBlocks += 1;
+			numCandidateLayers = GetMax(numCandidateLayers, IndexToLocalZ(blockIndex) + 1);
+		}
+	}
+
+	if (settings.m_oreMode == OrePlacementMode::PER_BLOCK)
+	{
+		for (int blockIndex = 0; blockIndex < CHUNK_BLOCK_TOTAL; ++blockIndex)
+		{
+			if (oreCandidates[blockIndex] != 0)
+			{
+				IntVec3 globalCoords = IndexToGlobalCoords(blockIndex);
+				OreChance(globalCoords.x, globalCoords.y, globalCoords.z, &blocks[blockIndex]);
+				stats.m_numBlocksEvaluated += 1;
+				if (blocks[blockIndex].m_blockType != BLOCKTYPE_STONE)
+				{
+					stats.m_numOreBlocksPlaced += 1;
+				}
+			}
+		}
+		stats.m_seconds = GetCurrentTimeSeconds() - startTime;
+		return stats;
+	}
+
+	// Coarse grid: sample each ore field every ORE_GRID_STEP blocks and only refine cells near its threshold.
+	// The margin is measured rather than proven, so a cell whose corners all miss it may still hide ore
+	const int numLatticeX = ORE_GRID_CELLS_X + 1;
+	const int numLatticeY = ORE_GRID_CELLS_Y + 1;
+	std::vector<float> oreLattice;
+	std::vector<float> refinePosX;
+	std::vector<float> refinePosY;
+	std::vector<float> refinePosZ;
+	std::vector<int> refineBlockIndices;
+	std::vector<float> refineNoise;
+	float rowPosX[ORE_GRID_CELLS_X + 1];
+	float rowPosY[ORE_GRID_CELLS_X + 1];
+	float rowPosZ[ORE_GRID_CELLS_X + 1];
+
+	for (int oreIndex = 0; oreIndex < NUM_ORE_FIELDS; ++oreIndex)
+	{
+		OreField const& ore = ORE_FIELDS[oreIndex];
+		int numLayers = GetMin(ore.m_maxZ, numCandidateLayers);
+		if (numLayers <= 0)
+		{
+			continue;
+		}
+
+		int numCellsZ = (numLayers + ORE_GRID_STEP_Z - 1) / ORE_GRID_STEP_Z;
+		int numLatticeZ = numCellsZ + 1;
+		oreLattice.resize(numLatticeX * numLatticeY * numLatticeZ);
+
+		for (int latticeZ = 0; latticeZ < numLatticeZ; ++latticeZ)
+		{
+			for (int latticeY = 0; latticeY < numLatticeY; ++latticeY)
+			{
+				for (int latticeX = 0; latticeX < numLatticeX; ++latticeX)
+				{
+					rowPosX[latticeX] = static_cast<float>(m_chunkCoords.x * CHUNK_SIZE_X + latticeX * ORE_GRID_STEP_XY) * ore.m_coordScale;
+					rowPosY[latticeX] = static_cast<float>(m_chunkCoords.y * CHUNK_SIZE_Y + latticeY * ORE_GRID_STEP_XY) * ore.m_coordScale;
+					rowPosZ[latticeX] = static_cast<float>(latticeZ * ORE_GRID_STEP_Z) * ore.m_coordScale;
+				}
+
+				int rowStart = (latticeZ * numLatticeY + latticeY) * numLatticeX;
+				Compute3dPerlinNoiseBatch(rowPosX, rowPosY, rowPosZ, &oreLattice[rowStart], numLatticeX, 1.0f, ore.m_octaves, 0.5f, 2.0f, true, ore.m_seed);
+			}
+		}
+		stats.m_numCoarseSamples += numLatticeX * numLatticeY * numLatticeZ;
+
+		// Gather the still-plain stone blocks of every cell that may cross the threshold
+		refinePosX.clear();
+		refinePosY.clear();
+		refinePosZ.clear();
+		refineBlockIndices.clear();
+		for (int cellZ = 0; cellZ < numCellsZ; ++cellZ)
+		{
+			for (int cellY = 0; cellY < ORE_GRID_CELLS_Y; ++cellY)
+			{
+				for (int cellX = 0; cellX < ORE_GRID_CELLS_X; ++cellX)
+				{
+					float maxCornerNoise = -1.f;
+					for (int corner = 0; corner < 8; ++corner)
+					{
+						int latticeIndex = ((cellZ + ((corner >> 2) & 1)) * numLatticeY + cellY + ((corner >> 1) & 1)) * numLatticeX + cellX + (corner & 1);
+						maxCornerNoise = GetMax(maxCornerNoise, oreLattice[latticeIndex]);
+					}
+					if (maxCornerNoise <= ore.m_threshold - ORE_REFINE_MARGIN)
+					{
+						continue;
+					}
+
+					int maxLocalZ = GetMin((cellZ + 1) * ORE_GRID_STEP_Z, numLayers);
+					for (int localZ = cellZ * ORE_GRID_STEP_Z; localZ < maxLocalZ; ++localZ)
+					{
+						for (int localY = cellY * ORE_GRID_STEP_XY; localY < (cellY + 1) * ORE_GRID_STEP_XY; ++localY)
+						{
+							for (int localX = cellX * ORE_GRID_STEP_XY; localX < (cellX + 1) * ORE_GRID_STEP_XY; ++localX)
+							{
+								int blockIndex = GetBlockIndex(localX, localY, localZ);
+								if (oreCandidates[blockIndex] == 0 || blocks[blockIndex].m_blockType != BLOCKTYPE_STONE)
+								{
+									continue;
+								}
+
+								refinePosX.push_back(static_cast<float>(m_chunkCoords.x * CHUNK_SIZE_X + localX) * ore.m_coordScale);
+								refinePosY.push_back(static_cast<float>(m_chunkCoords.y * CHUNK_SIZE_Y + localY) * ore.m_coordScale);
+								refinePosZ.push_back(static_cast<float>(localZ) * ore.m_coordScale);
+								refineBlockIndices.push_back(blockIndex);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// Exact noise for the gathered blocks only
+		int numRefined = static_cast<int>(refineBlockIndices.size());
+		refineNoise.resize(numRefined);
+		Compute3dPerlinNoiseBatch(refinePosX.data(), refinePosY.data(), refinePosZ.data(), refineNoise.data(), numRefined,
+			1.0f, ore.m_octaves, 0.5f, 2.0f, true, ore.m_seed);
+		for (int refineIndex = 0; refineIndex < numRefined; ++refineIndex)
+		{
+			if (refineNoise[refineIndex] > ore.m_threshold)
+			{
+				blocks[refineBlockIndices[refineIndex]].SetBlockType(ore.m_blockType);
+				stats.m_numOreBlocksPlaced += 1;
+			}
+		}
+		stats.m_numBlocksEvaluated += numRefined;
+	}
+
+	stats.m_seconds = GetCurrentTimeSeconds() - startTime;
+	return stats;
+}
+
+OreMeasurement Chunk::MeasureOrePlacement(WorldGenSettings const& settings) const
+{
+	OreMeasurement measurement;
+
+	// Every stone or ore block of this chunk came from the stone fill, reset them to stone in two scratch copies
+	std::vector<uint8_t> oreCandidates(CHUNK_BLOCK_TOTAL, 0);
+	std::vector<Block> perBlockBlocks(m_blocks, m_blocks + CHUNK_BLOCK_TOTAL);
+	for (int blockIndex = 0; blockIndex < CHUNK_BLOCK_TOTAL; ++blockIndex)
+	{
+		uint8_t blockType = m_blocks[blockIndex].m_blockType;
+		bool isOre = false;
+		for (int oreIndex = 0; oreIndex < NUM_ORE_FIELDS; ++oreIndex)
+		{
+			isOre |= (blockType == ORE_FIELDS[oreIndex].m_blockType);
+		}
+
+		if (isOre || blockType == BLOCKTYPE_STONE)
+		{
+			oreCandidates[blockIndex] = 1;
+			perBlockBlocks[blockIndex].SetBlockType(BLOCKTYPE_STONE);
+		}
+	}
+	std::vector<Block> coarseGridBlocks = perBlockBlocks;
+
+	WorldGenSettings perBlockSettings = settings;
+	perBlockSettings.m_oreMode = OrePlacementMode::PER_BLOCK;
+	measurement.m_perBlock = PlaceOres(perBlockSettings, oreCandidates, perBlockBlocks.data());
+
+	WorldGenSettings coarseGridSettings = settings;
+	coarseGridSettings.m_oreMode = OrePlacementMode::COARSE_GRID;
+	measurement.m_coarseGrid = PlaceOres(coarseGridSettings, oreCandidates, coarseGridBlocks.data());
+
+	for (int blockIndex = 0; blockIndex < CHUNK_BLOCK_TOTAL; ++blockIndex)
+	{
+		if (perBlockBlocks[blockIndex].m_blockType != coarseGridBlocks[blockIndex].m_blockType)
+		{
+			measurement.m_numMismatchedBlocks += 1;
+			measurement.m_numFalseOreBlocks += (perBlockBlocks[blockIndex].m_blockType == BLOCKTYPE_STONE) ? 1 : 0;
+		}
+	}
+
+	return measurement;
+}
+
+void Chunk::DecorateChunk(std::vector<TreePlacement> const& treePlacements)
+{
+	m_outgoingBlockWrites.clear();
+	for (int placementIndex = 0; placementIndex < static_cast<int>(treePlacements.size()); ++placementIndex)
+	{
+		TreePlacement const& placement = treePlacements[placementIndex];
+		TryToPlaceTreeStamp(placement.m_stampType, placement.m_localCoords.x, placement.m_localCoords.y, placement.m_localCoords.z);
+	}
+}
+
+void Chunk::TryToPlaceTreeStamp(TreeStampType stampType, int localX, int localY, int localZ)
+{
+	TreeStampRange const& stampRange = TREE_STAMP_TABLES.m_ranges[stampType];
+	for (int stampBlockIndex = 0; stampBlockIndex < stampRange.m_numBlocks; ++stampBlockIndex)
+	{
+		PackedStampBlock const& stampBlock = TREE_STAMP_TABLES.m_blocks[stampRange.m_firstBlock + stampBlockIndex];
+		uint8_t blocktype = stampBlock.m_blockType;
+		IntVec3 treePosition = IntVec3(localX + stampBlock.m_x, localY + stampBlock.m_y, localZ + stampBlock.m_z);
+		IntVec2 neighborChunkOffset = IntVec2::ZERO;
+		IntVec3 blockPositionInTarget = treePosition;
+
+		// X
+		if (treePosition.x < 0)
+		{
+			neighborChunkOffset.x = -1;
+			blockPositionInTarget.x += CHUNK_SIZE_X;
+		}
+		else if (treePosition.x >= CHUNK_SIZE_X)
+		{
+			neighborChunkOffset.x = 1;
+			blockPositionInTarget.x -= CHUNK_SIZE_X;
+		}
+
+		// Y
+		if (treePosition.y < 0)
+		{
+			neighborChunkOffset.y = -1;
+			blockPositionInTarget.y += CHUNK_SIZE_Y;
+		}
+		else if (treePosition.y >= CHUNK_SIZE_Y)
+		{
+			neighborChunkOffset.y = 1;
+			blockPositionInTarget.y -= CHUNK_SIZE_Y;
+		}
+
+		// Skipping blocks below or above world height
+		if (blockPositionInTarget.z < 0 || blockPositionInTarget.z >= CHUNK_SIZE_Z)
+		{
+			continue;
+		}
+
+		// Blocks for neighboring chunks are queued, the world applies them on the main thread
+		int index = GetBlockIndex(blockPositionInTarget);
+		if (neighborChunkOffset.x != 0 || neighborChunkOffset.y != 0)
+		{
+			PendingBlockWrite pendingWrite;
+			pendingWrite.m_targetChunkCoords = m_chunkCoords + neighborChunkOffset;
+			pendingWrite.m_blockIndex = index;
+			pendingWrite.m_blockType = blocktype;
+			m_outgoingBlockWrites.push_back(pendingWrite);
+			continue;
+		}
+
+		Block& block = m_blocks[index];
+		if (block.m_blockType == BLOCKTYPE_AIR)
+		{
+			block.SetBlockType(blocktype);
+		}
+	}
+}
+
+int Chunk::GetTemperatureBand(float v)
+{
+	if (v < -0.45f) return 0;
+	if (v < -0.15f) return 1;
+	if (v < 0.20f) return 2; 
+	if (v < 0.55f) return 3;
+	return 4;
+}
+
+int Chunk::GetHumidityBand(float v)
+{
+	if (v < -0.35f) return 0; 
+	if (v < -0.10f) return 1; 
+	if (v < 0.10f) return 2;
+	if (v < 0.30f) return 3; 
+	return 4;
+}
+
+int Chunk::GetContinentalnessBand(float v)
+{
+	if (v < -1.05f) return 0;      // Deep Ocean
+	if (v < -0.455f) return 1;    // Deep Ocean
+	if (v < -0.19f) return 2;    // Ocean
+	if (v < -0.11f) return 3;   // Coast
+	if (v < 0.03f) return 4;   // Near-Inland
+	if (v < 0.30f) return 5;  // Mid-Inland
+	return 6;                // Far-Inland
+}
+
+BiomeLookup const& Chunk::GetBiomeLookup(BiomeParams const& biome)
+{
+	int temp = GetTemperatureBand(biome.temperature);
+	int humidity = GetHumidityBand(biome.humidity);
+	int continent = GetContinentalnessBand(biome.continentalness);
+	return BIOME_LOOKUP_TABLE[GetBiomeLookupIndex(temp, humidity, continent)];
+}
+
+BiomeType Chunk::GetBiomeType(BiomeParams const& biome)
+{
+	return GetBiomeLookup(biome).m_biome;
+}
+
+SurfaceBlocks Chunk::GetSurfaceBlocks(BiomeType biome)
+{
+	return GetBiomeSurfaceBlocks(biome);
+}
+
+BiomeLookupReport Chunk::MeasureBiomeLookup(int numSamples, unsigned int seed)
+{
+	BiomeLookupReport report;
+	report.m_numSamples = numSamples;
+
+	// Pseudo-random climate values covering every band
+	std::vector<BiomeParams> samples(numSamples);
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		BiomeParams& params = samples[sampleIndex];
+		params.continentalness = Get2dNoiseZeroToOne(sampleIndex, 0, seed) * 2.4f - 1.2f;
+		params.erosion = 0.f;
+		params.peaksValleys = 0.f;
+		params.temperature = Get2dNoiseZeroToOne(sampleIndex, 1, seed) * 2.f - 1.f;
+		params.humidity = Get2dNoiseZeroToOne(sampleIndex, 2, seed) * 2.f - 1.f;
+	}
+
+	// Reference path: the original branches classify and pick surface blocks per column
+	std::vector<BiomeType> referenceBiomes(numSamples);
+	std::vector<SurfaceBlocks> referenceSurfaces(numSamples);
+	double branchingStartTime = GetCurrentTimeSeconds();
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		BiomeParams const& params = samples[sampleIndex];
+		referenceBiomes[sampleIndex] = GetBiomeTypeReference(GetTemperatureBand(params.temperature), GetHumidityBand(params.humidity),
+			GetContinentalnessBand(params.continentalness));
+		referenceSurfaces[sampleIndex] = GetSurfaceBlocksReference(referenceBiomes[sampleIndex]);
+	}
+	report.m_branchingSeconds = GetCurrentTimeSeconds() - branchingStartTime;
+
+	// Table path
+	std::vector<BiomeLookup const*> lookupResults(numSamples);
+	double lookupStartTime = GetCurrentTimeSeconds();
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		lookupResults[sampleIndex] = &GetBiomeLookup(samples[sampleIndex]);
+	}
+	report.m_lookupSeconds = GetCurrentTimeSeconds() - lookupStartTime;
+
+	// Trees are compared untimed, for every surface block type a tree could stand on
+	for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		BiomeLookup const& lookup = *lookupResults[sampleIndex];
+		SurfaceBlocks const& referenceSurface = referenceSurfaces[sampleIndex];
+		bool isSame = (referenceBiomes[sampleIndex] == lookup.m_biome) && (referenceSurface.top == lookup.m_surface.top) &&
+			(referenceSurface.sub == lookup.m_surface.sub) && (referenceSurface.underwater == lookup.m_surface.underwater);
+
+		float treeVariantNoise = Get2dNoiseZeroToOne(sampleIndex, 3, seed);
+		int treeVariant = GetTreeVariant(treeVariantNoise);
+		for (int surfaceType = 0; surfaceType < NUM_BLOCK_TYPES && isSame; ++surfaceType)
+		{
+			TreeStampType lookupStamp = TREE_STAMP_NONE;
+			if (surfaceType == lookup.m_treeSurfaceTypes[0] || surfaceType == lookup.m_treeSurfaceTypes[1])
+			{
+				lookupStamp = lookup.m_treeStamps[treeVariant];
+			}
+			isSame = (lookupStamp == GetTreeStampReference(referenceBiomes[sampleIndex], static_cast<uint8_t>(surfaceType), treeVariantNoise));
+		}
+
+		if (!isSame)
+		{
+			report.m_numMismatches += 1;
+		}
+	}
+
+	return report;
+}
+
+ClimateCacheReport Chunk::MeasureClimateCache(ClimateCache& climateCache)
+{
+	ClimateCacheReport report;
+	const int numXY = CHUNK_SIZE_X * CHUNK_SIZE_Y;
+	report.m_numColumns = numXY;
+
+	// Same five fields, interpolated from the cache and evaluated per block as PopulateWithDensityNoise does without it
+	const int NUM_FIELDS = 5;
+	std::vector<float> cachedMaps(NUM_FIELDS * numXY);
+	std::vector<float> perBlockMaps(NUM_FIELDS * numXY);
+	climateCache.SampleChunkClimate(m_chunkCoords, &cachedMaps[0 * numXY], &cachedMaps[1 * numXY], &cachedMaps[2 * numXY], &cachedMaps[3 * numXY], &cachedMaps[4 * numXY]);
+
+	float const fieldScales[NUM_FIELDS] = { CONTINENTALNESS_SCALE, EROSIION_SCALE, PEAKVALLEY_SCALE, TEMPERATURE_SCALE, HUMIDITY_SCALE };
+	unsigned int const fieldSeeds[NUM_FIELDS] = { GAME_SEED + 100, GAME_SEED + 200, GAME_SEED + 300, GAME_SEED + 400, GAME_SEED + 500 };
+	float rowPosX[CHUNK_SIZE_X];
+	float rowPosY[CHUNK_SIZE_X];
+	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+	{
+		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+		{
+			rowPosX[chunkX] = static_cast<float>(m_chunkCoords.x * CHUNK_SIZE_X + chunkX);
+			rowPosY[chunkX] = static_cast<float>(m_chunkCoords.y * CHUNK_SIZE_Y + chunkY);
+		}
+		for (int fieldIndex = 0; fieldIndex < NUM_FIELDS; ++fieldIndex)
+		{
+			Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &perBlockMaps[fieldIndex * numXY + chunkY * CHUNK_SIZE_X], CHUNK_SIZE_X, fieldScales[fieldIndex], BIOME_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, fieldSeeds[fieldIndex]);
+		}
+	}
+
+	double totalAbsError = 0.0;
+	for (int fieldIndex = 0; fieldIndex < NUM_FIELDS; ++fieldIndex)
+	{
+		for (int chunkIndex = 0; chunkIndex < numXY; ++chunkIndex)
+		{
+			float absError = fabsf(cachedMaps[fieldIndex * numXY + chunkIndex] - perBlockMaps[fieldIndex * numXY + chunkIndex]);
+			totalAbsError += absError;
+			report.m_maxAbsError = GetMax(report.m_maxAbsError, absError);
+
+			// Chunks start on a multiple of the sample step inside their region
+			bool isSamplePoint = ((chunkIndex & CHUNK_MASK_X) % CLIMATE_SAMPLE_STEP == 0) && ((chunkIndex >> CHUNK_BITS_X) % CLIMATE_SAMPLE_STEP == 0);
+			if (isSamplePoint)
+			{
+				report.m_maxSampleError = GetMax(report.m_maxSampleError, absError);
+			}
+		}
+	}
+	report.m_meanAbsError = static_cast<float>(totalAbsError / static_cast<double>(NUM_FIELDS * numXY));
+
+	// Biome and surface blocks are what the world actually sees of the climate
+	for (int chunkIndex = 0; chunkIndex < numXY; ++chunkIndex)
+	{
+		BiomeParams cachedParams = { cachedMaps[chunkIndex], cachedMaps[numXY + chunkIndex], cachedMaps[2 * numXY + chunkIndex], cachedMaps[3 * numXY + chunkIndex], cachedMaps[4 * numXY + chunkIndex] };
+		BiomeParams perBlockParams = { perBlockMaps[chunkIndex], perBlockMaps[numXY + chunkIndex], perBlockMaps[2 * numXY + chunkIndex], perBlockMaps[3 * numXY + chunkIndex], perBlockMaps[4 * numXY + chunkIndex] };
+		BiomeLookup const& cachedLookup = GetBiomeLookup(cachedParams);
+		BiomeLookup const& perBlockLookup = GetBiomeLookup(perBlockParams);
+		bool isSame = (cachedLookup.m_biome == perBlockLookup.m_biome) && (cachedLookup.m_surface.top == perBlockLookup.m_surface.top) &&
+			(cachedLookup.m_surface.sub == perBlockLookup.m_surface.sub) && (cachedLookup.m_surface.underwater == perBlockLookup.m_surface.underwater);
+		report.m_numBiomeMismatches += isSame ? 0 : 1;
+	}
+
+	std::vector<CavernSphere> cachedCaverns;
+	std::vector<CavernSphere> perChunkCaverns;
+	climateCache.GetChunkCaverns(m_chunkCoords, cachedCaverns);
+	AppendCavernsForChunk(m_chunkCoords, perChunkCaverns);
+	int numCaverns = GetMax(static_cast<int>(cachedCaverns.size()), static_cast<int>(perChunkCaverns.size()));
+	for (int cavernIndex = 0; cavernIndex < numCaverns; ++cavernIndex)
+	{
+		if (cavernIndex >= static_cast<int>(cachedCaverns.size()) || cavernIndex >= static_cast<int>(perChunkCaverns.size()))
+		{
+			report.m_numCavernMismatches += 1;
+			continue;
+		}
+
+		CavernSphere const& cached = cachedCaverns[cavernIndex];
+		CavernSphere const& perChunk = perChunkCaverns[cavernIndex];
+		bool isSame = (cached.m_center.x == perChunk.m_center.x) && (cached.m_center.y == perChunk.m_center.y) && (cached.m_center.z == perChunk.m_center.z) &&
+			(cached.m_radius == perChunk.m_radius);
+		report.m_numCavernMismatches += isSame ? 0 : 1;
+	}
+
+	return report;
+}
+
+void Chunk::PopulateChunksWithNoise()
+{
+	unsigned int terrainSeed = GAME_SEED;
+	unsigned int humiditySeed = terrainSeed + 1;
+	unsigned int temperatureSeed = humiditySeed + 1;
+	unsigned int hillSeed = temperatureSeed + 1;
+	unsigned int oceanSeed = hillSeed + 1;
+	unsigned int dirtSeed = oceanSeed + 1;
+
+	std::vector<int> heightMapXY(CHUNK_SIZE_X * CHUNK_SIZE_Y);
+	std::vector<int> dirtDepthXY(CHUNK_SIZE_X * CHUNK_SIZE_Y);
+	std::vector<float> humidityMapXY(CHUNK_SIZE_X * CHUNK_SIZE_Y);
+	std::vector<float> tempMapXY(CHUNK_SIZE_X * CHUNK_SIZE_Y);
+
+	// Generating the noise maps
+	GenerateNoiseMaps(humiditySeed, humidityMapXY, temperatureSeed, tempMapXY, hillSeed, oceanSeed, terrainSeed, dirtSeed, dirtDepthXY, heightMapXY);
+
+	// Fill the blocks based on noise maps
+	PopulateTerrainBlocks(heightMapXY, dirtDepthXY, humidityMapXY, tempMapXY, terrainSeed);
+
+	// Generate vegetation
+	PopulateTrees(heightMapXY, humidityMapXY, tempMapXY);
+}
+
+void Chunk::GenerateNoiseMaps(unsigned int humiditySeed, std::vector<float>& humidityMapXY, unsigned int temperatureSeed, std::vector<float>& tempMapXY, unsigned int hillSeed, unsigned int oceanSeed, unsigned int terrainSeed, unsigned int dirtSeed, std::vector<int>& dirtDepthXY, std::vector<int>& heightMapXY)
+{
+	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+	{
+		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+		{
+			int chunkGlobalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
+			int chunkGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
+			int blockIndexXY = chunkY * CHUNK_SIZE_X + chunkX;
+
+			// Humidity
+			float humidityNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), HUMIDITY_NOISE_SCALE, HUMIDITY_NOISE_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, humiditySeed);
+			float humidity = 0.5f + 0.5f * humidityNoise;
+			humidityMapXY[blockIndexXY] = humidity;
+
+			// Temperature
+			float temperatureRaw = Get2dNoiseNegOneToOne(chunkGlobalX, chunkGlobalY, temperatureSeed) * TEMPERATURE_RAW_NOISE_SCALE;
+			float temperatureNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), TEMPERATURE_NOISE_SCALE, TEMPERATURE_NOISE_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, temperatureSeed);
+			float temperature = temperatureRaw + 0.5f + 0.5f * temperatureNoise;
+			tempMapXY[blockIndexXY] = temperature;
+
+			// Hills
+			float hillNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), HILLINESS_NOISE_SCALE, HILLINESS_NOISE_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, hillSeed);
+			float hillNormalized = (hillNoise + 1.f) * 0.5f;
+			float hill = SmoothStep3(hillNormalized);
+
+			// Ocean
+			float oceanNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), OCEANESS_NOISE_SCALE, OCEANESS_NOISE_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, oceanSeed);
+
+			// Terrain
+			float terrainNoise = Compute2dPerlinNoise(static_cast<float>(chunkGlobalX), static_cast<float>(chunkGlobalY), TERRAIN_NOISE_SCALE, TERRAIN_NOISE_OCTAVES,
+				DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, terrainSeed);
+			float riverValleyTerrain = fabsf(terrainNoise);
+			float baseTerrainHeight = DEFAULT_TERRAIN_HEIGHT + hill * RangeMap(riverValleyTerrain, 0.f, 1.f, -RIVER_DEPTH, DEFAULT_TERRAIN_HEIGHT);
+
+			// Ocean dips
+			if (oceanNoise > OCEAN_START_THRESHOLD)
+			{
+				float oceanBlend = (oceanNoise - OCEAN_START_THRESHOLD) / (OCEAN_END_THRESHOLD - OCEAN_START_THRESHOLD);
+				oceanBlend = GetClamped(oceanBlend, 0.f, 1.f);
+				baseTerrainHeight -= Interpolate(0.f, OCEAN_DEPTH, oceanBlend);
+			}
+
+			int terrainHeight = static_cast<int>(floorf(baseTerrainHeight));
+
+			// Dirt depth
+			float dirtDepthNoise = Get2dNoiseZeroToOne(chunkGlobalX, chunkGlobalY, dirtSeed);
+			int dirtSubZ = MIN_DIRT_OFFSET_Z + RoundDownToInt(dirtDepthNoise * (MAX_DIRT_OFFSET_Z - MIN_DIRT_OFFSET_Z));
+			dirtDepthXY[blockIndexXY] = dirtSubZ;
+
+			heightMapXY[blockIndexXY] = terrainHeight;
+		}
+	}
+}
+
+void Chunk::PopulateTerrainBlocks(std::vector<int> heightMapXY, std::vector<int> dirtDepthXY, std::vector<float> humidityMapXY, std::vector<float> tempMapXY, unsigned int terrainSeed)
+{
+	for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+	{
+		for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+		{
+			for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+			{
+				int blockIndex = GetBlockIndex(chunkX, chunkY, chunkZ);
+				Block* block = &m_blocks[blockIndex];
+				block->m_blockType = BLOCKTYPE_AIR;
+
+				int chunkGlobalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
+				int chunkGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
+				int chunkGlobalZ = chunkZ;
+
+				int blockIndexXY = chunkY * CHUNK_SIZE_X + chunkX;
+				int terrainHeight = heightMapXY[blockIndexXY];
+				int dirtDepth = dirtDepthXY[blockIndexXY];
+				float humidity = humidityMapXY[blockIndexXY];
+				float temperature = tempMapXY[blockIndexXY];
+
+				// Ice
+				float iceDepthFloat = DEFAULT_TERRAIN_HEIGHT - floorf(RangeMapClamped(temperature, ICE_TEMPERATURE_MAX, ICE_TEMPERATURE_MIN, ICE_DEPTH_MIN, ICE_DEPTH_MAX));
+				int iceDepth = static_cast<int>(iceDepthFloat);
+
+				// Water
+				if (chunkGlobalZ > terrainHeight && chunkGlobalZ < SEA_LEVEL_Z)
+				{
+					if (temperature < 0.38f && chunkGlobalZ > iceDepth)
+					{
+						block->m_blockType = BLOCKTYPE_ICE;
+					}
+					else
+					{
+						block->m_blockType = BLOCKTYPE_WATER;
+					}
+				}
+
+				// Surface
+				if (chunkGlobalZ == terrainHeight)
+				{
+					BlockType blockType = BLOCKTYPE_GRASS;
+					if (humidity < MIN_SAND_HUMIDITY)
+					{
+						blockType = BLOCKTYPE_SAND;
+					}
+					if (humidity < MAX_SAND_HUMIDITY && terrainHeight <= static_cast<int>(DEFAULT_TERRAIN_HEIGHT))
+					{
+						blockType = BLOCKTYPE_SAND;
+					}
+					block->m_blockType = blockType;
+				}
+
+				int dirtTopZ = terrainHeight - dirtDepth;
+				int sandTopZ = terrainHeight - static_cast<int>(RoundDownToInt(RangeMapClamped(humidity, MIN_SAND_DEPTH_HUMIDITY, MAX_SAND_DEPTH_HUMIDITY, SAND_DEPTH_MIN, SAND_DEPTH_MAX)));
+
+				if (chunkGlobalZ < terrainHeight && chunkGlobalZ >= dirtTopZ)
+				{
+					BlockType blockType = BLOCKTYPE_DIRT;
+					if (chunkGlobalZ >= sandTopZ)
+					{
+						blockType = BLOCKTYPE_SAND;
+					}
+					block->m_blockType = blockType;
+				}
+
+				// Underground
+				if (chunkGlobalZ < dirtTopZ)
+				{
+					if (chunkGlobalZ == OBSIDIAN_Z)
+					{
+						block->m_blockType = BLOCKTYPE_OBSIDIAN;
+					}
+					else if (chunkGlobalZ == LAVA_Z)
+					{
+						block->m_blockType = BLOCKTYPE_LAVA;
+					}
+					else
+					{
+						float oreNoise = Get3dNoiseZeroToOne(chunkGlobalX, chunkGlobalY, chunkZ, terrainSeed + 100);
+
+						if (oreNoise < DIAMOND_CHANCE)
+						{
+							block->m_blockType = BLOCKTYPE_DIAMOND;
+						}
+						else if (oreNoise < GOLD_CHANCE)
+						{
+							block->m_blockType = BLOCKTYPE_GOLD;
+						}
+						else if (oreNoise < IRON_CHANCE)
+						{
+							block->m_blockType = BLOCKTYPE_IRON;
+						}
+						else if (oreNoise < COAL_CHANCE)
+						{
+							block->m_blockType = BLOCKTYPE_COAL;
+						}
+						else
+						{
+							block->m_blockType = BLOCKTYPE_STONE;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void Chunk::PopulateTrees(std::vector<int> heightMapXY, std::vector<float> humidityMapXY, std::vector<float> tempMapXY)
+{
+	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+	{
+		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+		{
+			int chunkGlobalX = m_chunkCoords.x * CHUNK_SIZE_X + chunkX;
+			int chunkGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y + chunkY;
+			int blockIndexXY = chunkY * CHUNK_SIZE_X + chunkX;
+
+			int terrainHeight = heightMapXY[blockIndexXY];
+			float humidity = humidityMapXY[blockIndexXY];
+			float temperature = tempMapXY[blockIndexXY];
+
+			// Check to not spawn trees underwater
+			if (terrainHeight < SEA_LEVEL_Z)
+			{
+				continue;
+			}
+
+			int blockIndex = GetBlockIndex(chunkX, chunkY, terrainHeight);
+			uint8_t surfaceBlockType = m_blocks[blockIndex].m_blockType;
+
+			// Check so that our trees spawn on grass
+			if (surfaceBlockType != BLOCKTYPE_GRASS)
+			{
+				continue;
+			}
+
+			float treeNoise = Get2dNoiseZeroToOne(chunkGlobalX, chunkGlobalY, GAME_SEED);
+			if (treeNoise > 0.0005f)
+			{
+				continue;
+			}
+
+			// Choosing a tree type by climate
+			BlockType blockLog = BLOCKTYPE_OAKLOG;
+			BlockType blockLeaves = BLOCKTYPE_OAKLEAVES;
+
+			if (temperature < 0.4f)
+			{
+				blockLog = BLOCKTYPE_SPRUCELOG;
+				blockLeaves = BLOCKTYPE_SPRUCELEAVES;
+			}
+			else if (humidity > 0.7f)
+			{
+				blockLog = BLOCKTYPE_JUNGLELOG;
+				blockLeaves = BLOCKTYPE_JUNGLELEAVES;
+			}
+			else if (humidity < 0.3f)
+			{
+				blockLog = BLOCKTYPE_ACACIALOG;
+				blockLeaves = BLOCKTYPE_ACACIALEAVES;
+			}
+			else if (temperature > 0.8f)
+			{
+				blockLog = BLOCKTYPE_BIRCHLOG;
+				blockLeaves = BLOCKTYPE_BIRCHLEAVES;
+			}
+
+			// Setting a random trunk height
+			int trunkHeight = 6 + static_cast<int>((Get2dNoiseZeroToOne(chunkGlobalX, chunkGlobalY, GAME_SEED) * 4));
+
+			// Trunk
+			for (int chunkZ = 1; chunkZ <= trunkHeight; ++chunkZ)
+			{
+				int trunkZUp = terrainHeight + chunkZ;
+
+				if (trunkZUp >= CHUNK_SIZE_Z)
+				{
+					break;
+				}
+
+				int treeBlockIndex = GetBlockIndex(chunkX, chunkY, trunkZUp);
+				m_blocks[treeBlockIndex].m_blockType = blockLog;
+			}
+
+			// Leaves
+			for (int treeZ = -2; treeZ <= 2; ++treeZ)
+			{
+				int treeZUp = terrainHeight + trunkHeight + treeZ;
+
+				if (treeZUp < 0 || treeZUp >= CHUNK_SIZE_Z)
+				{
+					continue;
+				}
+
+				for (int treeY = -2; treeY <= 2; ++treeY)
+				{
+					int treeYAcross = chunkY + treeY;
+
+					if (treeYAcross < 0 || treeYAcross >= CHUNK_SIZE_Y)
+					{
+						continue;
+					}
+
+					for (int treeX = -2; treeX <= 2; ++treeX)
+					{
+						int treeXAcross = chunkX + treeX;
+
+						if (treeXAcross < 0 || treeXAcross >= CHUNK_SIZE_X)
+						{
+							continue;
+						}
+
+						float treeSpread = sqrtf(static_cast<float>((treeX * treeX) + (treeY * treeY) + (treeZ * treeZ)));
+						if (treeSpread > 2.5f)
+						{
+							continue;
+						}
+
+						int treeLeafIndex = GetBlockIndex(treeXAcross, treeYAcross, treeZUp);
+						if (m_blocks[treeLeafIndex].m_blockType == BLOCKTYPE_AIR)
+						{
+							m_blocks[treeLeafIndex].m_blockType = blockLeaves;
+						}
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,156 @@
+#include "Game/ChunkGrid.hpp"
+#include "Game/Chunk.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/RawNoise.hpp"
+#include <vector>
+
+Chunk* ChunkGrid::Find(IntVec2 const& chunkCoords) const
+{
+	ChunkGridCell const& cell = m_cells[GetCellIndex(chunkCoords)];
+	if (cell.m_chunk != nullptr && cell.m_chunkCoords.x == chunkCoords.x && cell.m_chunkCoords.y == chunkCoords.y)
+	{
+		return cell.m_chunk;
+	}
+
+	// Almost always empty, so out-of-window queries only pay for the hash when a cell is contested
+	if (m_overflowChunks.empty())
+	{
+		return nullptr;
+	}
+	auto foundChunk = m_overflowChunks.find(chunkCoords);
+	return (foundChunk != m_overflowChunks.end()) ? foundChunk->second : nullptr;
+}
+
+bool ChunkGrid::Contains(IntVec2 const& chunkCoords) const
+{
+	return Find(chunkCoords) != nullptr;
+}
+
+void ChunkGrid::Insert(Chunk* chunk)
+{
+	ChunkGridCell& cell = m_cells[GetCellIndex(chunk->m_chunkCoords)];
+	if (cell.m_chunk == nullptr)
+	{
+		cell.m_chunkCoords = chunk->m_chunkCoords;
+		cell.m_chunk = chunk;
+	}
+	else
+	{
+		m_overflowChunks[chunk->m_chunkCoords] = chunk;
+	}
+	m_count += 1;
+}
+
+void ChunkGrid::Remove(IntVec2 const& chunkCoords)
+{
+	int cellIndex = GetCellIndex(chunkCoords);
+	ChunkGridCell& cell = m_cells[cellIndex];
+	if (cell.m_chunk != nullptr && cell.m_chunkCoords.x == chunkCoords.x && cell.m_chunkCoords.y == chunkCoords.y)
+	{
+		cell.m_chunk = nullptr;
+		m_count -= 1;
+
+		// Move an overflow chunk that was waiting on this cell into it
+		for (auto overflowChunk = m_overflowChunks.begin(); overflowChunk != m_overflowChunks.end(); ++overflowChunk)
+		{
+			if (GetCellIndex(overflowChunk->first) == cellIndex)
+			{
+				cell.m_chunkCoords = overflowChunk->first;
+				cell.m_chunk = overflowChunk->second;
+				m_overflowChunks.erase(overflowChunk);
+				break;
+			}
+		}
+		return;
+	}
+
+	if (m_overflowChunks.erase(chunkCoords) > 0)
+	{
+		m_count -= 1;
+	}
+}
+
+void ChunkGrid::Clear()
+{
+	for (int cellIndex = 0; cellIndex < CHUNK_GRID_NUM_CELLS; ++cellIndex)
+	{
+		m_cells[cellIndex].m_chunk = nullptr;
+	}
+	m_overflowChunks.clear();
+	m_count = 0;
+}
+
+int ChunkGrid::GetCount() const
+{
+	return m_count;
+}
+
+int ChunkGrid::GetNumOverflowChunks() const
+{
+	return static_cast<int>(m_overflowChunks.size());
+}
+
+int ChunkGrid::GetCellIndex(IntVec2 const& chunkCoords)
+{
+	// Masking wraps negative coords the same way as positive ones
+	return ((chunkCoords.y & CHUNK_GRID_MASK) << CHUNK_GRID_SIZE_BITS) | (chunkCoords.x & CHUNK_GRID_MASK);
+}
+
+ChunkLookupReport ChunkGrid::MeasureLookups(IntVec2 const& centerChunkCoords, int numLookups, unsigned int seed) const
+{
+	ChunkLookupReport report;
+	report.m_numChunks = m_count;
+	report.m_numOverflowChunks = GetNumOverflowChunks();
+	report.m_numLookups = numLookups;
+
+	// The storage the grid replaced, holding the same chunks
+	std::unordered_map<IntVec2, Chunk*> chunkMap;
+	ForEachChunk([&chunkMap](Chunk* chunk) { chunkMap[chunk->m_chunkCoords] = chunk; });
+
+	// Mostly in-window coords, like block and neighbor queries, with some outside it
+	std::vector<IntVec2> lookupCoords(numLookups);
+	int lookupRadius = CHUNK_GRID_SIZE / 2 + 2;
+	for (int lookupIndex = 0; lookupIndex < numLookups; ++lookupIndex)
+	{
+		int offsetX = static_cast<int>(Get2dNoiseUint(lookupIndex, 0, seed) % (2 * lookupRadius + 1)) - lookupRadius;
+		int offsetY = static_cast<int>(Get2dNoiseUint(lookupIndex, 1, seed) % (2 * lookupRadius + 1)) - lookupRadius;
+		lookupCoords[lookupIndex] = IntVec2(centerChunkCoords.x + offsetX, centerChunkCoords.y + offsetY);
+	}
+
+	// Found counts are compared so neither loop can be optimized away
+	int numGridFound = 0;
+	double gridStartTime = GetCurrentTimeSeconds();
+	for (int lookupIndex = 0; lookupIndex < numLookups; ++lookupIndex)
+	{
+		numGridFound += (Find(lookupCoords[lookupIndex]) != nullptr) ? 1 : 0;
+	}
+	report.m_gridLookupSeconds = GetCurrentTimeSeconds() - gridStartTime;
+
+	int numMapFound = 0;
+	double mapStartTime = GetCurrentTimeSeconds();
+	for (int lookupIndex = 0; lookupIndex < numLookups; ++lookupIndex)
+	{
+		numMapFound += (chunkMap.find(lookupCoords[lookupIndex]) != chunkMap.end()) ? 1 : 0;
+	}
+	report.m_mapLookupSeconds = GetCurrentTimeSeconds() - mapStartTime;
+
+	// Full traversal as Render and the mesh queue do it, touching each chunk's vertex count
+	int gridVertexTotal = 0;
+	double gridIterateStartTime = GetCurrentTimeSeconds();
+	ForEachChunk([&gridVertexTotal](Chunk* chunk) { gridVertexTotal += chunk->GetVertexCount(); });
+	report.m_gridIterateSeconds = GetCurrentTimeSeconds() - gridIterateStartTime;
+
+	int mapVertexTotal = 0;
+	double mapIterateStartTime = GetCurrentTimeSeconds();
+	for (auto const& pair : chunkMap)
+	{
+		mapVertexTotal += pair.second->GetVertexCount();
+	}
+	report.m_mapIterateSeconds = GetCurrentTimeSeconds() - mapIterateStartTime;
+
+	if (numGridFound != numMapFound || gridVertexTotal != mapVertexTotal)
+	{
+		report.m_numChunks = -1;
+	}
+	return report;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include "Engine/Math/IntVec2.h"
+#include <unordered_map>
+// -----------------------------------------------------------------------------
+class Chunk;
+// -----------------------------------------------------------------------------
+// Grid side length in chunks, a power of two wide enough for every chunk that
+// can be active around the camera (up to the deactivation range on both sides)
+constexpr int CHUNK_GRID_SIZE_BITS = 5;
+constexpr int CHUNK_GRID_SIZE = 1 << CHUNK_GRID_SIZE_BITS;
+constexpr int CHUNK_GRID_MASK = CHUNK_GRID_SIZE - 1;
+constexpr int CHUNK_GRID_NUM_CELLS = CHUNK_GRID_SIZE * CHUNK_GRID_SIZE;
+static_assert(2 * (CHUNK_DEACTIVATION_RANGE / CHUNK_SIZE_X + 1) + 1 <= CHUNK_GRID_SIZE, "Chunk grid is smaller than the deactivation window");
+// -----------------------------------------------------------------------------
+struct ChunkGridCell
+{
+	IntVec2 m_chunkCoords = IntVec2::ZERO;    // Kept next to the pointer so lookups never touch the chunk itself
+	Chunk*  m_chunk = nullptr;
+};
+// -----------------------------------------------------------------------------
+struct ChunkLookupReport
+{
+	int    m_numChunks = 0;
+	int    m_numOverflowChunks = 0;
+	int    m_numLookups = 0;
+	double m_gridLookupSeconds = 0.0;
+	double m_mapLookupSeconds = 0.0;
+	double m_gridIterateSeconds = 0.0;
+	double m_mapIterateSeconds = 0.0;
+};
+// -----------------------------------------------------------------------------
+// Active chunks stored in a toroidal grid indexed by (chunkX mod size, chunkY mod size).
+// As the camera moves the window wraps around the grid, so no chunk is ever moved.
+// A chunk whose cell is still held by a stale chunk from the other side of the
+// window (deactivation is spread over frames) goes to a small overflow map until
+// the cell frees up.
+// -----------------------------------------------------------------------------
+class ChunkGrid
+{
+public:
+	Chunk* Find(IntVec2 const& chunkCoords) const;
+	bool   Contains(IntVec2 const& chunkCoords) const;
+	void   Insert(Chunk* chunk);
+	void   Remove(IntVec2 const& chunkCoords);
+	void   Clear();
+	int    GetCount() const;
+	int    GetNumOverflowChunks() const;
+
+	// Walks the cells in memory order, then any overflow chunks
+	template <typename ChunkCallback>
+	void ForEachChunk(ChunkCallback const& callback) const
+	{
+		for (int cellIndex = 0; cellIndex < CHUNK_GRID_NUM_CELLS; ++cellIndex)
+		{
+			if (m_cells[cellIndex].m_chunk != nullptr)
+			{
+				callback(m_cells[cellIndex].m_chunk);
+			}
+		}
+		for (auto const& pair : m_overflowChunks)
+		{
+			callback(pair.second);
+		}
+	}
+
+	// Times random lookups and a full iteration against the unordered_map storage this grid replaced
+	ChunkLookupReport MeasureLookups(IntVec2 const& centerChunkCoords, int numLookups, unsigned int seed) const;
+
+	static int GetCellIndex(IntVec2 const& chunkCoords);
+
+private:
+	ChunkGridCell m_cells[CHUNK_GRID_NUM_CELLS];
+	std::unordered_map<IntVec2, Chunk*> m_overflowChunks;
+	int m_count = 0;
+};
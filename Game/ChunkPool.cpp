@@ -0,0 +1,75 @@
+#include "Game/ChunkPool.hpp"
+#include "Game/Chunk.hpp"
+#include "Game/Block.hpp"
+#include <algorithm>
+#include <new>
+
+ChunkPool::~ChunkPool()
+{
+	Clear();
+}
+
+Chunk* ChunkPool::Acquire(IntVec2 const& chunkCoords)
+{
+	m_stats.m_numAcquires += 1;
+	if (m_freeChunks.empty())
+	{
+		m_stats.m_numChunkAllocations += 1;
+		return new Chunk(chunkCoords);
+	}
+
+	// Blocks are cleared to what a freshly allocated array holds, generation and loading expect that
+	FreeChunk freeChunk = m_freeChunks.back();
+	m_freeChunks.pop_back();
+	std::fill(freeChunk.m_blocks, freeChunk.m_blocks + CHUNK_BLOCK_TOTAL, Block());
+	m_stats.m_numReused += 1;
+	return new (freeChunk.m_memory) Chunk(chunkCoords, freeChunk.m_blocks);
+}
+
+void ChunkPool::Release(Chunk* chunk)
+{
+	if (chunk == nullptr)
+	{
+		return;
+	}
+
+	if (static_cast<int>(m_freeChunks.size()) >= CHUNK_POOL_MAX_FREE_CHUNKS)
+	{
+		delete chunk;
+		m_stats.m_numChunksFreed += 1;
+		return;
+	}
+
+	// Destroyed in place so its buffers and vectors go now; the chunk memory and blocks stay for the next acquire
+	FreeChunk freeChunk;
+	freeChunk.m_memory = chunk;
+	freeChunk.m_blocks = chunk->m_blocks;
+	chunk->m_blocks = nullptr;
+	chunk->~Chunk();
+	m_freeChunks.push_back(freeChunk);
+}
+
+void ChunkPool::Clear()
+{
+	for (FreeChunk const& freeChunk : m_freeChunks)
+	{
+		delete[] freeChunk.m_blocks;
+		::operator delete(freeChunk.m_memory);
+	}
+	m_freeChunks.clear();
+}
+
+int ChunkPool::GetNumFreeChunks() const
+{
+	return static_cast<int>(m_freeChunks.size());
+}
+
+int ChunkPool::GetPooledByteCount() const
+{
+	return static_cast<int>(m_freeChunks.size() * (sizeof(Chunk) + sizeof(Block) * CHUNK_BLOCK_TOTAL));
+}
+
+ChunkPoolStats const& ChunkPool::GetStats() const
+{
+	return m_stats;
+}
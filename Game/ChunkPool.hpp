@@ -0,0 +1,46 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include "Engine/Math/IntVec2.h"
+#include <vector>
+// -----------------------------------------------------------------------------
+class Chunk;
+class Block;
+// -----------------------------------------------------------------------------
+// Released chunks kept for reuse beyond this are freed, so a burst of deactivations
+// does not pin memory; the camera streaming steadily only needs a handful
+constexpr int CHUNK_POOL_MAX_FREE_CHUNKS = 64;
+// -----------------------------------------------------------------------------
+struct ChunkPoolStats
+{
+	int m_numAcquires = 0;
+	int m_numReused = 0;                 // Acquires served from the free list
+	int m_numChunkAllocations = 0;       // Chunk objects allocated, each with its block array
+	int m_numChunksFreed = 0;            // Released while the free list was full
+};
+// -----------------------------------------------------------------------------
+// Recycles chunk objects and their block arrays across activations. A released
+// chunk is destroyed in place but keeps its memory and blocks; acquiring it
+// constructs a fresh chunk in the same memory around the cleared blocks.
+// -----------------------------------------------------------------------------
+class ChunkPool
+{
+public:
+	~ChunkPool();
+
+	Chunk* Acquire(IntVec2 const& chunkCoords);
+	void   Release(Chunk* chunk);
+	void   Clear();
+
+	int    GetNumFreeChunks() const;
+	int    GetPooledByteCount() const;
+	ChunkPoolStats const& GetStats() const;
+
+private:
+	struct FreeChunk
+	{
+		void*  m_memory = nullptr;
+		Block* m_blocks = nullptr;
+	};
+	std::vector<FreeChunk> m_freeChunks;
+	ChunkPoolStats m_stats;
+};
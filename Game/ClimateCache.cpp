@@ -0,0 +1,167 @@
+#include "Game/ClimateCache.hpp"
+#include "Game/BatchNoise.hpp"
+#include "Engine/Math/MathUtils.h"
+
+void ClimateRegion::Generate()
+{
+	const int numSamples = CLIMATE_SAMPLES_PER_SIDE * CLIMATE_SAMPLES_PER_SIDE;
+	m_continentalness.resize(numSamples);
+	m_erosion.resize(numSamples);
+	m_peaksValleys.resize(numSamples);
+	m_temperature.resize(numSamples);
+	m_humidity.resize(numSamples);
+
+	int regionGlobalX = m_regionCoords.x * CLIMATE_REGION_SIZE_BLOCKS;
+	int regionGlobalY = m_regionCoords.y * CLIMATE_REGION_SIZE_BLOCKS;
+
+	// Same noise parameters PopulateWithDensityNoise used per block
+	float rowPosX[CLIMATE_SAMPLES_PER_SIDE];
+	float rowPosY[CLIMATE_SAMPLES_PER_SIDE];
+	for (int sampleY = 0; sampleY < CLIMATE_SAMPLES_PER_SIDE; ++sampleY)
+	{
+		int rowStart = sampleY * CLIMATE_SAMPLES_PER_SIDE;
+		for (int sampleX = 0; sampleX < CLIMATE_SAMPLES_PER_SIDE; ++sampleX)
+		{
+			rowPosX[sampleX] = static_cast<float>(regionGlobalX + sampleX * CLIMATE_SAMPLE_STEP);
+			rowPosY[sampleX] = static_cast<float>(regionGlobalY + sampleY * CLIMATE_SAMPLE_STEP);
+		}
+
+		Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &m_continentalness[rowStart], CLIMATE_SAMPLES_PER_SIDE, CONTINENTALNESS_SCALE, BIOME_OCTAVES,
+			DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 100);
+		Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &m_erosion[rowStart], CLIMATE_SAMPLES_PER_SIDE, EROSIION_SCALE, BIOME_OCTAVES,
+			DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 200);
+		Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &m_peaksValleys[rowStart], CLIMATE_SAMPLES_PER_SIDE, PEAKVALLEY_SCALE, BIOME_OCTAVES,
+			DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 300);
+		Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &m_temperature[rowStart], CLIMATE_SAMPLES_PER_SIDE, TEMPERATURE_SCALE, BIOME_OCTAVES,
+			DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 400);
+		Compute2dPerlinNoiseBatch(rowPosX, rowPosY, &m_humidity[rowStart], CLIMATE_SAMPLES_PER_SIDE, HUMIDITY_SCALE, BIOME_OCTAVES,
+			DEFAULT_OCTAVE_PERSISTANCE, DEFAULT_NOISE_OCTAVE_SCALE, true, GAME_SEED + 500);
+	}
+
+	m_chunkCaverns.resize(CLIMATE_REGION_SIZE_CHUNKS * CLIMATE_REGION_SIZE_CHUNKS);
+	for (int regionChunkY = 0; regionChunkY < CLIMATE_REGION_SIZE_CHUNKS; ++regionChunkY)
+	{
+		for (int regionChunkX = 0; regionChunkX < CLIMATE_REGION_SIZE_CHUNKS; ++regionChunkX)
+		{
+			IntVec2 chunkCoords = IntVec2(m_regionCoords.x * CLIMATE_REGION_SIZE_CHUNKS + regionChunkX, m_regionCoords.y * CLIMATE_REGION_SIZE_CHUNKS + regionChunkY);
+			AppendCavernsForChunk(chunkCoords, m_chunkCaverns[regionChunkY * CLIMATE_REGION_SIZE_CHUNKS + regionChunkX]);
+		}
+	}
+}
+
+float ClimateRegion::SampleMap(std::vector<float> const& map, int regionBlockX, int regionBlockY) const
+{
+	int cellX = regionBlockX / CLIMATE_SAMPLE_STEP;
+	int cellY = regionBlockY / CLIMATE_SAMPLE_STEP;
+	float fractionX = static_cast<float>(regionBlockX - cellX * CLIMATE_SAMPLE_STEP) / static_cast<float>(CLIMATE_SAMPLE_STEP);
+	float fractionY = static_cast<float>(regionBlockY - cellY * CLIMATE_SAMPLE_STEP) / static_cast<float>(CLIMATE_SAMPLE_STEP);
+
+	int southWestIndex = cellY * CLIMATE_SAMPLES_PER_SIDE + cellX;
+	int northWestIndex = southWestIndex + CLIMATE_SAMPLES_PER_SIDE;
+
+	float south = Interpolate(map[southWestIndex], map[southWestIndex + 1], fractionX);
+	float north = Interpolate(map[northWestIndex], map[northWestIndex + 1], fractionX);
+	return Interpolate(south, north, fractionY);
+}
+
+// -----------------------------------------------------------------------------
+void ClimateCache::SampleChunkClimate(IntVec2 const& chunkCoords, float* outContinentalness, float* outErosion, float* outPeaksValleys,
+	                                  float* outTemperature, float* outHumidity)
+{
+	IntVec2 regionCoords = GetRegionCoords(chunkCoords);
+	std::shared_ptr<ClimateRegion> region = GetGeneratedRegion(regionCoords);
+
+	int chunkOffsetX = (chunkCoords.x - regionCoords.x * CLIMATE_REGION_SIZE_CHUNKS) * CHUNK_SIZE_X;
+	int chunkOffsetY = (chunkCoords.y - regionCoords.y * CLIMATE_REGION_SIZE_CHUNKS) * CHUNK_SIZE_Y;
+
+	for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+	{
+		for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+		{
+			int chunkIndex = chunkY * CHUNK_SIZE_X + chunkX;
+			int regionBlockX = chunkOffsetX + chunkX;
+			int regionBlockY = chunkOffsetY + chunkY;
+
+			outContinentalness[chunkIndex] = region->SampleMap(region->m_continentalness, regionBlockX, regionBlockY);
+			outErosion[chunkIndex] = region->SampleMap(region->m_erosion, regionBlockX, regionBlockY);
+			outPeaksValleys[chunkIndex] = region->SampleMap(region->m_peaksValleys, regionBlockX, regionBlockY);
+			outTemperature[chunkIndex] = region->SampleMap(region->m_temperature, regionBlockX, regionBlockY);
+			outHumidity[chunkIndex] = region->SampleMap(region->m_humidity, regionBlockX, regionBlockY);
+		}
+	}
+}
+
+void ClimateCache::GetChunkCaverns(IntVec2 const& chunkCoords, std::vector<CavernSphere>& outCaverns)
+{
+	IntVec2 regionCoords = GetRegionCoords(chunkCoords);
+	std::shared_ptr<ClimateRegion> region = GetGeneratedRegion(regionCoords);
+
+	int regionChunkX = chunkCoords.x - regionCoords.x * CLIMATE_REGION_SIZE_CHUNKS;
+	int regionChunkY = chunkCoords.y - regionCoords.y * CLIMATE_REGION_SIZE_CHUNKS;
+	std::vector<CavernSphere> const& chunkCaverns = region->m_chunkCaverns[regionChunkY * CLIMATE_REGION_SIZE_CHUNKS + regionChunkX];
+	outCaverns.insert(outCaverns.end(), chunkCaverns.begin(), chunkCaverns.end());
+}
+
+void ClimateCache::EvictDistantRegions(Vec2 const& cameraPosXY, float evictionRange)
+{
+	float evictionRangeSquared = evictionRange * evictionRange;
+
+	std::lock_guard<std::mutex> lock(m_regionsMutex);
+	for (auto foundRegion = m_regions.begin(); foundRegion != m_regions.end();)
+	{
+		// Distance from the camera to the nearest point of the region
+		IntVec2 const& regionCoords = foundRegion->first;
+		float regionMinX = static_cast<float>(regionCoords.x * CLIMATE_REGION_SIZE_BLOCKS);
+		float regionMinY = static_cast<float>(regionCoords.y * CLIMATE_REGION_SIZE_BLOCKS);
+		float nearestX = GetClamped(cameraPosXY.x, regionMinX, regionMinX + CLIMATE_REGION_SIZE_BLOCKS);
+		float nearestY = GetClamped(cameraPosXY.y, regionMinY, regionMinY + CLIMATE_REGION_SIZE_BLOCKS);
+		float distSquared = GetDistanceSquared2D(cameraPosXY, Vec2(nearestX, nearestY));
+
+		// Jobs still holding the region keep it alive until they finish
+		if (distSquared > evictionRangeSquared)
+		{
+			foundRegion = m_regions.erase(foundRegion);
+		}
+		else
+		{
+			++foundRegion;
+		}
+	}
+}
+
+int ClimateCache::GetNumRegions() const
+{
+	std::lock_guard<std::mutex> lock(m_regionsMutex);
+	return static_cast<int>(m_regions.size());
+}
+
+IntVec2 ClimateCache::GetRegionCoords(IntVec2 const& chunkCoords)
+{
+	// Floor division so negative chunk coords land in the correct region
+	int regionX = (chunkCoords.x >= 0) ? (chunkCoords.x / CLIMATE_REGION_SIZE_CHUNKS) : ((chunkCoords.x + 1) / CLIMATE_REGION_SIZE_CHUNKS - 1);
+	int regionY = (chunkCoords.y >= 0) ? (chunkCoords.y / CLIMATE_REGION_SIZE_CHUNKS) : ((chunkCoords.y + 1) / CLIMATE_REGION_SIZE_CHUNKS - 1);
+	return IntVec2(regionX, regionY);
+}
+
+std::shared_ptr<ClimateRegion> ClimateCache::GetOrCreateRegion(IntVec2 const& regionCoords)
+{
+	std::lock_guard<std::mutex> lock(m_regionsMutex);
+	auto foundRegion = m_regions.find(regionCoords);
+	if (foundRegion != m_regions.end())
+	{
+		return foundRegion->second;
+	}
+
+	std::shared_ptr<ClimateRegion> region = std::make_shared<ClimateRegion>(regionCoords);
+	m_regions[regionCoords] = region;
+	return region;
+}
+
+std::shared_ptr<ClimateRegion> ClimateCache::GetGeneratedRegion(IntVec2 const& regionCoords)
+{
+	std::shared_ptr<ClimateRegion> region = GetOrCreateRegion(regionCoords);
+
+	// First job to reach a region generates it, any others in the same region wait here
+	std::call_once(region->m_generateOnce, [&region]() { region->Generate(); });
+	return region;
+}
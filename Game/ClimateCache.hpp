@@ -0,0 +1,58 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include "Engine/Math/IntVec2.h"
+#include <memory>
+#include <mutex>
+// -----------------------------------------------------------------------------
+// Low-frequency climate fields for one region of CLIMATE_REGION_SIZE_CHUNKS^2
+// chunks, sampled every CLIMATE_SAMPLE_STEP blocks (including the far edge so
+// neighboring regions agree on their shared border).
+// -----------------------------------------------------------------------------
+class ClimateRegion
+{
+public:
+	ClimateRegion(IntVec2 const& regionCoords) : m_regionCoords(regionCoords) {}
+
+	void  Generate();
+	float SampleMap(std::vector<float> const& map, int regionBlockX, int regionBlockY) const;
+
+public:
+	IntVec2 m_regionCoords = IntVec2::ZERO;
+	std::once_flag m_generateOnce;
+
+	std::vector<float> m_continentalness;
+	std::vector<float> m_erosion;
+	std::vector<float> m_peaksValleys;
+	std::vector<float> m_temperature;
+	std::vector<float> m_humidity;
+
+	// Sparse cavern list for the region's chunks, indexed by the chunk's position in the region
+	std::vector<std::vector<CavernSphere>> m_chunkCaverns;
+};
+// -----------------------------------------------------------------------------
+// Thread-safe cache of climate regions, shared by every GenerateChunkJob.
+// Regions are generated once by whichever job asks first; the main thread
+// evicts regions that fall outside CLIMATE_EVICTION_RANGE of the camera.
+// -----------------------------------------------------------------------------
+class ClimateCache
+{
+public:
+	// Each output map is CHUNK_SIZE_X * CHUNK_SIZE_Y floats, indexed chunkY * CHUNK_SIZE_X + chunkX
+	void SampleChunkClimate(IntVec2 const& chunkCoords, float* outContinentalness, float* outErosion, float* outPeaksValleys,
+		                    float* outTemperature, float* outHumidity);
+
+	void GetChunkCaverns(IntVec2 const& chunkCoords, std::vector<CavernSphere>& outCaverns);
+
+	void EvictDistantRegions(Vec2 const& cameraPosXY, float evictionRange);
+	int  GetNumRegions() const;
+
+	static IntVec2 GetRegionCoords(IntVec2 const& chunkCoords);
+
+private:
+	std::shared_ptr<ClimateRegion> GetOrCreateRegion(IntVec2 const& regionCoords);
+	std::shared_ptr<ClimateRegion> GetGeneratedRegion(IntVec2 const& regionCoords);
+
+private:
+	mutable std::mutex m_regionsMutex;
+	std::unordered_map<IntVec2, std::shared_ptr<ClimateRegion>> m_regions;
+};
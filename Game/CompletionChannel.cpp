@@ -0,0 +1,196 @@
+#include "Game/CompletionChannel.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Time.hpp"
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// -----------------------------------------------------------------------------
+// Stand-ins for the chunk job types, so the old path pays the same dynamic_cast chain
+class MeasureLoadJob : public Job { public: virtual void Execute() override {} };
+class MeasureSaveJob : public Job { public: virtual void Execute() override {} };
+class MeasureMeshJob : public Job { public: virtual void Execute() override {} };
+class MeasureGenerateJob : public Job
+{
+public:
+	virtual void Execute() override {}
+	int m_value = 0;
+};
+// -----------------------------------------------------------------------------
+// Stand-in for ChunkJob, reused through free lists picked by its type tag
+class MeasureChunkJob : public Job
+{
+public:
+	virtual void Execute() override {}
+	int m_chunkJobType = 0;
+};
+static int const NUM_MEASURE_CHUNK_JOB_TYPES = 4;
+// -----------------------------------------------------------------------------
+CompletionChannelReport MeasureCompletionChannel(int numProducerThreads, int numCompletions)
+{
+	CompletionChannelReport report;
+	report.m_numProducerThreads = numProducerThreads;
+	report.m_numCompletions = numCompletions;
+	int completionsPerThread = numCompletions / numProducerThreads;
+	int numPushed = completionsPerThread * numProducerThreads;
+
+	// World path: every completion pushes its result into the channel, then hands its reused job to the
+	// job system's locked completed queue. The main thread pops those one at a time onto free lists by
+	// type tag, and drains the channel in bulk. Jobs are allocated before timing, as the free lists are
+	// warm once the world is running
+	{
+		CompletionChannel<int> channel(4096);
+		std::mutex completedMutex;
+		std::deque<Job*> completedJobs;
+		std::vector<MeasureChunkJob> jobs(numPushed);
+		std::vector<MeasureChunkJob*> freeJobs[NUM_MEASURE_CHUNK_JOB_TYPES];
+		for (int jobIndex = 0; jobIndex < numPushed; ++jobIndex)
+		{
+			jobs[jobIndex].m_chunkJobType = jobIndex % NUM_MEASURE_CHUNK_JOB_TYPES;
+		}
+		for (std::vector<MeasureChunkJob*>& freeJobsOfType : freeJobs)
+		{
+			freeJobsOfType.reserve(numPushed);
+		}
+		std::vector<int> drained;
+		drained.reserve(channel.GetCapacity());
+		long long drainedSum = 0;
+		int numDrained = 0;
+		int numRecycled = 0;
+
+		double startTime = GetCurrentTimeSeconds();
+		std::vector<std::thread> producers;
+		for (int threadIndex = 0; threadIndex < numProducerThreads; ++threadIndex)
+		{
+			MeasureChunkJob* threadJobs = jobs.data() + threadIndex * completionsPerThread;
+			producers.emplace_back([&channel, &completedMutex, &completedJobs, threadJobs, completionsPerThread]()
+			{
+				for (int completionIndex = 0; completionIndex < completionsPerThread; ++completionIndex)
+				{
+					int value = completionIndex;
+					while (!channel.Push(std::move(value)))
+					{
+						std::this_thread::yield();
+					}
+					std::lock_guard<std::mutex> lock(completedMutex);
+					completedJobs.push_back(&threadJobs[completionIndex]);
+				}
+			});
+		}
+		while (numDrained < numPushed || numRecycled < numPushed)
+		{
+			int numProcessed = 0;
+			for (;;)
+			{
+				Job* completedJob = nullptr;
+				{
+					std::lock_guard<std::mutex> lock(completedMutex);
+					if (!completedJobs.empty())
+					{
+						completedJob = completedJobs.front();
+						completedJobs.pop_front();
+					}
+				}
+				if (completedJob == nullptr)
+				{
+					break;
+				}
+				MeasureChunkJob* chunkJob = static_cast<MeasureChunkJob*>(completedJob);
+				freeJobs[chunkJob->m_chunkJobType].push_back(chunkJob);
+				numRecycled += 1;
+				numProcessed += 1;
+			}
+
+			drained.clear();
+			numProcessed += channel.DrainInto(drained);
+			numDrained += static_cast<int>(drained.size());
+			for (int value : drained)
+			{
+				drainedSum += value;
+			}
+			if (numProcessed == 0)
+			{
+				std::this_thread::yield();
+			}
+		}
+		for (std::thread& producer : producers)
+		{
+			producer.join();
+		}
+		report.m_worldPathSeconds = GetCurrentTimeSeconds() - startTime;
+
+		long long expectedSum = static_cast<long long>(numProducerThreads) * completionsPerThread * (completionsPerThread - 1) / 2;
+		report.m_numMismatchedPaths += (drainedSum == expectedSum && numRecycled == numPushed) ? 0 : 1;
+	}
+
+	// Old path: a new job per completion into a locked queue, popped, identified and deleted one at a time
+	{
+		std::mutex completedMutex;
+		std::deque<Job*> completedJobs;
+		long long drainedSum = 0;
+		int numDrained = 0;
+
+		double startTime = GetCurrentTimeSeconds();
+		std::vector<std::thread> producers;
+		for (int threadIndex = 0; threadIndex < numProducerThreads; ++threadIndex)
+		{
+			producers.emplace_back([&completedMutex, &completedJobs, completionsPerThread]()
+			{
+				for (int completionIndex = 0; completionIndex < completionsPerThread; ++completionIndex)
+				{
+					MeasureGenerateJob* job = new MeasureGenerateJob();
+					job->m_value = completionIndex;
+					std::lock_guard<std::mutex> lock(completedMutex);
+					completedJobs.push_back(job);
+				}
+			});
+		}
+		while (numDrained < numPushed)
+		{
+			Job* completedJob = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(completedMutex);
+				if (!completedJobs.empty())
+				{
+					completedJob = completedJobs.front();
+					completedJobs.pop_front();
+				}
+			}
+			if (completedJob == nullptr)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			if (MeasureLoadJob* loadJob = dynamic_cast<MeasureLoadJob*>(completedJob))
+			{
+				delete loadJob;
+			}
+			else if (MeasureSaveJob* saveJob = dynamic_cast<MeasureSaveJob*>(completedJob))
+			{
+				delete saveJob;
+			}
+			else if (MeasureMeshJob* meshJob = dynamic_cast<MeasureMeshJob*>(completedJob))
+			{
+				delete meshJob;
+			}
+			else if (MeasureGenerateJob* generateJob = dynamic_cast<MeasureGenerateJob*>(completedJob))
+			{
+				drainedSum += generateJob->m_value;
+				delete generateJob;
+			}
+			numDrained += 1;
+		}
+		for (std::thread& producer : producers)
+		{
+			producer.join();
+		}
+		report.m_jobQueueSeconds = GetCurrentTimeSeconds() - startTime;
+
+		long long expectedSum = static_cast<long long>(numProducerThreads) * completionsPerThread * (completionsPerThread - 1) / 2;
+		report.m_numMismatchedPaths += (drainedSum == expectedSum) ? 0 : 1;
+	}
+
+	report.m_numCompletions = numPushed;
+	return report;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+// -----------------------------------------------------------------------------
+struct CompletionChannelReport
+{
+	int    m_numProducerThreads = 0;
+	int    m_numCompletions = 0;
+	int    m_numMismatchedPaths = 0;      // Paths whose drained values do not add up to what was pushed
+	double m_worldPathSeconds = 0.0;      // Results through a typed channel, reused jobs back through a locked queue, as World does
+	double m_jobQueueSeconds = 0.0;       // Heap jobs through a locked queue, one pop and dynamic_cast chain each
+};
+// -----------------------------------------------------------------------------
+// Bounded lock-free queue carrying job results from worker threads to the main
+// thread. Any number of workers push; only the main thread drains. Every slot
+// has a sequence number saying whether it is free for the push at its position
+// or holds the value for the drain at its position, so neither side locks.
+// Capacity must cover every job that can be in flight, so a push never fails.
+// -----------------------------------------------------------------------------
+template <typename ResultType>
+class CompletionChannel
+{
+public:
+	explicit CompletionChannel(int minCapacity)
+	{
+		m_capacity = 1;
+		while (m_capacity < minCapacity)
+		{
+			m_capacity <<= 1;
+		}
+		m_slots = std::make_unique<Slot[]>(m_capacity);
+		for (int slotIndex = 0; slotIndex < m_capacity; ++slotIndex)
+		{
+			m_slots[slotIndex].m_sequence.store(static_cast<uint64_t>(slotIndex), std::memory_order_relaxed);
+		}
+	}
+
+	// [any thread] False only when the channel is full
+	bool Push(ResultType&& result)
+	{
+		uint64_t position = m_pushPosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot& slot = m_slots[position & static_cast<uint64_t>(m_capacity - 1)];
+			uint64_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+			int64_t sequenceOffset = static_cast<int64_t>(sequence - position);
+			if (sequenceOffset == 0)
+			{
+				// Claim the position; on failure another producer took it and position now holds the latest
+				if (m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					slot.m_value = std::move(result);
+					slot.m_sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (sequenceOffset < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_pushPosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// [main thread] Appends every result pushed so far and returns how many
+	int DrainInto(std::vector<ResultType>& outResults)
+	{
+		int numDrained = 0;
+		for (;;)
+		{
+			Slot& slot = m_slots[m_drainPosition & static_cast<uint64_t>(m_capacity - 1)];
+			if (slot.m_sequence.load(std::memory_order_acquire) != m_drainPosition + 1)
+			{
+				return numDrained;
+			}
+			outResults.push_back(std::move(slot.m_value));
+			slot.m_sequence.store(m_drainPosition + static_cast<uint64_t>(m_capacity), std::memory_order_release);
+			m_drainPosition += 1;
+			numDrained += 1;
+		}
+	}
+
+	int GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> m_sequence;
+		ResultType m_value;
+	};
+	std::unique_ptr<Slot[]> m_slots;
+	int m_capacity = 0;
+	alignas(64) std::atomic<uint64_t> m_pushPosition = 0;
+	alignas(64) uint64_t m_drainPosition = 0;
+};
+// -----------------------------------------------------------------------------
+// Times a burst of completions from producer threads along the path World takes against
+// the heap-allocated job path it replaced, per completion
+CompletionChannelReport MeasureCompletionChannel(int numProducerThreads, int numCompletions);
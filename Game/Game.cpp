@@ -4,6 +4,7 @@
 #include "Game/Player.hpp"
 #include "Game/World.hpp"
 #include "Game/BlockDefinition.hpp"
+#include "Game/ClimateCache.hpp"
 
 #include "Engine/Input/InputSystem.h"
 #include "Engine/Renderer/Renderer.h"
@@ -41,14 +42,14 @@ void Game::StartUp()
 	m_spriteImage = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/SpriteSheet_Classic_Faithful_32x.png");
 	m_spriteSheet = new SpriteSheet(*m_spriteImage, IntVec2::GRID8X8);
 
-	// Get world shader
-	m_worldShader = g_theRenderer->CreateOrGetShader("Data/Shaders/WorldShader", VertexType::VERTEX_PCUTBN);
+	// Get world shader; each ChunkVertex is one R32G32_UINT element, see WorldShader.hlsl
+	m_worldShader = g_theRenderer->CreateOrGetShader("Data/Shaders/WorldShader", VertexType::VERTEX_UINT2);
 	m_world_CBO = g_theRenderer->CreateConstantBuffer(sizeof(WorldConstants));
 
 	// Initialize Block Definitions (may change to World)
 	BlockDefinition::InitializeBlockDefinitions();
 	InitializeContinentCurves();
-	BuildTreeStamps();
+	InitializeWorldGenSettings();
 	InitializeInventoryBar();
 
 	// Create and push back the entities
@@ -72,6 +73,7 @@ void Game::DevConsoleControls()
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "F2    - Toggle debug draw");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "F3    - Toggle job debug text");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "F4    - Toggle collision debug raycasts");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "F6    - Report generation and meshing checks for current chunk");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "F8    - Reload game");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "C     - Switch camera mode");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "LMB   - Dig block");
@@ -87,16 +89,27 @@ void Game::DevConsoleControls()
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "X     - Empty selected inventory slot");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "Z     - Empty all inventory slots");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "K     - Toggle lighting color, for cave viewing");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "G     - Toggle greedy meshing");
 	g_theDevConsole->AddLine(Rgba8::SEAWEED, "----------------------------------------------------------------------");
 }
 
 void Game::InitializeContinentCurves()
 {
-	std::vector<Vec2> heightOffsetPoints = {Vec2(-1.0f, -0.3f), Vec2(-0.4f, -0.2f), Vec2(0.4f, 0.4f), Vec2(1.0f, 0.6f)};
-	m_continentHeightOffsetCurve = new Spline(heightOffsetPoints);
+	m_continentHeightOffsetCurve = CreateContinentHeightOffsetCurve();
+	m_continentSquashCurve = CreateContinentSquashCurve();
+}
+
+void Game::InitializeWorldGenSettings()
+{
+	m_worldGenSettings.m_continentHeightOffsetCurve = m_continentHeightOffsetCurve;
+	m_worldGenSettings.m_continentSquashCurve = m_continentSquashCurve;
+	// Interpolated climate moves a small share of biome borders, so the cache is opt-in
+	if (g_gameConfigBlackboard.GetValue("useClimateCache", false))
+	{
+		m_worldGenSettings.m_climateCache = new ClimateCache();
+	}
 
-	std::vector<Vec2> squashPoints = { Vec2(-1.0f, 0.0f), Vec2(-0.25f, 0.2f), Vec2(0.25f, 0.8f), Vec2(1.0f, 0.0f) };
-	m_continentSquashCurve = new Spline(squashPoints);
+	ReadWorldGenSettingsFromConfig(m_worldGenSettings);
 }
 
 void Game::Update()
@@ -128,7 +141,7 @@ void Game::Render() const
 	if (m_isAttractMode == false)
 	{
 		g_theRenderer->BeginCamera(m_gameCamera->GetRenderCamera());
-		g_theGame->SetWorldConstants();
+		g_theGame->UpdateWorldConstants();
 		g_theRenderer->ClearScreen(m_skyColor);
 		m_player->Render();
 		m_currentWorld->Render();
@@ -162,12 +175,20 @@ void Game::Shutdown()
 	m_continentHeightOffsetCurve = nullptr;
 	delete m_continentSquashCurve;
 	m_continentSquashCurve = nullptr;
+	m_worldGenSettings.m_continentHeightOffsetCurve = nullptr;
+	m_worldGenSettings.m_continentSquashCurve = nullptr;
+	delete m_worldGenSettings.m_climateCache;
+	m_worldGenSettings.m_climateCache = nullptr;
 
 	// Clear any remaining completed jobs
 	while (Job* completedJob = g_theJobSystem->RetreiveCompletedJob())
 	{
 		delete completedJob;
 	}
+	while (Job* completedJob = g_theIOJobSystem->RetreiveCompletedJob())
+	{
+		delete completedJob;
+	}
 
 	delete m_world_CBO;
 	m_world_CBO = nullptr;
@@ -495,9 +516,9 @@ void Game::InitializeInventoryBar()
 	AddVertsForLineSegment2D(m_inventoryQuadVerts, Vec2(1190.f, 8.5f), Vec2(1190.f, 61.5f), 4.f, Rgba8::SLATEGRAY);
 }
 
-void Game::SetWorldConstants()
+void Game::UpdateWorldConstants()
 {
-	WorldConstants worldConstants;
+	WorldConstants& worldConstants = m_worldConstants;
 	worldConstants.CameraPosition = Vec4(m_player->GetPlayerPosition(), 1.f);
 	worldConstants.FogFarDistance = CHUNK_ACTIVATION_RANGE;
 	worldConstants.FogNearDistance = worldConstants.FogFarDistance * 0.5f;
@@ -556,7 +577,4 @@ void Game::SetWorldConstants()
 	worldConstants.IndoorLightColor = indoorLightColorAsVec4;
 	worldConstants.OutdoorLightColor = outdoorLightColor;
 	worldConstants.SkyColor = skyColor;
-
-	g_theRenderer->CopyCPUToGPU((void*)&worldConstants, sizeof(worldConstants), m_world_CBO);
-	g_theRenderer->BindConstantBuffer(4, m_world_CBO);
 }
@@ -24,6 +24,7 @@ public:
 	void StartUp();
 	void DevConsoleControls();
 	void InitializeContinentCurves();
+	void InitializeWorldGenSettings();
 
 	void Update();
 	void UpdateCameras();
@@ -40,7 +41,7 @@ public:
 	void RenderInventoryBar() const;
 
 	void InitializeInventoryBar();
-	void SetWorldConstants();
+	void UpdateWorldConstants();
 
 	void Shutdown();
 	void DestroyWorldAndPlayer();
@@ -72,8 +73,12 @@ public:
 	Spline* m_continentHeightOffsetCurve = nullptr;
 	Spline* m_continentSquashCurve = nullptr;
 
+	// Settings handed to every chunk generation job
+	WorldGenSettings m_worldGenSettings;
+
 	Shader* m_worldShader = nullptr;
 	ConstantBuffer* m_world_CBO = nullptr;
+	WorldConstants m_worldConstants;    // Computed once per frame, uploaded by World::Render
 
 	GameCamera* m_gameCamera = nullptr;
 	Rgba8 m_skyColor = Rgba8::WHITE;
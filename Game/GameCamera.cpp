@@ -14,7 +14,7 @@ GameCamera::GameCamera(Game* owner, Vec3 const& position)
 	Mat44 cameraToRender(Vec3::ZAXE, -Vec3::XAXE, Vec3::YAXE, Vec3::ZERO);
 	m_renderCamera.SetCameraToRenderTransform(cameraToRender);
 
-	m_renderCamera.SetPerspectiveView(2.f, 60.f, 0.01f, 10000.f);
+	m_renderCamera.SetPerspectiveView(GAME_CAMERA_ASPECT, GAME_CAMERA_FOV_DEGREES, GAME_CAMERA_NEAR_DIST, GAME_CAMERA_FAR_DIST);
 }
 
 GameCamera::~GameCamera()
@@ -2,253 +2,72 @@
 #include "Engine/Math/Vec3.h"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Math/Vec2.hpp"
-#include "Engine/Core/Vertex_PCU.h"
-#include "Engine/Renderer/Renderer.h"
+#include "Engine/Math/RawNoise.hpp"
+#include "Engine/Math/Splines.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 
-std::unordered_map<std::string, TreeStamp> g_treeStamps;
-
-void BuildTreeStamps()
+void AppendCavernsForChunk(IntVec2 const& chunkCoords, std::vector<CavernSphere>& outCaverns)
 {
-	g_treeStamps["oak_small"] = MakeSmallOakTree();
-	g_treeStamps["oak_large"] = MakeLargeOakTree();
-	g_treeStamps["spruce"] = MakeSpruceTree();
-	g_treeStamps["birch"] = MakeBirchTree();
-	g_treeStamps["acacia"] = MakeAcaciaTree();
-	g_treeStamps["jungle"] = MakeJungleTree();
-	g_treeStamps["cactus"] = MakeCactus();
-	g_treeStamps["snowy_spruce"] = MakeSnowySpruceTree();
-}
-
-TreeStamp MakeSmallOakTree()
-{
-	TreeStamp stamp;
-	int trunkHeight = 4;
-
-	// Trunk
-	for (int trunkZ = 0; trunkZ < trunkHeight; ++trunkZ)
+	// At most one cavern per chunk-sized cell, placed so the sphere stays inside the cell
+	for (int cellZ = 0; cellZ < CAVERN_MAX_Z / CAVERN_CELL_SIZE_Z; ++cellZ)
 	{
-		stamp.blocks.emplace_back(IntVec3(0, 0, trunkZ), BLOCKTYPE_OAKLOG);
-	}
-
-	// Leaves
-	for (int leafZ = trunkHeight - 2; leafZ <= trunkHeight + 2; ++leafZ)
-	{
-		int radius = 2 - abs(leafZ - trunkHeight);
-		for (int leafY = -radius; leafY <= radius; ++leafY)
+		if (Get3dNoiseZeroToOne(chunkCoords.x, chunkCoords.y, cellZ, GAME_SEED + 1234) >= CAVERN_CHANCE)
 		{
-			for (int leafX = -radius; leafX <= radius; ++leafX)
-			{
-				if (leafX * leafX + leafY * leafY + (leafZ - trunkHeight) * (leafZ - trunkHeight) < 3)
-				{
-					stamp.blocks.emplace_back(IntVec3(leafX, leafY, leafZ), BLOCKTYPE_OAKLEAVES);
-				}
-			}
+			continue;
 		}
-	}
 
-	stamp.radius = 2;
-	return stamp;
-}
-
-TreeStamp MakeLargeOakTree()
-{
-	TreeStamp stamp;
-	int trunkHeight = 7;
-
-	// Trunk
-	for (int trunkZ = 0; trunkZ < trunkHeight; ++trunkZ)
-	{
-		stamp.blocks.emplace_back(IntVec3(0, 0, trunkZ), BLOCKTYPE_OAKLOG);
-	}
-
-	// Leaves
-	for (int leafZ = trunkHeight - 2; leafZ <= trunkHeight + 2; ++leafZ)
-	{
-		int radius = 2 - abs(leafZ - trunkHeight);
-		for (int leafY = -radius; leafY <= radius; ++leafY)
-		{
-			for (int leafX = -radius; leafX <= radius; ++leafX)
-			{
-				if (leafX * leafX + leafY * leafY + (leafZ - trunkHeight) * (leafZ - trunkHeight) < 27.5)
-				{
-					stamp.blocks.emplace_back(IntVec3(leafX, leafY, leafZ), BLOCKTYPE_OAKLEAVES);
-				}
-			}
-		}
+		float radius = Interpolate(CAVERN_MIN_RADIUS, CAVERN_MAX_RADIUS, Get3dNoiseZeroToOne(chunkCoords.x, chunkCoords.y, cellZ, GAME_SEED + 1235));
+		float cellMinX = static_cast<float>(chunkCoords.x * CHUNK_SIZE_X);
+		float cellMinY = static_cast<float>(chunkCoords.y * CHUNK_SIZE_Y);
+		float cellMinZ = static_cast<float>(cellZ * CAVERN_CELL_SIZE_Z);
+
+		CavernSphere cavern;
+		cavern.m_radius = radius;
+		cavern.m_center.x = cellMinX + radius + Get3dNoiseZeroToOne(chunkCoords.x, chunkCoords.y, cellZ, GAME_SEED + 1236) * (CHUNK_SIZE_X - 2.f * radius);
+		cavern.m_center.y = cellMinY + radius + Get3dNoiseZeroToOne(chunkCoords.x, chunkCoords.y, cellZ, GAME_SEED + 1237) * (CHUNK_SIZE_Y - 2.f * radius);
+		cavern.m_center.z = cellMinZ + radius + Get3dNoiseZeroToOne(chunkCoords.x, chunkCoords.y, cellZ, GAME_SEED + 1238) * (CAVERN_CELL_SIZE_Z - 2.f * radius);
+		outCaverns.push_back(cavern);
 	}
-
-	stamp.radius = 2;
-	return stamp;
 }
 
-TreeStamp MakeSpruceTree()
+Spline* CreateContinentHeightOffsetCurve()
 {
-	TreeStamp stamp;
-	int trunkHeight = 7;
-
-	// Trunk
-	for (int trunkZ = 0; trunkZ < trunkHeight; ++trunkZ)
-	{
-		stamp.blocks.emplace_back(IntVec3(0, 0, trunkZ), BLOCKTYPE_SPRUCELOG);
-	}
-
-	// Leaves
-	for (int leafZ = trunkHeight - 2; leafZ <= trunkHeight + 2; ++leafZ)
-	{
-		int radius = 2 - abs(leafZ - trunkHeight);
-		for (int leafY = -radius; leafY <= radius; ++leafY)
-		{
-			for (int leafX = -radius; leafX <= radius; ++leafX)
-			{
-				if (leafX * leafX + leafY * leafY + (leafZ - trunkHeight) * (leafZ - trunkHeight) < 5)
-				{
-					stamp.blocks.emplace_back(IntVec3(leafX, leafY, leafZ), BLOCKTYPE_SPRUCELEAVES);
-				}
-			}
-		}
-	}
-
-	stamp.radius = 2;
-	return stamp;
+	std::vector<Vec2> heightOffsetPoints = {Vec2(-1.0f, -0.3f), Vec2(-0.4f, -0.2f), Vec2(0.4f, 0.4f), Vec2(1.0f, 0.6f)};
+	return new Spline(heightOffsetPoints);
 }
 
-TreeStamp MakeAcaciaTree()
+Spline* CreateContinentSquashCurve()
 {
-	TreeStamp stamp;
-	int trunkHeight = 7;
-
-	// Trunk
-	for (int trunkZ = 0; trunkZ < trunkHeight; ++trunkZ)
-	{
-		stamp.blocks.emplace_back(IntVec3(0, 0, trunkZ), BLOCKTYPE_ACACIALOG);
-	}
-
-	// Leaves
-	for (int leafZ = trunkHeight; leafZ <= trunkHeight + 2; ++leafZ)
-	{
-		int radius = 2 - abs(leafZ - trunkHeight);
-		for (int leafY = -radius; leafY <= radius; ++leafY)
-		{
-			for (int leafX = -radius; leafX <= radius; ++leafX)
-			{
-				if (leafX * leafX + leafY * leafY + (leafZ - trunkHeight) * (leafZ - trunkHeight) < 6)
-				{
-					stamp.blocks.emplace_back(IntVec3(leafX, leafY, leafZ), BLOCKTYPE_ACACIALEAVES);
-				}
-			}
-		}
-	}
-
-	stamp.radius = 2;
-	return stamp;
-}
-
-TreeStamp MakeBirchTree()
-{
-	TreeStamp stamp;
-	int trunkHeight = 7;
-
-	// Trunk
-	for (int trunkZ = 0; trunkZ < trunkHeight; ++trunkZ)
-	{
-		stamp.blocks.emplace_back(IntVec3(0, 0, trunkZ), BLOCKTYPE_BIRCHLOG);
-	}
-
-	// Leaves
-	for (int leafZ = trunkHeight - 2; leafZ <= trunkHeight + 2; ++leafZ)
-	{
-		int radius = 2 - abs(leafZ - trunkHeight);
-		for (int leafY = -radius; leafY <= radius; ++leafY)
-		{
-			for (int leafX = -radius; leafX <= radius; ++leafX)
-			{
-				if (leafX * leafX + leafY * leafY + (leafZ - trunkHeight) * (leafZ - trunkHeight) < 6)
-				{
-					stamp.blocks.emplace_back(IntVec3(leafX, leafY, leafZ), BLOCKTYPE_BIRCHLEAVES);
-				}
-			}
-		}
-	}
-
-	stamp.radius = 2;
-	return stamp;
+	std::vector<Vec2> squashPoints = { Vec2(-1.0f, 0.0f), Vec2(-0.25f, 0.2f), Vec2(0.25f, 0.8f), Vec2(1.0f, 0.0f) };
+	return new Spline(squashPoints);
 }
 
-TreeStamp MakeJungleTree()
+void ReadWorldGenSettingsFromConfig(WorldGenSettings& outSettings)
 {
-	TreeStamp stamp;
-	int trunkHeight = 7;
+	std::string densityMode = g_gameConfigBlackboard.GetValue("densityMode", "PerBlock");
+	outSettings.m_densityMode = (densityMode == "Lattice") ? DensitySampleMode::LATTICE : DensitySampleMode::PER_BLOCK;
 
-	// Trunk
-	for (int trunkZ = 0; trunkZ < trunkHeight; ++trunkZ)
+	// Lattice steps must evenly divide the chunk so that neighboring chunks share lattice points
+	int stepXY = g_gameConfigBlackboard.GetValue("densityLatticeStepXY", DENSITY_LATTICE_STEP_XY);
+	int stepZ  = g_gameConfigBlackboard.GetValue("densityLatticeStepZ", DENSITY_LATTICE_STEP_Z);
+	if (stepXY <= 0 || (stepXY & (stepXY - 1)) != 0 || stepXY > CHUNK_SIZE_X)
 	{
-		stamp.blocks.emplace_back(IntVec3(0, 0, trunkZ), BLOCKTYPE_JUNGLELOG);
+		DebuggerPrintf("Invalid densityLatticeStepXY %d, using %d\n", stepXY, DENSITY_LATTICE_STEP_XY);
+		stepXY = DENSITY_LATTICE_STEP_XY;
 	}
-
-	// Leaves
-	for (int leafZ = trunkHeight - 2; leafZ <= trunkHeight + 2; ++leafZ)
+	if (stepZ <= 0 || (stepZ & (stepZ - 1)) != 0 || stepZ > CHUNK_SIZE_Z)
 	{
-		int radius = 2 - abs(leafZ - trunkHeight);
-		for (int leafY = -radius; leafY <= radius; ++leafY)
-		{
-			for (int leafX = -radius; leafX <= radius; ++leafX)
-			{
-				if (leafX * leafX + leafY * leafY + (leafZ - trunkHeight) * (leafZ - trunkHeight) < 6)
-				{
-					stamp.blocks.emplace_back(IntVec3(leafX, leafY, leafZ), BLOCKTYPE_JUNGLELEAVES);
-				}
-			}
-		}
+		DebuggerPrintf("Invalid densityLatticeStepZ %d, using %d\n", stepZ, DENSITY_LATTICE_STEP_Z);
+		stepZ = DENSITY_LATTICE_STEP_Z;
 	}
+	outSettings.m_densityLatticeStepXY = stepXY;
+	outSettings.m_densityLatticeStepZ = stepZ;
 
-	stamp.radius = 2;
-	return stamp;
-}
-
-TreeStamp MakeCactus()
-{
-	TreeStamp stamp;
-	int trunkHeight = 3;
-
-	// Trunk
-	for (int trunkZ = 0; trunkZ < trunkHeight; ++trunkZ)
-	{
-		stamp.blocks.emplace_back(IntVec3(0, 0, trunkZ), BLOCKTYPE_CACTUS);
-	}
-
-	stamp.radius = 1;
-	return stamp;
-}
-
-TreeStamp MakeSnowySpruceTree()
-{
-	TreeStamp stamp;
-	int trunkHeight = 7;
-
-	// Trunk
-	for (int trunkZ = 0; trunkZ < trunkHeight; ++trunkZ)
-	{
-		stamp.blocks.emplace_back(IntVec3(0, 0, trunkZ), BLOCKTYPE_SPRUCELOG);
-	}
-
-	// Leaves
-	for (int leafZ = trunkHeight - 2; leafZ <= trunkHeight + 2; ++leafZ)
-	{
-		int radius = 2 - abs(leafZ - trunkHeight);
-		for (int leafY = -radius; leafY <= radius; ++leafY)
-		{
-			for (int leafX = -radius; leafX <= radius; ++leafX)
-			{
-				if (leafX * leafX + leafY * leafY + (leafZ - trunkHeight) * (leafZ - trunkHeight) < 8)
-				{
-					stamp.blocks.emplace_back(IntVec3(leafX, leafY, leafZ), BLOCKTYPE_SPRUCELEAVESSNOW);
-				}
-			}
-		}
-	}
+	outSettings.m_useColumnBounds = g_gameConfigBlackboard.GetValue("useColumnBounds", true);
 
-	stamp.radius = 2;
-	return stamp;
+	std::string oreMode = g_gameConfigBlackboard.GetValue("oreMode", "PerBlock");
+	outSettings.m_oreMode = (oreMode == "CoarseGrid") ? OrePlacementMode::COARSE_GRID : OrePlacementMode::PER_BLOCK;
 }
 
 Vec3 ComputeRayStep(Vec3 const& direction)
@@ -1,4 +1,5 @@
 #pragma once
+#include "Engine/Math/IntVec2.h"
 #include "Engine/Math/IntVec3.hpp"
 #include "Engine/Math/Vec3.h"
 #include "Engine/Math/RandomNumberGenerator.h"
@@ -15,9 +16,23 @@ class InputSystem;
 class AudioSystem;
 class JobSystem;
 class Window;
+class Spline;
+class ClimateCache;
 struct Vec2;
 struct Rgba8;
 // -----------------------------------------------------------------------------
+namespace std
+{
+	template <>
+	struct hash<IntVec2>
+	{
+		std::size_t operator()(IntVec2 const& coords) const noexcept
+		{
+			return (std::hash<int>()(coords.x) * 73856093) ^ (std::hash<int>()(coords.y) * 19349663);
+		}
+	};
+}
+// -----------------------------------------------------------------------------
 constexpr float SCREEN_SIZE_X = 1600.f;
 constexpr float SCREEN_SIZE_Y = 800.f;
 constexpr float SCREEN_CENTER_X = SCREEN_SIZE_X / 2.f;
@@ -85,12 +100,20 @@ static const IntVec3 BLOCKFACE[6] =
 	IntVec3::BOTTOM
 };
 // -----------------------------------------------------------------------------
-struct TreeStamp
+// Tree stamp shapes are baked at compile time, see WorldGenTables.hpp
+enum TreeStampType : uint8_t
 {
-	std::vector <std::pair<IntVec3, BlockType>> blocks;
-	int radius = 0;
+	TREE_STAMP_OAK_SMALL,
+	TREE_STAMP_OAK_LARGE,
+	TREE_STAMP_SPRUCE,
+	TREE_STAMP_BIRCH,
+	TREE_STAMP_ACACIA,
+	TREE_STAMP_JUNGLE,
+	TREE_STAMP_CACTUS,
+	TREE_STAMP_SNOWY_SPRUCE,
+	NUM_TREE_STAMPS,
+	TREE_STAMP_NONE = 0xFF
 };
-extern std::unordered_map<std::string, TreeStamp> g_treeStamps;
 // -----------------------------------------------------------------------------
 enum class ChunkState
 {
@@ -105,6 +128,7 @@ enum class ChunkState
 	ACTIVATING_QUEUED_GENERATE,   // [set by main thread] Chunk has been added to the generating queue
 	ACTIVATING_GENERATING,        // [set by generator thread] Chunk is being generated & populated by a generator thread
 	ACTIVATING_GENERATE_COMPLETE, // [set by generator thread] Chunk is done generating and ready for main thread to claim
+	ACTIVATING_GENERATE_REVOKED,  // [set by main thread] Chunk left range before generating finished; its job skips or discards it
 
 	ACTIVE,                       // [set by main thread] Chunk is in m_activeChunks; only main thread can touch it. Lighting and mesh building allowed
 
@@ -116,6 +140,27 @@ enum class ChunkState
 	NUM_CHUNK_STATES
 };
 // -----------------------------------------------------------------------------
+enum class OrePlacementMode
+{
+	PER_BLOCK,                    // Every ore field evaluated for every stone block (reference path)
+	COARSE_GRID,                  // Approximate: ore fields sampled on a coarse grid, refined only near their thresholds
+	NUM_ORE_PLACEMENT_MODES
+};
+// -----------------------------------------------------------------------------
+enum class MeshingMode
+{
+	PER_FACE,                     // One quad per visible block face (reference path)
+	GREEDY,                       // Coplanar neighboring faces with the same sprite and light merged into larger quads
+	NUM_MESHING_MODES
+};
+// -----------------------------------------------------------------------------
+enum class DensitySampleMode
+{
+	PER_BLOCK,                    // Full 3D density noise evaluated for every block (reference path)
+	LATTICE,                      // Approximate: 3D density noise sampled on a coarse lattice and trilinearly interpolated
+	NUM_DENSITY_SAMPLE_MODES
+};
+// -----------------------------------------------------------------------------
 struct WorldConstants
 {
 	Vec4 CameraPosition    = Vec4(0.f, 0.f, 0.f, 0.f);
@@ -152,11 +197,37 @@ constexpr int CHUNK_DEACTIVATION_RANGE = CHUNK_ACTIVATION_RANGE + CHUNK_SIZE_X +
 constexpr int CHUNK_ACTIVATION_RADIUS_X = 1 + CHUNK_ACTIVATION_RANGE / CHUNK_SIZE_X;
 constexpr int CHUNK_ACTIVATION_RADIUS_Y = 1 + CHUNK_ACTIVATION_RANGE / CHUNK_SIZE_Y;
 constexpr int MAX_ACTIVE_CHUNKS = (2 * CHUNK_ACTIVATION_RADIUS_X) * (2 * CHUNK_ACTIVATION_RADIUS_Y);
-constexpr int MAX_MESHES_PER_FRAME = 2;
+constexpr int ACTIVATION_WINDOW_SIZE_X = 2 * CHUNK_ACTIVATION_RADIUS_X + 1;
+constexpr int ACTIVATION_WINDOW_SIZE_Y = 2 * CHUNK_ACTIVATION_RADIUS_Y + 1;
+constexpr int MAX_MESH_JOBS = 16;
 constexpr int CHUNK_MESH_BUILD_RANGE = CHUNK_ACTIVATION_RANGE * CHUNK_ACTIVATION_RANGE;
 
+// Dirty light blocks processed between reads of the clock against the lighting budget
+constexpr int LIGHT_BLOCKS_PER_DEADLINE_CHECK = 64;
+
+// Block sprite sheet layout, must match SPRITE_GRID_SIZE in WorldShader.hlsl
+constexpr int CHUNK_SPRITE_GRID_SIZE = 8;
+
+// Starting size of the shared quad index buffer, doubled whenever a bigger chunk mesh arrives
+constexpr int QUAD_INDEX_BUFFER_MIN_QUADS = 16384;
+
+// Game camera projection, shared with the frustum used to cull chunks
+constexpr float GAME_CAMERA_ASPECT = 2.f;
+constexpr float GAME_CAMERA_FOV_DEGREES = 60.f;
+constexpr float GAME_CAMERA_NEAR_DIST = 0.01f;
+constexpr float GAME_CAMERA_FAR_DIST = 10000.f;
+
+// Chunks are frustum tested in aligned groups of (1 << bits) per side before being tested one by one
+constexpr int CHUNK_CULL_GROUP_BITS = 2;
+constexpr int CHUNK_CULL_GROUP_SIZE = 1 << CHUNK_CULL_GROUP_BITS;
+
+// Cave occlusion culling: chunks are split into vertical sections, each recording which of its faces see each other
+constexpr int CHUNK_VISIBILITY_SECTION_BITS = 4;
+constexpr int CHUNK_VISIBILITY_SECTION_HEIGHT = 1 << CHUNK_VISIBILITY_SECTION_BITS;
+constexpr int CHUNK_NUM_VISIBILITY_SECTIONS = CHUNK_SIZE_Z / CHUNK_VISIBILITY_SECTION_HEIGHT;
+
 // Job constants
-constexpr int MAX_GENERATION_JOBS = 3000;
+constexpr int MAX_GENERATION_JOBS = 64;    // Few enough that the world's distance-sorted queue, not the job FIFO, picks what generates next
 constexpr int MAX_LOAD_JOBS = 2;
 constexpr int MAX_SAVE_JOBS = 2;
 
@@ -210,6 +281,11 @@ constexpr int   SURFACE_LAYER_DEPTH = 3;
 constexpr float DENSITY_NOISE_SCALE = 128.f;
 constexpr int   DENSITY_OCTAVES = 8;
 constexpr float SEA_LEVEL = 60.f;
+constexpr float DENSITY_NOISE_BOUND = 1.01f;    // Renormalized density noise stays in [-1, 1], plus slack for rounding in the shaping math
+
+// Density lattice (coarse 3D density sampling with trilinear interpolation)
+constexpr int DENSITY_LATTICE_STEP_XY = 4;
+constexpr int DENSITY_LATTICE_STEP_Z = 8;
 
 // Continent shaping
 constexpr float CONTINENT_SCALE = 256.f;
@@ -223,6 +299,38 @@ constexpr float PEAKVALLEY_SCALE = 256.f;
 constexpr float TEMPERATURE_SCALE = 512.f;
 constexpr float HUMIDITY_SCALE = 512.f;
 
+// Climate region cache (biome maps sampled once per region at reduced resolution)
+constexpr int CLIMATE_REGION_SIZE_CHUNKS = 8;
+constexpr int CLIMATE_REGION_SIZE_BLOCKS = CLIMATE_REGION_SIZE_CHUNKS * CHUNK_SIZE_X;
+constexpr int CLIMATE_SAMPLE_STEP = 4;
+constexpr int CLIMATE_SAMPLES_PER_SIDE = CLIMATE_REGION_SIZE_BLOCKS / CLIMATE_SAMPLE_STEP + 1;
+constexpr int CLIMATE_EVICTION_RANGE = CHUNK_DEACTIVATION_RANGE + CLIMATE_REGION_SIZE_BLOCKS;
+
+// Decoration writes for chunks this far from the camera move to disk, keeps the buffers bounded
+constexpr int PENDING_WRITE_EVICTION_RANGE = CHUNK_DEACTIVATION_RANGE + CHUNK_SIZE_X + CHUNK_SIZE_Y;
+
+// Caves
+constexpr float CAVE_CHUNK_THRESHOLD = 0.925f;
+constexpr float WORM_CAVE_COORD_SCALE = 0.05f;
+constexpr int   WORM_CAVE_OCTAVES = 3;
+constexpr float WORM_CAVE_THRESHOLD = 0.1f;
+constexpr float CHEESE_CAVE_COORD_SCALE = 0.03f;
+constexpr int   CHEESE_CAVE_OCTAVES = 2;
+constexpr float CHEESE_CAVE_THRESHOLD = 0.55f;
+constexpr int   CAVERN_CELL_SIZE_Z = 32;         // Cavern cells are one chunk wide, so caverns never cross chunks
+constexpr int   CAVERN_MAX_Z = 64;
+constexpr float CAVERN_CHANCE = 0.05f;
+constexpr float CAVERN_MIN_RADIUS = 4.f;
+constexpr float CAVERN_MAX_RADIUS = 8.f;
+
+// Ores
+constexpr int   NUM_ORE_FIELDS = 4;
+constexpr int   ORE_GRID_STEP_XY = 4;
+constexpr int   ORE_GRID_STEP_Z = 4;
+constexpr int   ORE_GRID_CELLS_X = CHUNK_SIZE_X / ORE_GRID_STEP_XY;
+constexpr int   ORE_GRID_CELLS_Y = CHUNK_SIZE_Y / ORE_GRID_STEP_XY;
+constexpr float ORE_REFINE_MARGIN = 0.3f;       // Measured slack, not a bound: the coarse grid can miss ore inside a cell
+
 // Ore chance constants
 constexpr float COAL_CHANCE = 0.05f;
 constexpr float IRON_CHANCE = 0.02f;
@@ -242,25 +350,60 @@ constexpr float CAMERA_SMOOTHING = 1.f;
 constexpr int   INVENTORY_SIZE = 10;
 constexpr int   MAX_STACK_IN_SLOT = 64;
 // -----------------------------------------------------------------------------
+struct OreField
+{
+	uint8_t      m_blockType = BLOCKTYPE_STONE;
+	float        m_coordScale = 1.f;
+	int          m_octaves = 1;
+	unsigned int m_seed = 0;
+	float        m_threshold = 1.f;
+	int          m_maxZ = 0;            // Ore only forms below this Z
+};
+// -----------------------------------------------------------------------------
+struct CavernSphere
+{
+	Vec3  m_center = Vec3::ZERO;
+	float m_radius = 0.f;
+};
+// -----------------------------------------------------------------------------
+struct WorldGenSettings
+{
+	// Continent shaping curves, owned by the Game
+	Spline* m_continentHeightOffsetCurve = nullptr;
+	Spline* m_continentSquashCurve = nullptr;
+
+	// Shared low-frequency climate maps, owned by the Game
+	ClimateCache* m_climateCache = nullptr;
+
+	// Density sampling
+	DensitySampleMode m_densityMode = DensitySampleMode::PER_BLOCK;
+	int m_densityLatticeStepXY = DENSITY_LATTICE_STEP_XY;
+	int m_densityLatticeStepZ = DENSITY_LATTICE_STEP_Z;
+	bool m_useColumnBounds = true;      // Skip density noise where the continent shaping alone decides the block
+
+	// Ore placement
+	OrePlacementMode m_oreMode = OrePlacementMode::PER_BLOCK;
+};
+// -----------------------------------------------------------------------------
 extern App* g_theApp;
 extern Game* g_theGame;
 extern Renderer* g_theRenderer;
 extern RandomNumberGenerator* g_rng;
 extern InputSystem* g_theInput;
 extern AudioSystem* g_theAudio;
-extern JobSystem* g_theJobSystem;
+extern JobSystem* g_theJobSystem;      // Compute pool: generation and meshing
+extern JobSystem* g_theIOJobSystem;    // Disk pool: chunk loads and saves
 extern Window* g_theWindow;
 // -----------------------------------------------------------------------------
-// Tree stamps
-void      BuildTreeStamps();
-TreeStamp MakeSmallOakTree();
-TreeStamp MakeLargeOakTree();
-TreeStamp MakeSpruceTree();
-TreeStamp MakeAcaciaTree();
-TreeStamp MakeBirchTree();
-TreeStamp MakeJungleTree();
-TreeStamp MakeCactus();
-TreeStamp MakeSnowySpruceTree();
+// Caverns
+void AppendCavernsForChunk(IntVec2 const& chunkCoords, std::vector<CavernSphere>& outCaverns);
+// -----------------------------------------------------------------------------
+// World generation setup, shared by the Game and the headless tools
+Spline* CreateContinentHeightOffsetCurve();
+Spline* CreateContinentSquashCurve();
+
+// Reads the sampling options from g_gameConfigBlackboard, curves and climate cache are left to the caller
+void ReadWorldGenSettingsFromConfig(WorldGenSettings& outSettings);
 // -----------------------------------------------------------------------------
 // Raycast voxel helpers
 constexpr float MAX_STEP = 99999.f;
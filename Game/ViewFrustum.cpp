@@ -0,0 +1,118 @@
+#include "Game/ViewFrustum.hpp"
+#include "Game/GameCommon.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Math/RawNoise.hpp"
+
+ViewFrustum ViewFrustum::MakePerspective(Vec3 const& position, Vec3 const& forward, Vec3 const& left, Vec3 const& up,
+	                                     float fovDegrees, float aspect, float nearDist, float farDist)
+{
+	// Slopes of the side planes against the forward axis; fov is vertical, as in SetPerspectiveView
+	float halfHeightSlope = SinDegrees(fovDegrees * 0.5f) / CosDegrees(fovDegrees * 0.5f);
+	float halfWidthSlope = halfHeightSlope * aspect;
+	float forwardDist = DotProduct3D(forward, position);
+
+	ViewFrustum frustum;
+	frustum.m_planes[FRUSTUM_PLANE_NEAR].m_normal = forward;
+	frustum.m_planes[FRUSTUM_PLANE_NEAR].m_distance = forwardDist + nearDist;
+	frustum.m_planes[FRUSTUM_PLANE_FAR].m_normal = -forward;
+	frustum.m_planes[FRUSTUM_PLANE_FAR].m_distance = -(forwardDist + farDist);
+
+	// Each side plane passes through the camera, tilted inward from the forward axis by its slope
+	frustum.m_planes[FRUSTUM_PLANE_LEFT].m_normal = (forward * halfWidthSlope - left).GetNormalized();
+	frustum.m_planes[FRUSTUM_PLANE_RIGHT].m_normal = (forward * halfWidthSlope + left).GetNormalized();
+	frustum.m_planes[FRUSTUM_PLANE_TOP].m_normal = (forward * halfHeightSlope - up).GetNormalized();
+	frustum.m_planes[FRUSTUM_PLANE_BOTTOM].m_normal = (forward * halfHeightSlope + up).GetNormalized();
+	for (int planeIndex = FRUSTUM_PLANE_LEFT; planeIndex <= FRUSTUM_PLANE_BOTTOM; ++planeIndex)
+	{
+		frustum.m_planes[planeIndex].m_distance = DotProduct3D(frustum.m_planes[planeIndex].m_normal, position);
+	}
+	return frustum;
+}
+
+FrustumTest ViewFrustum::TestAABB(AABB3 const& bounds) const
+{
+	FrustumTest result = FrustumTest::INSIDE;
+	for (FrustumPlane const& plane : m_planes)
+	{
+		// Corners furthest along and against the plane normal
+		Vec3 const& normal = plane.m_normal;
+		Vec3 nearestCorner = Vec3(normal.x >= 0.f ? bounds.m_maxs.x : bounds.m_mins.x, normal.y >= 0.f ? bounds.m_maxs.y : bounds.m_mins.y, normal.z >= 0.f ? bounds.m_maxs.z : bounds.m_mins.z);
+		Vec3 farthestCorner = Vec3(normal.x >= 0.f ? bounds.m_mins.x : bounds.m_maxs.x, normal.y >= 0.f ? bounds.m_mins.y : bounds.m_maxs.y, normal.z >= 0.f ? bounds.m_mins.z : bounds.m_maxs.z);
+		if (DotProduct3D(normal, nearestCorner) < plane.m_distance)
+		{
+			return FrustumTest::OUTSIDE;
+		}
+		if (DotProduct3D(normal, farthestCorner) < plane.m_distance)
+		{
+			result = FrustumTest::INTERSECTS;
+		}
+	}
+	return result;
+}
+
+bool ViewFrustum::IsPointInside(Vec3 const& point) const
+{
+	for (FrustumPlane const& plane : m_planes)
+	{
+		if (DotProduct3D(plane.m_normal, point) < plane.m_distance)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FrustumCullingReport ViewFrustum::MeasureAgainstPointTests(int numCameras, int numBoxesPerCamera, unsigned int seed)
+{
+	FrustumCullingReport report;
+	report.m_numCameras = numCameras;
+
+	// Synthetic cameras: random position and yaw/pitch, with the game camera's projection
+	for (int cameraIndex = 0; cameraIndex < numCameras; ++cameraIndex)
+	{
+		Vec3 cameraPosition = Vec3(Get2dNoiseNegOneToOne(cameraIndex, 0, seed) * 500.f, Get2dNoiseNegOneToOne(cameraIndex, 1, seed) * 500.f, Get2dNoiseZeroToOne(cameraIndex, 2, seed) * 128.f);
+		float yawDegrees = Get2dNoiseZeroToOne(cameraIndex, 3, seed) * 360.f;
+		float pitchDegrees = Get2dNoiseNegOneToOne(cameraIndex, 4, seed) * 85.f;
+
+		// Same basis as EulerAngles::GetAsMatrix_IFwd_JLeft_KUp with no roll
+		Vec3 forward = Vec3(CosDegrees(yawDegrees) * CosDegrees(pitchDegrees), SinDegrees(yawDegrees) * CosDegrees(pitchDegrees), -SinDegrees(pitchDegrees));
+		Vec3 left = Vec3(-SinDegrees(yawDegrees), CosDegrees(yawDegrees), 0.f);
+		Vec3 up = Vec3(CosDegrees(yawDegrees) * SinDegrees(pitchDegrees), SinDegrees(yawDegrees) * SinDegrees(pitchDegrees), CosDegrees(pitchDegrees));
+		ViewFrustum frustum = MakePerspective(cameraPosition, forward, left, up, GAME_CAMERA_FOV_DEGREES, GAME_CAMERA_ASPECT, GAME_CAMERA_NEAR_DIST, CHUNK_ACTIVATION_RANGE);
+
+		for (int boxIndex = 0; boxIndex < numBoxesPerCamera; ++boxIndex)
+		{
+			int noiseIndex = cameraIndex * numBoxesPerCamera + boxIndex;
+			Vec3 boxCenter = cameraPosition + Vec3(Get2dNoiseNegOneToOne(noiseIndex, 5, seed), Get2dNoiseNegOneToOne(noiseIndex, 6, seed), Get2dNoiseNegOneToOne(noiseIndex, 7, seed)) * 400.f;
+			Vec3 boxHalfSize = Vec3(Get2dNoiseZeroToOne(noiseIndex, 8, seed), Get2dNoiseZeroToOne(noiseIndex, 9, seed), Get2dNoiseZeroToOne(noiseIndex, 10, seed)) * 64.f;
+			AABB3 box = AABB3(boxCenter - boxHalfSize, boxCenter + boxHalfSize);
+			FrustumTest result = frustum.TestAABB(box);
+			report.m_numBoxTests += 1;
+			report.m_numOutside += (result == FrustumTest::OUTSIDE) ? 1 : 0;
+			report.m_numInside += (result == FrustumTest::INSIDE) ? 1 : 0;
+
+			// Brute force over a lattice of points through the box, corners included
+			constexpr int NUM_STEPS = 4;
+			int numPointsInside = 0;
+			int numCornersOutside = 0;
+			for (int stepZ = 0; stepZ <= NUM_STEPS; ++stepZ)
+			{
+				for (int stepY = 0; stepY <= NUM_STEPS; ++stepY)
+				{
+					for (int stepX = 0; stepX <= NUM_STEPS; ++stepX)
+					{
+						Vec3 fraction = Vec3(static_cast<float>(stepX), static_cast<float>(stepY), static_cast<float>(stepZ)) * (1.f / static_cast<float>(NUM_STEPS));
+						Vec3 point = Vec3(Interpolate(box.m_mins.x, box.m_maxs.x, fraction.x), Interpolate(box.m_mins.y, box.m_maxs.y, fraction.y), Interpolate(box.m_mins.z, box.m_maxs.z, fraction.z));
+						bool isInside = frustum.IsPointInside(point);
+						bool isCorner = (stepX % NUM_STEPS == 0) && (stepY % NUM_STEPS == 0) && (stepZ % NUM_STEPS == 0);
+						numPointsInside += isInside ? 1 : 0;
+						numCornersOutside += (isCorner && !isInside) ? 1 : 0;
+					}
+				}
+			}
+			report.m_numWronglyCulled += (result == FrustumTest::OUTSIDE && numPointsInside > 0) ? 1 : 0;
+			report.m_numWronglyInside += (result == FrustumTest::INSIDE && numCornersOutside > 0) ? 1 : 0;
+		}
+	}
+	return report;
+}
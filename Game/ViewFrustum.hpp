@@ -0,0 +1,57 @@
+#pragma once
+#include "Engine/Math/Vec3.h"
+#include "Engine/Math/AABB3.hpp"
+// -----------------------------------------------------------------------------
+enum FrustumPlaneType
+{
+	FRUSTUM_PLANE_NEAR,
+	FRUSTUM_PLANE_FAR,
+	FRUSTUM_PLANE_LEFT,
+	FRUSTUM_PLANE_RIGHT,
+	FRUSTUM_PLANE_TOP,
+	FRUSTUM_PLANE_BOTTOM,
+	NUM_FRUSTUM_PLANES
+};
+// -----------------------------------------------------------------------------
+enum class FrustumTest
+{
+	OUTSIDE,
+	INTERSECTS,
+	INSIDE
+};
+// -----------------------------------------------------------------------------
+// Points p with DotProduct3D(m_normal, p) >= m_distance are on the inside
+struct FrustumPlane
+{
+	Vec3  m_normal = Vec3::ZERO;
+	float m_distance = 0.f;
+};
+// -----------------------------------------------------------------------------
+struct FrustumCullingReport
+{
+	int m_numCameras = 0;
+	int m_numBoxTests = 0;
+	int m_numOutside = 0;
+	int m_numInside = 0;
+	int m_numWronglyCulled = 0;    // Reported outside while a point of the box is visible
+	int m_numWronglyInside = 0;    // Reported inside while a corner is not visible
+};
+// -----------------------------------------------------------------------------
+// Perspective view volume as six inward-facing planes, built from the camera's position and
+// basis rather than its matrices, so it can be made and tested without a renderer
+// -----------------------------------------------------------------------------
+class ViewFrustum
+{
+public:
+	static ViewFrustum MakePerspective(Vec3 const& position, Vec3 const& forward, Vec3 const& left, Vec3 const& up,
+		                               float fovDegrees, float aspect, float nearDist, float farDist);
+
+	// Conservative: OUTSIDE only when the box is entirely behind one plane
+	FrustumTest TestAABB(AABB3 const& bounds) const;
+	bool IsPointInside(Vec3 const& point) const;
+
+	static FrustumCullingReport MeasureAgainstPointTests(int numCameras, int numBoxesPerCamera, unsigned int seed);
+
+public:
+	FrustumPlane m_planes[NUM_FRUSTUM_PLANES];
+};
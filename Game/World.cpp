@@ -4,34 +4,129 @@
 #include "Game/GameCommon.h"
 #include "Game/Player.hpp"
 #include "Game/BlockDefinition.hpp"
+#include "Game/ClimateCache.hpp"
+#include "Game/WorldRenderContext.hpp"
 #include "Engine/Core/EngineCommon.h"
 #include "Engine/Core/DebugRender.hpp"
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
 #include "Engine/Input/InputSystem.h"
+#include "Engine/Renderer/Renderer.h"
 #include "Engine/Math/MathUtils.h"
+#include <algorithm>
+#include <cstdio>
 
+// -----------------------------------------------------------------------------
+template <typename JobType>
+static JobType* AcquireJob(std::vector<JobType*>& freeJobs)
+{
+	if (freeJobs.empty())
+	{
+		return new JobType();
+	}
+	JobType* job = freeJobs.back();
+	freeJobs.pop_back();
+	return job;
+}
+
+template <typename JobType>
+static void DeleteJobs(std::vector<JobType*>& jobs)
+{
+	for (JobType* job : jobs)
+	{
+		delete job;
+	}
+	jobs.clear();
+}
+
+template <typename ResultType>
+static void PushCompletion(CompletionChannel<ResultType>& channel, ResultType&& result)
+{
+	// A full channel means a job limit was raised past the channel's capacity
+	bool wasPushed = channel.Push(std::move(result));
+	GUARANTEE_OR_DIE(wasPushed, "Chunk job completion channel is full");
+}
+
+template <typename ResultType, typename FinishFunction>
+static int FinishResultsUntil(std::vector<ResultType>& results, double deadline, FinishFunction const& finish)
+{
+	// At least one per list so nothing starves; the rest stay at the front, ahead of anything drained later
+	int numFinished = 0;
+	int numResults = static_cast<int>(results.size());
+	while (numFinished < numResults && (numFinished == 0 || GetCurrentTimeSeconds() < deadline))
+	{
+		finish(results[numFinished]);
+		numFinished += 1;
+	}
+	results.erase(results.begin(), results.begin() + numFinished);
+	return numFinished;
+}
+// -----------------------------------------------------------------------------
+// Per stage budget defaults add up to 4 ms; GameConfig.xml overrides each one
+struct WorldStageConfig
+{
+	char const* m_name;
+	char const* m_budgetKey;
+	int         m_defaultBudgetMicroseconds;
+};
+static WorldStageConfig const WORLD_STAGE_CONFIGS[static_cast<int>(WorldUpdateStage::COUNT)] =
+{
+	{ "Completions",  "completionsBudgetMicroseconds",  1000 },
+	{ "Lighting",     "lightingBudgetMicroseconds",     1250 },
+	{ "Meshing",      "meshingBudgetMicroseconds",      750 },
+	{ "Deactivation", "deactivationBudgetMicroseconds", 250 },
+	{ "Activation",   "activationBudgetMicroseconds",   750 },
+};
+// -----------------------------------------------------------------------------
 World::World(Game* owner)
 	:m_theGame(owner)
 {
+	m_generationWindowStartTime = GetCurrentTimeSeconds();
+	m_meshingMode = (g_gameConfigBlackboard.GetValue("meshingMode", "PerFace") == "Greedy") ? MeshingMode::GREEDY : MeshingMode::PER_FACE;
+	m_chunkSpriteImage = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/SpriteSheet_Classic_Faithful_32x.png", 5);
+	m_frustumCullingEnabled = g_gameConfigBlackboard.GetValue("frustumCulling", true);
+	m_hierarchicalCullingEnabled = g_gameConfigBlackboard.GetValue("hierarchicalCulling", true);
+	m_occlusionCullingEnabled = g_gameConfigBlackboard.GetValue("occlusionCulling", true);
+	for (int stageIndex = 0; stageIndex < static_cast<int>(WorldUpdateStage::COUNT); ++stageIndex)
+	{
+		WorldStageConfig const& stageConfig = WORLD_STAGE_CONFIGS[stageIndex];
+		int budgetMicroseconds = g_gameConfigBlackboard.GetValue(stageConfig.m_budgetKey, stageConfig.m_defaultBudgetMicroseconds);
+		m_stageStats[stageIndex].m_budgetSeconds = static_cast<double>((budgetMicroseconds > 0) ? budgetMicroseconds : 0) * 0.000001;
+	}
+	BuildFaceSpriteCells();
+	BuildActivationOffsets();
 }
 
 World::~World()
 {
-	for (auto foundChunk = m_activeChunks.begin(); foundChunk != m_activeChunks.end(); ++foundChunk)
+	m_activeChunks.ForEachChunk([this](Chunk* chunk)
 	{
-		Chunk* chunk = foundChunk->second;
 		if (chunk->m_needsSaving)
 		{
 			SaveChunkToFile(chunk);
 		}
-		if (chunk != nullptr)
-		{
-			delete chunk;
-			chunk = nullptr;
-		}
+		m_chunkPool.Release(chunk);
+	});
+	m_activeChunks.Clear();
+	m_chunkPool.Clear();
+
+	// Decoration for chunks that never activated this session
+	for (auto const& pendingWrites : m_pendingBlockWrites)
+	{
+		Chunk::AppendPendingWritesToFile(pendingWrites.first, pendingWrites.second);
 	}
-	m_activeChunks.clear();
+	m_pendingBlockWrites.clear();
+
+	DeleteJobs(m_freeGenerateJobs);
+	DeleteJobs(m_freeLoadJobs);
+	DeleteJobs(m_freeSaveJobs);
+	DeleteJobs(m_freeMeshJobs);
+
+	delete m_quadIndexBuffer;
+	m_quadIndexBuffer = nullptr;
 }
 
 void World::Update(float deltaSeconds)
@@ -40,17 +135,69 @@ void World::Update(float deltaSeconds)
 	Vec2 cameraPosXY = m_theGame->m_gameCamera->GetRenderCamera().GetPosition().GetXY();
 
 	HandleDebugInput();
+	UpdateGenerationRate();
 
 	UpdateMeshBuildQueue(cameraPosXY);
-	BuildMeshesThisFrame();
+	RunBudgetedStages(cameraPosXY);
 
-	DeactivateFurthestChunk(cameraPosXY);
-	QueueClosestMissingChunk(cameraPosXY);
+	if (m_theGame->m_worldGenSettings.m_climateCache != nullptr)
+	{
+		m_theGame->m_worldGenSettings.m_climateCache->EvictDistantRegions(cameraPosXY, static_cast<float>(CLIMATE_EVICTION_RANGE));
+	}
+	EvictDistantPendingBlockWrites(cameraPosXY);
 
+	UpdateGenerationQueue(cameraPosXY);
 	DispatchGenerateJobs();
 	DispatchLoadAndSaveJobs();
+}
+
+void World::RunBudgetedStages(Vec2 const& cameraPosXY)
+{
+	// Time a stage does not need carries on to the next one, so idle frames still get through the queues
+	double carriedSeconds = 0.0;
+	for (int stageIndex = 0; stageIndex < static_cast<int>(WorldUpdateStage::COUNT); ++stageIndex)
+	{
+		WorldUpdateStage stage = static_cast<WorldUpdateStage>(stageIndex);
+		WorldStageStats& stats = m_stageStats[stageIndex];
+		stats.m_grantedSeconds = stats.m_budgetSeconds + carriedSeconds;
+
+		double startTime = GetCurrentTimeSeconds();
+		stats.m_numItems = RunStage(stage, cameraPosXY, startTime + stats.m_grantedSeconds);
+		stats.m_usedSeconds = GetCurrentTimeSeconds() - startTime;
+		stats.m_backlog = GetStageBacklog(stage);
+
+		stats.m_usedSecondsThisWindow += stats.m_usedSeconds;
+		stats.m_maxUsedThisWindow = (stats.m_usedSeconds > stats.m_maxUsedThisWindow) ? stats.m_usedSeconds : stats.m_maxUsedThisWindow;
+		carriedSeconds = (stats.m_grantedSeconds > stats.m_usedSeconds) ? (stats.m_grantedSeconds - stats.m_usedSeconds) : 0.0;
+	}
+	m_updatesThisWindow += 1;
+}
+
+int World::RunStage(WorldUpdateStage stage, Vec2 const& cameraPosXY, double deadline)
+{
+	switch (stage)
+	{
+		case WorldUpdateStage::COMPLETIONS:  return ProcessCompletedJobs(deadline);
+		case WorldUpdateStage::LIGHTING:     return ProcessDirtyLighting(deadline);
+		case WorldUpdateStage::MESHING:      return BuildMeshesThisFrame(deadline);
+		case WorldUpdateStage::DEACTIVATION: return DeactivateDistantChunks(cameraPosXY, deadline);
+		case WorldUpdateStage::ACTIVATION:   return QueueClosestMissingChunk(cameraPosXY, deadline);
+		default:                             return 0;
+	}
+}
 
-	ProcessCompletedJobs();
+int World::GetStageBacklog(WorldUpdateStage stage) const
+{
+	switch (stage)
+	{
+		case WorldUpdateStage::COMPLETIONS:
+			return static_cast<int>(m_generateResults.size() + m_loadResults.size() + m_saveResults.size() + m_meshResults.size());
+		case WorldUpdateStage::LIGHTING:     return static_cast<int>(m_dirtyLightBlocks.size());
+		case WorldUpdateStage::MESHING:      return static_cast<int>(m_meshBuildHeap.size());
+		case WorldUpdateStage::DEACTIVATION: return m_numChunksOutOfRange;
+		case WorldUpdateStage::ACTIVATION:   return static_cast<int>(m_activationOffsets.size()) - m_activationCursor;
+		default:                             return 0;
+	}
 }
 
 void World::HandleDebugInput()
@@ -72,26 +219,364 @@ void World::HandleDebugInput()
 		m_debugJobText = !m_debugJobText;
 	}
 
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F6))
+	{
+		ReportChunkUnderCamera();
+	}
+
 	if (g_theInput->WasKeyJustPressed('K'))
 	{
 		m_lightingEnabled = !m_lightingEnabled;
 	}
+
+	if (g_theInput->WasKeyJustPressed('G'))
+	{
+		m_meshingMode = (m_meshingMode == MeshingMode::GREEDY) ? MeshingMode::PER_FACE : MeshingMode::GREEDY;
+		m_activeChunks.ForEachChunk([this](Chunk* chunk)
+		{
+			MarkChunkMeshDirty(chunk);
+		});
+	}
+}
+
+void World::UpdateGenerationRate()
+{
+	double currentTime = GetCurrentTimeSeconds();
+	double elapsedSeconds = currentTime - m_generationWindowStartTime;
+	if (elapsedSeconds >= 1.0)
+	{
+		m_chunksGeneratedPerSecond = static_cast<float>(m_chunksGeneratedThisWindow / elapsedSeconds);
+		m_chunksGeneratedThisWindow = 0;
+
+		m_averageMeshWaitSeconds = (m_meshesBuiltThisWindow > 0) ? static_cast<float>(m_meshWaitSecondsThisWindow / m_meshesBuiltThisWindow) : 0.f;
+		m_maxMeshWaitSeconds = static_cast<float>(m_maxMeshWaitThisWindow);
+		m_meshBytesUploadedPerSecond = static_cast<float>(m_meshBytesUploadedThisWindow / elapsedSeconds);
+		m_meshBytesUploadedThisWindow = 0;
+		m_meshesBuiltThisWindow = 0;
+		m_meshWaitSecondsThisWindow = 0.0;
+		m_maxMeshWaitThisWindow = 0.0;
+
+		m_averageLoadSeconds = (m_chunksLoadedThisWindow > 0) ? static_cast<float>(m_loadSecondsThisWindow / m_chunksLoadedThisWindow) : 0.f;
+		m_maxLoadSeconds = static_cast<float>(m_maxLoadThisWindow);
+		m_chunksLoadedThisWindow = 0;
+		m_loadSecondsThisWindow = 0.0;
+		m_maxLoadThisWindow = 0.0;
+
+		for (WorldStageStats& stats : m_stageStats)
+		{
+			stats.m_averageUsedSeconds = (m_updatesThisWindow > 0) ? static_cast<float>(stats.m_usedSecondsThisWindow / m_updatesThisWindow) : 0.f;
+			stats.m_maxUsedSeconds = static_cast<float>(stats.m_maxUsedThisWindow);
+			stats.m_usedSecondsThisWindow = 0.0;
+			stats.m_maxUsedThisWindow = 0.0;
+		}
+		m_updatesThisWindow = 0;
+		m_generationWindowStartTime = currentTime;
+	}
+}
+
+void World::ReportChunkUnderCamera() const
+{
+	Chunk* chunk = GetChunkForWorldPos(m_theGame->m_gameCamera->GetRenderCamera().GetPosition());
+	if (chunk == nullptr)
+	{
+		return;
+	}
+
+	// Only checks that depend on this chunk or the live world; the pure ones run as headless tests
+	auto addReportLine = [](bool isExpected, std::string const& text)
+	{
+		g_theDevConsole->AddLine(isExpected ? Rgba8::LIGHTYELLOW : Rgba8::RED, text);
+		DebuggerPrintf("%s\n", text.c_str());
+	};
+
+	DensityErrorReport report = chunk->MeasureDensityLatticeError(m_theGame->m_worldGenSettings);
+	addReportLine(true, Stringf("Density lattice (%d,%d): %d lattice samples for %d blocks, max error %.4f, mean error %.4f, %d mismatched blocks",
+		chunk->m_chunkCoords.x, chunk->m_chunkCoords.y, report.m_numLatticeSamples, report.m_numSamples, report.m_maxAbsError, report.m_meanAbsError, report.m_numMismatchedBlocks));
+	addReportLine(true, Stringf("Density timing: per-block %.2f ms, lattice %.2f ms", report.m_perBlockSeconds * 1000.0, report.m_latticeSeconds * 1000.0));
+
+	ColumnBoundsReport boundsReport = chunk->MeasureColumnBounds(m_theGame->m_worldGenSettings);
+	addReportLine(boundsReport.m_numMismatchedBlocks == 0, Stringf("Column bounds: %d of %d blocks need density noise, full %.2f ms, bounded %.2f ms, %d mismatched blocks",
+		boundsReport.m_numBlocksEvaluated, boundsReport.m_numBlocks, boundsReport.m_fullSeconds * 1000.0, boundsReport.m_boundedSeconds * 1000.0, boundsReport.m_numMismatchedBlocks));
+
+	OreMeasurement oreMeasurement = chunk->MeasureOrePlacement(m_theGame->m_worldGenSettings);
+	addReportLine(oreMeasurement.m_numFalseOreBlocks == 0, Stringf("Ore placement: per-block %.2f ms (%d evaluated), coarse grid %.2f ms (%d coarse, %d evaluated), %d of %d placed, %d mismatched blocks",
+		oreMeasurement.m_perBlock.m_seconds * 1000.0, oreMeasurement.m_perBlock.m_numBlocksEvaluated,
+		oreMeasurement.m_coarseGrid.m_seconds * 1000.0, oreMeasurement.m_coarseGrid.m_numCoarseSamples, oreMeasurement.m_coarseGrid.m_numBlocksEvaluated,
+		oreMeasurement.m_coarseGrid.m_numOreBlocksPlaced, oreMeasurement.m_coarseGrid.m_numCandidateBlocks, oreMeasurement.m_numMismatchedBlocks));
+
+	ChunkLookupReport lookupReport = m_activeChunks.MeasureLookups(chunk->m_chunkCoords, 65536, GAME_SEED);
+	addReportLine(true, Stringf("Chunk lookup: %d chunks (%d overflow), %d lookups grid %.3f ms map %.3f ms, iterate grid %.3f ms map %.3f ms",
+		lookupReport.m_numChunks, lookupReport.m_numOverflowChunks, lookupReport.m_numLookups, lookupReport.m_gridLookupSeconds * 1000.0,
+		lookupReport.m_mapLookupSeconds * 1000.0, lookupReport.m_gridIterateSeconds * 1000.0, lookupReport.m_mapIterateSeconds * 1000.0));
+
+	MeshingReport meshingReport = chunk->MeasureGreedyMeshing();
+	addReportLine(meshingReport.m_numMismatchedFaces == 0, Stringf("Greedy meshing: %d faces, %d vertices %d indices per-face, %d vertices %d indices greedy, per-face %.2f ms, greedy %.2f ms, %d mismatched faces",
+		meshingReport.m_perFace.m_numFaces, meshingReport.m_perFace.m_numQuads * 4, meshingReport.m_perFace.m_numQuads * 6, meshingReport.m_greedy.m_numQuads * 4,
+		meshingReport.m_greedy.m_numQuads * 6, meshingReport.m_perFaceSeconds * 1000.0, meshingReport.m_greedySeconds * 1000.0, meshingReport.m_numMismatchedFaces));
 }
 
 void World::Render() const
 {
-	for (auto foundChunk = m_activeChunks.begin(); foundChunk != m_activeChunks.end(); ++foundChunk)
+	// Every chunk shares this state and the world constants; the pass draws through a counting context,
+	// so the stats are what was actually issued
+	WorldRenderStats renderStats;
+	RendererWorldRenderContext rendererContext(g_theGame->m_world_CBO);
+	CountingWorldRenderContext context(rendererContext);
+	BeginWorldPass(context, g_theGame->m_worldConstants, g_theGame->m_worldShader, m_chunkSpriteImage);
+
+	if (m_occlusionCullingEnabled)
 	{
-		Chunk* chunk = foundChunk->second;
-		if (chunk != nullptr)
+		FindVisibleSections(GetCameraFrustum(), renderStats);
+	}
+
+	// Each chunk only uploads its origin and draws
+	if (!m_frustumCullingEnabled)
+	{
+		m_activeChunks.ForEachChunk([this, &context, &renderStats](Chunk* chunk)
 		{
-			chunk->Render();
-		}
+			RenderChunk(chunk, context, renderStats);
+		});
+	}
+	else if (!m_hierarchicalCullingEnabled)
+	{
+		ViewFrustum frustum = GetCameraFrustum();
+		m_activeChunks.ForEachChunk([this, &frustum, &context, &renderStats](Chunk* chunk)
+		{
+			renderStats.m_numChunkTests += 1;
+			if (frustum.TestAABB(chunk->GetWorldBounds()) == FrustumTest::OUTSIDE)
+			{
+				renderStats.m_numChunksCulled += 1;
+				return;
+			}
+			RenderChunk(chunk, context, renderStats);
+		});
 	}
+	else
+	{
+		RenderVisibleChunkGroups(GetCameraFrustum(), context, renderStats);
+	}
+	renderStats.m_numStateChanges = context.m_numStateChanges;
+	renderStats.m_numConstantUploads = context.m_numConstantUploads;
+	m_lastRenderStats = renderStats;
 
 	RenderDebugModes();
 }
 
+ViewFrustum World::GetCameraFrustum() const
+{
+	Camera const& renderCamera = m_theGame->m_gameCamera->GetRenderCamera();
+	Mat44 cameraBasis = renderCamera.GetOrientation().GetAsMatrix_IFwd_JLeft_KUp();
+	return ViewFrustum::MakePerspective(renderCamera.GetPosition(), cameraBasis.GetIBasis3D(), cameraBasis.GetJBasis3D(), cameraBasis.GetKBasis3D(),
+		GAME_CAMERA_FOV_DEGREES, GAME_CAMERA_ASPECT, GAME_CAMERA_NEAR_DIST, GAME_CAMERA_FAR_DIST);
+}
+
+void World::RenderVisibleChunkGroups(ViewFrustum const& frustum, WorldRenderContext& context, WorldRenderStats& renderStats) const
+{
+	// Groups covering every cell an active chunk can hold; chunks past the deactivation range are skipped as culled
+	Vec3 cameraPosition = m_theGame->m_gameCamera->GetRenderCamera().GetPosition();
+	IntVec2 cameraChunkCoords = IntVec2(RoundDownToInt(cameraPosition.x / static_cast<float>(CHUNK_SIZE_X)), RoundDownToInt(cameraPosition.y / static_cast<float>(CHUNK_SIZE_Y)));
+	int windowRadius = CHUNK_DEACTIVATION_RANGE / CHUNK_SIZE_X + 1;
+	int minGroupX = (cameraChunkCoords.x - windowRadius) >> CHUNK_CULL_GROUP_BITS;
+	int maxGroupX = (cameraChunkCoords.x + windowRadius) >> CHUNK_CULL_GROUP_BITS;
+	int minGroupY = (cameraChunkCoords.y - windowRadius) >> CHUNK_CULL_GROUP_BITS;
+	int maxGroupY = (cameraChunkCoords.y + windowRadius) >> CHUNK_CULL_GROUP_BITS;
+
+	int numChunksVisited = 0;
+	for (int groupY = minGroupY; groupY <= maxGroupY; ++groupY)
+	{
+		for (int groupX = minGroupX; groupX <= maxGroupX; ++groupX)
+		{
+			IntVec2 groupMinChunk = IntVec2(groupX << CHUNK_CULL_GROUP_BITS, groupY << CHUNK_CULL_GROUP_BITS);
+			Vec3 groupMins = Vec3(static_cast<float>(groupMinChunk.x * CHUNK_SIZE_X), static_cast<float>(groupMinChunk.y * CHUNK_SIZE_Y), 0.f);
+			Vec3 groupMaxs = groupMins + Vec3(static_cast<float>(CHUNK_CULL_GROUP_SIZE * CHUNK_SIZE_X), static_cast<float>(CHUNK_CULL_GROUP_SIZE * CHUNK_SIZE_Y), static_cast<float>(CHUNK_SIZE_Z));
+			renderStats.m_numGroupTests += 1;
+			FrustumTest groupResult = frustum.TestAABB(AABB3(groupMins, groupMaxs));
+			if (groupResult == FrustumTest::OUTSIDE)
+			{
+				continue;
+			}
+
+			// Chunks in a group entirely inside need no test of their own
+			for (int chunkY = groupMinChunk.y; chunkY < groupMinChunk.y + CHUNK_CULL_GROUP_SIZE; ++chunkY)
+			{
+				for (int chunkX = groupMinChunk.x; chunkX < groupMinChunk.x + CHUNK_CULL_GROUP_SIZE; ++chunkX)
+				{
+					Chunk* chunk = m_activeChunks.Find(IntVec2(chunkX, chunkY));
+					if (chunk == nullptr)
+					{
+						continue;
+					}
+
+					numChunksVisited += 1;
+					if (groupResult == FrustumTest::INTERSECTS)
+					{
+						renderStats.m_numChunkTests += 1;
+						if (frustum.TestAABB(chunk->GetWorldBounds()) == FrustumTest::OUTSIDE)
+						{
+							renderStats.m_numChunksCulled += 1;
+							continue;
+						}
+					}
+					RenderChunk(chunk, context, renderStats);
+				}
+			}
+		}
+	}
+	renderStats.m_numChunksCulled += m_activeChunks.GetCount() - numChunksVisited;
+}
+
+bool World::RenderChunk(Chunk const* chunk, WorldRenderContext& context, WorldRenderStats& renderStats) const
+{
+	if (renderStats.m_isOcclusionCullingActive && chunk->m_visibleFrame != m_visibilityFrame)
+	{
+		renderStats.m_numChunksOccluded += 1;
+		return false;
+	}
+
+	if (!chunk->Render(context, m_quadIndexBuffer))
+	{
+		return false;
+	}
+
+	renderStats.m_numChunksDrawn += 1;
+	return true;
+}
+
+void World::FindVisibleSections(ViewFrustum const& frustum, WorldRenderStats& renderStats) const
+{
+	// Outside the world's height, or over a chunk that is not active, everything in the frustum is drawn
+	Vec3 cameraPosition = m_theGame->m_gameCamera->GetRenderCamera().GetPosition();
+	Chunk* cameraChunk = GetChunkForWorldPos(cameraPosition);
+	if (cameraChunk == nullptr || cameraPosition.z < 0.f || cameraPosition.z >= static_cast<float>(CHUNK_SIZE_Z))
+	{
+		return;
+	}
+
+	// Breadth-first from the camera's section. A section is only left through a face its entry face can see,
+	// and never in the direction opposite one already taken, so the search only fans outward
+	m_visibilityFrame += 1;
+	renderStats.m_isOcclusionCullingActive = true;
+	m_visibilitySearchQueue.clear();
+
+	VisibilitySearchNode startNode;
+	startNode.m_chunk = cameraChunk;
+	startNode.m_section = RoundDownToInt(cameraPosition.z) >> CHUNK_VISIBILITY_SECTION_BITS;
+	cameraChunk->m_sectionVisitedFrame[startNode.m_section] = m_visibilityFrame;
+	m_visibilitySearchQueue.push_back(startNode);
+
+	for (size_t queueIndex = 0; queueIndex < m_visibilitySearchQueue.size(); ++queueIndex)
+	{
+		VisibilitySearchNode node = m_visibilitySearchQueue[queueIndex];
+		node.m_chunk->m_visibleFrame = m_visibilityFrame;
+		renderStats.m_numSectionsVisited += 1;
+
+		for (int exitFace = 0; exitFace < NUM_BLOCKFACES; ++exitFace)
+		{
+			int oppositeFace = exitFace ^ 1;
+			if (node.m_stepDirections & (1 << oppositeFace))
+			{
+				continue;
+			}
+			if (node.m_entryFace >= 0 && !node.m_chunk->m_visibility.AreFacesConnected(node.m_section, node.m_entryFace, exitFace))
+			{
+				continue;
+			}
+
+			Chunk* nextChunk = node.m_chunk;
+			int nextSection = node.m_section;
+			switch (exitFace)
+			{
+				case BLOCK_FACE_EAST:   nextChunk = node.m_chunk->m_eastNeighbor;  break;
+				case BLOCK_FACE_WEST:   nextChunk = node.m_chunk->m_westNeighbor;  break;
+				case BLOCK_FACE_NORTH:  nextChunk = node.m_chunk->m_northNeighbor; break;
+				case BLOCK_FACE_SOUTH:  nextChunk = node.m_chunk->m_southNeighbor; break;
+				case BLOCK_FACE_TOP:    nextSection += 1; break;
+				case BLOCK_FACE_BOTTOM: nextSection -= 1; break;
+			}
+			if (nextChunk == nullptr || nextSection < 0 || nextSection >= CHUNK_NUM_VISIBILITY_SECTIONS)
+			{
+				continue;
+			}
+			if (nextChunk->m_sectionVisitedFrame[nextSection] == m_visibilityFrame)
+			{
+				continue;
+			}
+
+			Vec3 sectionMins = Vec3(static_cast<float>(nextChunk->m_chunkCoords.x * CHUNK_SIZE_X), static_cast<float>(nextChunk->m_chunkCoords.y * CHUNK_SIZE_Y),
+				static_cast<float>(nextSection * CHUNK_VISIBILITY_SECTION_HEIGHT));
+			Vec3 sectionMaxs = sectionMins + Vec3(static_cast<float>(CHUNK_SIZE_X), static_cast<float>(CHUNK_SIZE_Y), static_cast<float>(CHUNK_VISIBILITY_SECTION_HEIGHT));
+			if (frustum.TestAABB(AABB3(sectionMins, sectionMaxs)) == FrustumTest::OUTSIDE)
+			{
+				continue;
+			}
+
+			nextChunk->m_sectionVisitedFrame[nextSection] = m_visibilityFrame;
+			VisibilitySearchNode nextNode;
+			nextNode.m_chunk = nextChunk;
+			nextNode.m_section = nextSection;
+			nextNode.m_entryFace = oppositeFace;
+			nextNode.m_stepDirections = node.m_stepDirections | static_cast<uint8_t>(1 << exitFace);
+			m_visibilitySearchQueue.push_back(nextNode);
+		}
+	}
+}
+
+void World::BuildFaceSpriteCells()
+{
+	int numBlockTypes = static_cast<int>(BlockDefinition::s_blockDefs.size());
+	m_faceSpriteCells.assign(numBlockTypes * NUM_SNAPSHOT_FACE_UVS, IntVec2::ZERO);
+	for (int blockType = 0; blockType < numBlockTypes; ++blockType)
+	{
+		BlockDefinition const* blockDef = BlockDefinition::s_blockDefs[blockType];
+		if (blockDef)
+		{
+			m_faceSpriteCells[blockType * NUM_SNAPSHOT_FACE_UVS + SNAPSHOT_FACE_UV_TOP] = GetSpriteCell(blockDef->m_topSpriteCoords);
+			m_faceSpriteCells[blockType * NUM_SNAPSHOT_FACE_UVS + SNAPSHOT_FACE_UV_BOTTOM] = GetSpriteCell(blockDef->m_bottomSpriteCoords);
+			m_faceSpriteCells[blockType * NUM_SNAPSHOT_FACE_UVS + SNAPSHOT_FACE_UV_SIDE] = GetSpriteCell(blockDef->m_sideSpriteCoords);
+		}
+	}
+}
+
+IntVec2 World::GetSpriteCell(IntVec2 const& spriteCoords) const
+{
+	// The cell the sprite's UV mins fall in, so the shader's decode matches the sprite sheet's UV layout
+	AABB2 spriteUVs = m_theGame->m_spriteSheet->GetSpriteUVCoords(spriteCoords);
+	float gridSize = static_cast<float>(CHUNK_SPRITE_GRID_SIZE);
+	return IntVec2(RoundDownToInt(spriteUVs.m_mins.x * gridSize + 0.5f), RoundDownToInt(spriteUVs.m_mins.y * gridSize + 0.5f));
+}
+
+void World::EnsureQuadIndexCapacity(int numQuads)
+{
+	if (numQuads <= m_quadIndexCapacity)
+	{
+		return;
+	}
+
+	// Doubling keeps regrowth rare as bigger meshes come in
+	int newCapacity = (m_quadIndexCapacity > 0) ? m_quadIndexCapacity : QUAD_INDEX_BUFFER_MIN_QUADS;
+	while (newCapacity < numQuads)
+	{
+		newCapacity *= 2;
+	}
+
+	std::vector<unsigned int> quadIndices;
+	quadIndices.reserve(static_cast<size_t>(newCapacity) * 6);
+	for (unsigned int quadStart = 0; quadStart < static_cast<unsigned int>(newCapacity) * 4; quadStart += 4)
+	{
+		quadIndices.push_back(quadStart + 0);
+		quadIndices.push_back(quadStart + 1);
+		quadIndices.push_back(quadStart + 2);
+		quadIndices.push_back(quadStart + 0);
+		quadIndices.push_back(quadStart + 2);
+		quadIndices.push_back(quadStart + 3);
+	}
+
+	delete m_quadIndexBuffer;
+	m_quadIndexBuffer = g_theRenderer->CreateIndexBuffer(static_cast<unsigned int>(quadIndices.size()) * sizeof(unsigned int), sizeof(unsigned int));
+	g_theRenderer->CopyCPUToGPU(quadIndices.data(), m_quadIndexBuffer->GetSize(), m_quadIndexBuffer);
+	m_quadIndexCapacity = newCapacity;
+}
+
 void World::RenderDebugModes() const
 {
 	AABB2 gameSceneBounds = AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y));
@@ -100,37 +585,114 @@ void World::RenderDebugModes() const
 	{
 		int totalVertices = 0;
 		int totalIndices = 0;
+		int totalFaces = 0;
 
-		for (auto foundChunk = m_activeChunks.begin(); foundChunk != m_activeChunks.end(); ++foundChunk)
+		m_activeChunks.ForEachChunk([&totalVertices, &totalIndices, &totalFaces](Chunk* chunk)
 		{
-			Chunk* chunk = foundChunk->second;
-			if (chunk != nullptr)
-			{
-				DebugAddWorldWireAABB3(chunk->GetWorldBounds(), 0.0f);
-				totalVertices += chunk->GetVertexCount();
-				totalIndices += chunk->GetIndexCount();
-			}
-		}
+			DebugAddWorldWireAABB3(chunk->GetWorldBounds(), 0.0f);
+			totalVertices += chunk->GetVertexCount();
+			totalIndices += chunk->GetIndexCount();
+			totalFaces += chunk->m_meshStats.m_numFaces;
+		});
 
 		std::string chunkText = Stringf("Chunks: %d Vertices: %d Indices: %d ",
-			static_cast<int>(m_activeChunks.size()), totalVertices, totalIndices);
+			m_activeChunks.GetCount(), totalVertices, totalIndices);
 		DebugAddScreenText(chunkText, gameSceneBounds, 15.f, Vec2(0.f, 0.97f), 0.f);
+
+		// A per-face mesh spends 4 vertices and 6 indices on every visible face
+		float vertexReduction = (totalVertices > 0) ? static_cast<float>(totalFaces * 4) / static_cast<float>(totalVertices) : 0.f;
+		std::string meshingText = Stringf("Meshing: %s, %d faces, %.2fx fewer vertices than per-face (%d vertices %d indices per-face)",
+			(m_meshingMode == MeshingMode::GREEDY) ? "greedy" : "per-face", totalFaces, vertexReduction, totalFaces * 4, totalFaces * 6);
+		DebugAddScreenText(meshingText, gameSceneBounds, 15.f, Vec2(0.f, 0.945f), 0.f);
+
+		// Vertex bytes as they are now against the same vertexes stored as Vertex_PCUTBN
+		float vertexKilobytes = static_cast<float>(totalVertices * sizeof(ChunkVertex)) / 1024.f;
+		float fullVertexKilobytes = static_cast<float>(totalVertices * sizeof(Vertex_PCUTBN)) / 1024.f;
+		std::string bytesText = Stringf("Mesh memory: vertices %.0f KB (%.0f KB as Vertex_PCUTBN), uploading %.0f KB/s",
+			vertexKilobytes, fullVertexKilobytes, m_meshBytesUploadedPerSecond / 1024.f);
+		DebugAddScreenText(bytesText, gameSceneBounds, 15.f, Vec2(0.f, 0.92f), 0.f);
+
+		// Per-chunk 32-bit index buffers would have held every chunk's indices; a full window scales the current average
+		float sharedIndexKilobytes = static_cast<float>(m_quadIndexCapacity * 6 * sizeof(unsigned int)) / 1024.f;
+		float perChunkIndexKilobytes = static_cast<float>(totalIndices * sizeof(unsigned int)) / 1024.f;
+		int numChunks = m_activeChunks.GetCount();
+		float fullWindowIndexKilobytes = (numChunks > 0) ? perChunkIndexKilobytes * static_cast<float>(MAX_ACTIVE_CHUNKS) / static_cast<float>(numChunks) : 0.f;
+		std::string indexText = Stringf("Quad index buffer: %d quads %.0f KB shared, saves %.0f KB of per-chunk indices (~%.0f KB over %d chunks)",
+			m_quadIndexCapacity, sharedIndexKilobytes, perChunkIndexKilobytes - sharedIndexKilobytes, fullWindowIndexKilobytes - sharedIndexKilobytes, MAX_ACTIVE_CHUNKS);
+		DebugAddScreenText(indexText, gameSceneBounds, 15.f, Vec2(0.f, 0.895f), 0.f);
+
+		WorldRenderStats const& renderStats = m_lastRenderStats;
+		std::string cullingText = Stringf("Frustum culling (%s): drawn %d, culled %d, %d group tests, %d chunk tests",
+			!m_frustumCullingEnabled ? "off" : (m_hierarchicalCullingEnabled ? "grouped" : "per chunk"), renderStats.m_numChunksDrawn, renderStats.m_numChunksCulled,
+			renderStats.m_numGroupTests, renderStats.m_numChunkTests);
+		DebugAddScreenText(cullingText, gameSceneBounds, 15.f, Vec2(0.f, 0.87f), 0.f);
+
+		// Chunks drawn plus those only the cave search hid are what frustum culling alone would draw
+		std::string occlusionText = Stringf("Cave occlusion (%s): drawn %d, frustum only %d, %d occluded, %d sections searched",
+			!m_occlusionCullingEnabled ? "off" : (renderStats.m_isOcclusionCullingActive ? "on" : "camera outside world"), renderStats.m_numChunksDrawn,
+			renderStats.m_numChunksDrawn + renderStats.m_numChunksOccluded, renderStats.m_numChunksOccluded, renderStats.m_numSectionsVisited);
+		DebugAddScreenText(occlusionText, gameSceneBounds, 15.f, Vec2(0.f, 0.845f), 0.f);
+
+		// Every acquire that missed the pool allocated a chunk and its block array
+		ChunkPoolStats const& poolStats = m_chunkPool.GetStats();
+		float poolHitRate = (poolStats.m_numAcquires > 0) ? (100.f * static_cast<float>(poolStats.m_numReused) / static_cast<float>(poolStats.m_numAcquires)) : 0.f;
+		std::string poolText = Stringf("Chunk pool: %.1f%% reused (%d of %d), %d allocations, %d freed, %d free (%.1f MB)",
+			poolHitRate, poolStats.m_numReused, poolStats.m_numAcquires, poolStats.m_numChunkAllocations, poolStats.m_numChunksFreed,
+			m_chunkPool.GetNumFreeChunks(), static_cast<float>(m_chunkPool.GetPooledByteCount()) / (1024.f * 1024.f));
+		DebugAddScreenText(poolText, gameSceneBounds, 15.f, Vec2(0.f, 0.82f), 0.f);
 	}
 
 	if (m_debugJobText)
 	{
-		std::string activeChunkText = Stringf("Chunks: %d", static_cast<int>(m_activeChunks.size()));
-		std::string pendingJobsText = Stringf("Pending Jobs: %d", static_cast<int>(g_theJobSystem->m_pendingJobs.size()));
-		std::string executingJobsText = Stringf("Executing Jobs: %d", static_cast<int>(g_theJobSystem->m_executingJobs.size()));
-		std::string completedJobsText = Stringf("Completed Jobs: %d", static_cast<int>(g_theJobSystem->m_completedJobs.size()));
-
+		std::string activeChunkText = Stringf("Chunks: %d (%d outside grid cells)", m_activeChunks.GetCount(), m_activeChunks.GetNumOverflowChunks());
+		std::string pendingJobsText = Stringf("Pending Jobs: %d compute, %d disk", static_cast<int>(g_theJobSystem->m_pendingJobs.size()),
+			static_cast<int>(g_theIOJobSystem->m_pendingJobs.size()));
+		std::string executingJobsText = Stringf("Executing Jobs: %d compute, %d disk", static_cast<int>(g_theJobSystem->m_executingJobs.size()),
+			static_cast<int>(g_theIOJobSystem->m_executingJobs.size()));
+		std::string completedJobsText = Stringf("Completed Jobs: %d compute, %d disk", static_cast<int>(g_theJobSystem->m_completedJobs.size()),
+			static_cast<int>(g_theIOJobSystem->m_completedJobs.size()));
+
+		ClimateCache const* climateCache = m_theGame->m_worldGenSettings.m_climateCache;
+		float caveEvaluatedPercent = (m_totalCaveCandidateBlocks > 0) ? 100.f * static_cast<float>(m_totalCaveBlocksEvaluated) / static_cast<float>(m_totalCaveCandidateBlocks) : 0.f;
+		DebugAddScreenText(Stringf("Cave blocks evaluated: %lld of %lld (%.1f%%), carved: %lld", m_totalCaveBlocksEvaluated, m_totalCaveCandidateBlocks, caveEvaluatedPercent, m_totalCaveBlocksCarved),
+			gameSceneBounds, 15.f, Vec2(0.f, 0.35f), 0.f);
+		DebugAddScreenText(Stringf("Climate regions cached: %d", climateCache ? climateCache->GetNumRegions() : 0), gameSceneBounds, 15.f, Vec2(0.f, 0.325f), 0.f);
+		DebugAddScreenText(Stringf("Chunks generated/sec: %.1f", m_chunksGeneratedPerSecond), gameSceneBounds, 15.f, Vec2(0.f, 0.3f), 0.f);
+		DebugAddScreenText(Stringf("Dirty meshes: %d (%d ready in range), wait avg %.0f ms max %.0f ms", static_cast<int>(m_dirtyMeshChunks.size()),
+			static_cast<int>(m_meshBuildHeap.size()), m_averageMeshWaitSeconds * 1000.f, m_maxMeshWaitSeconds * 1000.f), gameSceneBounds, 15.f, Vec2(0.f, 0.375f), 0.f);
+		DebugAddScreenText(Stringf("Meshing: %d", m_outstandingMeshJobs), gameSceneBounds, 15.f, Vec2(0.f, 0.425f), 0.f);
+
+		// Counted by the pass's CountingWorldRenderContext; the RenderCounts headless test compares against per-chunk setup
+		WorldRenderStats const& renderStats = m_lastRenderStats;
+		DebugAddScreenText(Stringf("World render: %d draws, %d state changes, %d constant uploads", renderStats.m_numChunksDrawn,
+			renderStats.m_numStateChanges, renderStats.m_numConstantUploads), gameSceneBounds, 15.f, Vec2(0.f, 0.45f), 0.f);
+		DebugAddScreenText(Stringf("Stale mesh results discarded: %d", m_numStaleMeshResults), gameSceneBounds, 15.f, Vec2(0.f, 0.4f), 0.f);
 		DebugAddScreenText(activeChunkText, gameSceneBounds, 15.f, Vec2(0.f, 0.275f), 0.f);
 		DebugAddScreenText(Stringf("Chunks pending save: %d", m_chunksQueuedForSave.size()), gameSceneBounds, 15.f, Vec2(0.f, 0.25f), 0.f);
 		DebugAddScreenText(Stringf("Chunks saving: %d", m_outstandingSaveJobs), gameSceneBounds, 15.f, Vec2(0.f, 0.225f), 0.f);
 		DebugAddScreenText(Stringf("Chunks pending load: %d", m_chunksQueuedForLoad.size()), gameSceneBounds, 15.f, Vec2(0.f, 0.2f), 0.f);
-		DebugAddScreenText(Stringf("Chunks loading: %d", m_outstandingLoadJobs), gameSceneBounds, 15.f, Vec2(0.f, 0.175f), 0.f);
+		DebugAddScreenText(Stringf("Chunks loading: %d, load latency avg %.0f ms max %.0f ms", m_outstandingLoadJobs, m_averageLoadSeconds * 1000.f,
+			m_maxLoadSeconds * 1000.f), gameSceneBounds, 15.f, Vec2(0.f, 0.175f), 0.f);
 		DebugAddScreenText(Stringf("Chunks pending generation: %d", m_chunksQueuedForGeneration.size()), gameSceneBounds, 15.f, Vec2(0.f, 0.15f), 0.f);
 		DebugAddScreenText(Stringf("Chunks generating: %d", m_outstandingGenerateJobs), gameSceneBounds, 15.f, Vec2(0.f, 0.125f), 0.f);
+		DebugAddScreenText(Stringf("Generation left out of range: %d dropped from queue, %d revoked before start, %d wasted (revoked mid-generation)",
+			m_numGenerationsDropped, m_numGenerationsRevoked, m_numGenerationsWasted), gameSceneBounds, 15.f, Vec2(0.f, 0.475f), 0.f);
+
+		// Budget, use and backlog per main thread stage, in priority order from the top
+		double totalBudgetSeconds = 0.0;
+		double totalUsedSeconds = 0.0;
+		int numStages = static_cast<int>(WorldUpdateStage::COUNT);
+		for (int stageIndex = 0; stageIndex < numStages; ++stageIndex)
+		{
+			WorldStageStats const& stats = m_stageStats[stageIndex];
+			totalBudgetSeconds += stats.m_budgetSeconds;
+			totalUsedSeconds += stats.m_usedSeconds;
+			DebugAddScreenText(Stringf("  %s: %.0f of %.0f us (budget %.0f), avg %.0f max %.0f us, %d done, %d left", WORLD_STAGE_CONFIGS[stageIndex].m_name,
+				stats.m_usedSeconds * 1000000.0, stats.m_grantedSeconds * 1000000.0, stats.m_budgetSeconds * 1000000.0, stats.m_averageUsedSeconds * 1000000.f,
+				stats.m_maxUsedSeconds * 1000000.f, stats.m_numItems, stats.m_backlog), gameSceneBounds, 15.f, Vec2(0.f, 0.5f + 0.025f * static_cast<float>(numStages - 1 - stageIndex)), 0.f);
+		}
+		DebugAddScreenText(Stringf("World update stages: %.0f of %.0f us", totalUsedSeconds * 1000000.0, totalBudgetSeconds * 1000000.0),
+			gameSceneBounds, 15.f, Vec2(0.f, 0.5f + 0.025f * static_cast<float>(numStages)), 0.f);
 		DebugAddScreenText("JobSystem: ", gameSceneBounds, 15.f, Vec2(0.f, 0.1f), 0.f);
 		DebugAddScreenText(pendingJobsText, gameSceneBounds, 15.f, Vec2(0.f, 0.075f), 0.f);
 		DebugAddScreenText(executingJobsText, gameSceneBounds, 15.f, Vec2(0.f, 0.05f), 0.f);
@@ -138,162 +700,379 @@ void World::RenderDebugModes() const
 	}
 }
 
-void World::DeactivateFurthestChunk(Vec2 const& cameraPosXY)
+int World::DeactivateDistantChunks(Vec2 const& cameraPosXY, double deadline)
+{
+	int numDeactivated = 0;
+	while (DeactivateFurthestChunk(cameraPosXY))
+	{
+		numDeactivated += 1;
+		if (GetCurrentTimeSeconds() >= deadline)
+		{
+			break;
+		}
+	}
+	return numDeactivated;
+}
+
+bool World::DeactivateFurthestChunk(Vec2 const& cameraPosXY)
 {
 	Chunk* farthestChunk = nullptr;
 	float farthestDistSq = 0.f;
+	m_numChunksOutOfRange = 0;
 
-	for (auto const& pair : m_activeChunks)
+	m_activeChunks.ForEachChunk([&](Chunk* chunk)
 	{
-		Chunk* chunk = pair.second;
 		IntVec2 chunkCenter = IntVec2(chunk->GetChunkCenter(chunk->m_chunkCoords));
 		Vec2 chunkCenterAsVec2 = Vec2(static_cast<float>(chunkCenter.x), static_cast<float>(chunkCenter.y));
 		float distSq = GetDistanceSquared2D(cameraPosXY, chunkCenterAsVec2);
 
-		if (distSq > CHUNK_DEACTIVATION_RANGE * CHUNK_DEACTIVATION_RANGE && distSq > farthestDistSq)
+		if (distSq > CHUNK_DEACTIVATION_RANGE * CHUNK_DEACTIVATION_RANGE)
 		{
-			farthestDistSq = distSq;
-			farthestChunk = chunk;
+			m_numChunksOutOfRange += 1;
+			if (distSq > farthestDistSq)
+			{
+				farthestDistSq = distSq;
+				farthestChunk = chunk;
+			}
 		}
-	}
+	});
 
-	if (farthestChunk)
+	if (farthestChunk == nullptr)
 	{
-		DeActivateChunk(farthestChunk);
+		return false;
 	}
+	DeActivateChunk(farthestChunk);
+	m_numChunksOutOfRange -= 1;
+	return true;
 }
 
-void World::QueueClosestMissingChunk(Vec2 const& cameraPosXY)
+int World::QueueClosestMissingChunk(Vec2 const& cameraPosXY, double deadline)
 {
-	if (static_cast<int>(m_activeChunks.size()) >= MAX_ACTIVE_CHUNKS)
+	IntVec2 cameraChunkCoords = GetChunkCoordsFromWorldPos(cameraPosXY);
+	if (m_isChunkPresentInWindow.empty() || cameraChunkCoords.x != m_activationWindowCenter.x || cameraChunkCoords.y != m_activationWindowCenter.y)
 	{
-		return;
+		RecenterActivationWindow(cameraChunkCoords);
 	}
 
-	IntVec2 cameraChunkCoords = GetChunkCoordsFromWorldPos(cameraPosXY);
-	IntVec2 closestCoords = IntVec2::ZERO;
-	float   closestDistSq = FLT_MAX;
-	int     chunksToProcess = 25;
-
-	for (int chunkX = -CHUNK_ACTIVATION_RADIUS_X; chunkX <= CHUNK_ACTIVATION_RADIUS_X; ++chunkX)
+	// Offsets behind the cursor are already present, so each frame only looks at what is new.
+	// The deadline is checked after each activation, since each one looks for a save file on disk
+	int numActivated = 0;
+	while (m_activationCursor < static_cast<int>(m_activationOffsets.size()))
 	{
-		for (int chunkY = -CHUNK_ACTIVATION_RADIUS_Y; chunkY <= CHUNK_ACTIVATION_RADIUS_Y; ++chunkY)
+		if (m_activeChunks.GetCount() >= MAX_ACTIVE_CHUNKS || (numActivated > 0 && GetCurrentTimeSeconds() >= deadline))
 		{
-			if (chunksToProcess <= 0)
-			{
-				return;
-			}
+			return numActivated;
+		}
+
+		IntVec2 coords = cameraChunkCoords + m_activationOffsets[m_activationCursor];
+		if (!m_isChunkPresentInWindow[GetActivationWindowIndex(coords)])
+		{
+			Chunk* newChunk = m_chunkPool.Acquire(coords);
+			ActivateChunk(newChunk);
+			numActivated += 1;
+		}
+		m_activationCursor += 1;
+	}
+	return numActivated;
+}
 
-			IntVec2 coords = cameraChunkCoords + IntVec2(chunkX, chunkY);
-			if (m_activeChunks.find(coords) != m_activeChunks.end())
+void World::BuildActivationOffsets()
+{
+	// Every chunk whose center is within activation range of the camera chunk's center
+	int activationRangeSq = CHUNK_ACTIVATION_RANGE * CHUNK_ACTIVATION_RANGE;
+	m_activationOffsets.clear();
+	for (int offsetY = -CHUNK_ACTIVATION_RADIUS_Y; offsetY <= CHUNK_ACTIVATION_RADIUS_Y; ++offsetY)
+	{
+		for (int offsetX = -CHUNK_ACTIVATION_RADIUS_X; offsetX <= CHUNK_ACTIVATION_RADIUS_X; ++offsetX)
+		{
+			int offsetDistSq = (offsetX * CHUNK_SIZE_X) * (offsetX * CHUNK_SIZE_X) + (offsetY * CHUNK_SIZE_Y) * (offsetY * CHUNK_SIZE_Y);
+			if (offsetDistSq <= activationRangeSq)
 			{
-				continue;
+				m_activationOffsets.push_back(IntVec2(offsetX, offsetY));
 			}
+		}
+	}
 
-			Vec2 chunkCenter = Vec2(coords.x * CHUNK_SIZE_X + CHUNK_SIZE_X / 2.f, coords.y * CHUNK_SIZE_Y + CHUNK_SIZE_Y / 2.f);
-			float distSq = GetDistanceSquared2D(cameraPosXY, chunkCenter);
+	// Nearest first, ties keep their row order so activation is deterministic
+	std::stable_sort(m_activationOffsets.begin(), m_activationOffsets.end(), [](IntVec2 const& a, IntVec2 const& b)
+	{
+		int aDistSq = (a.x * CHUNK_SIZE_X) * (a.x * CHUNK_SIZE_X) + (a.y * CHUNK_SIZE_Y) * (a.y * CHUNK_SIZE_Y);
+		int bDistSq = (b.x * CHUNK_SIZE_X) * (b.x * CHUNK_SIZE_X) + (b.y * CHUNK_SIZE_Y) * (b.y * CHUNK_SIZE_Y);
+		return aDistSq < bDistSq;
+	});
+}
 
-			if (distSq <= CHUNK_ACTIVATION_RANGE * CHUNK_ACTIVATION_RANGE && distSq < closestDistSq)
-			{
-				closestDistSq = distSq;
-				closestCoords = coords;
+void World::RecenterActivationWindow(IntVec2 const& cameraChunkCoords)
+{
+	m_activationWindowCenter = cameraChunkCoords;
+	m_activationCursor = 0;
+	m_isChunkPresentInWindow.assign(ACTIVATION_WINDOW_SIZE_X * ACTIVATION_WINDOW_SIZE_Y, false);
 
-				Chunk* newChunk = new Chunk(closestCoords);
-				ActivateChunk(newChunk);
-				chunksToProcess -= 1;
-			}
-		}
+	m_activeChunks.ForEachChunk([this](Chunk* chunk)
+	{
+		SetChunkPresentInWindow(chunk->m_chunkCoords, true);
+	});
+	for (IntVec2 const& activatingCoords : m_activatingChunkCoords)
+	{
+		SetChunkPresentInWindow(activatingCoords, true);
 	}
 }
 
-void World::UpdateMeshBuildQueue(Vec2 const& cameraPosXY)
+int World::GetActivationWindowIndex(IntVec2 const& chunkCoords) const
 {
-	m_meshBuildQueue.clear();
+	int windowX = chunkCoords.x - m_activationWindowCenter.x + CHUNK_ACTIVATION_RADIUS_X;
+	int windowY = chunkCoords.y - m_activationWindowCenter.y + CHUNK_ACTIVATION_RADIUS_Y;
+	if (windowX < 0 || windowX >= ACTIVATION_WINDOW_SIZE_X || windowY < 0 || windowY >= ACTIVATION_WINDOW_SIZE_Y)
+	{
+		return -1;
+	}
+	return windowY * ACTIVATION_WINDOW_SIZE_X + windowX;
+}
 
-	// Gather dirty chunks that within build range
-	for (auto& pair : m_activeChunks)
+void World::SetChunkPresentInWindow(IntVec2 const& chunkCoords, bool isPresent)
+{
+	int windowIndex = GetActivationWindowIndex(chunkCoords);
+	if (windowIndex >= 0 && !m_isChunkPresentInWindow.empty())
 	{
-		Chunk* chunk = pair.second;
-		if (chunk && chunk->m_isMeshDirty)
-		{
-			IntVec2 chunkCenter = chunk->GetChunkCenter(chunk->m_chunkCoords);
-			Vec2 chunkCenterVec2(static_cast<float>(chunkCenter.x), static_cast<float>(chunkCenter.y));
-			float chunkDistSquared = GetDistanceSquared2D(cameraPosXY, chunkCenterVec2);
+		m_isChunkPresentInWindow[windowIndex] = isPresent;
+	}
+}
 
-			if (chunkDistSquared <= CHUNK_MESH_BUILD_RANGE)
-			{
-				m_meshBuildQueue.push_back(chunk);
-			}
-		}
+// Heap comparator; the std heap functions keep the largest on top, so this makes it a min-heap
+static bool IsFartherMeshBuild(MeshBuildQueueEntry const& a, MeshBuildQueueEntry const& b)
+{
+	return a.m_distSquared > b.m_distSquared;
+}
+
+void World::UpdateMeshBuildQueue(Vec2 const& cameraPosXY)
+{
+	// Keys are relative to the camera chunk, so they only change when the camera crosses into another chunk
+	IntVec2 cameraChunkCoords = GetChunkCoordsFromWorldPos(cameraPosXY);
+	if (!m_isMeshBuildHeapStale && cameraChunkCoords.x == m_meshBuildCameraChunkCoords.x && cameraChunkCoords.y == m_meshBuildCameraChunkCoords.y)
+	{
+		return;
 	}
 
-	// Sort mesh build queue by distance to camera
-	for (int chunkMeshIndex = 0; chunkMeshIndex < static_cast<int>(m_meshBuildQueue.size()); ++chunkMeshIndex)
+	m_meshBuildCameraChunkCoords = cameraChunkCoords;
+	m_isMeshBuildHeapStale = false;
+	m_meshBuildHeap.clear();
+	for (Chunk* chunk : m_dirtyMeshChunks)
 	{
-		int closestChunkIndex = chunkMeshIndex;
-		float closestChunkDistSquared = GetChunkDistSquaredToCamera(m_meshBuildQueue[chunkMeshIndex], cameraPosXY);
+		chunk->m_isInMeshBuildHeap = false;
+		PushMeshBuildIfReady(chunk);
+	}
+}
 
-		for (int nextChunkMeshIndex = chunkMeshIndex + 1; nextChunkMeshIndex < static_cast<int>(m_meshBuildQueue.size()); ++nextChunkMeshIndex)
+int World::BuildMeshesThisFrame(double deadline)
+{
+	// A stale heap may hold chunks that have since been deactivated; it is rebuilt next frame
+	int numDispatched = 0;
+	while (!m_isMeshBuildHeapStale && !m_meshBuildHeap.empty() && m_outstandingMeshJobs < MAX_MESH_JOBS)
+	{
+		if (numDispatched > 0 && GetCurrentTimeSeconds() >= deadline)
 		{
-			float nextChunkDistSquared = GetChunkDistSquaredToCamera(m_meshBuildQueue[nextChunkMeshIndex], cameraPosXY);
-			if (nextChunkDistSquared < closestChunkDistSquared)
-			{
-				closestChunkDistSquared = nextChunkDistSquared;
-				closestChunkIndex = nextChunkMeshIndex;
-			}
+			break;
 		}
 
-		if (closestChunkIndex != chunkMeshIndex)
+		std::pop_heap(m_meshBuildHeap.begin(), m_meshBuildHeap.end(), IsFartherMeshBuild);
+		Chunk* chunk = m_meshBuildHeap.back().m_chunk;
+		m_meshBuildHeap.pop_back();
+		chunk->m_isInMeshBuildHeap = false;
+
+		// A neighbor left since it was queued; it is pushed again when the neighbor returns
+		if (!IsChunkReadyForMesh(chunk))
 		{
-			std::swap(m_meshBuildQueue[chunkMeshIndex], m_meshBuildQueue[closestChunkIndex]);
+			continue;
 		}
+
+		DispatchMeshJob(chunk);
+		numDispatched += 1;
 	}
+	return numDispatched;
 }
 
-void World::BuildMeshesThisFrame()
+void World::DispatchMeshJob(Chunk* chunk)
 {
-	ProcessDirtyLighting();
-	int chunkBuildCount = 0;
+	// The snapshot is the only main thread work besides the upload
+	BuildChunkMeshJob* meshJob = AcquireJob(m_freeMeshJobs);
+	meshJob->m_chunk = chunk;
+	meshJob->m_completions = &m_meshCompletions;
+	chunk->CaptureMeshSnapshot(meshJob->m_snapshot);
+	chunk->m_isMeshJobInFlight = true;
+	m_outstandingMeshJobs += 1;
+	g_theJobSystem->AddJobToSystem(meshJob);
+}
 
-	for (int chunkMeshIndex = 0; chunkMeshIndex < static_cast<int>(m_meshBuildQueue.size()); ++chunkMeshIndex)
+void World::FinishMeshJob(BuiltChunkMeshResult& meshResult)
+{
+	// The chunk may have been deactivated, or deactivated and reactivated, while the job ran
+	Chunk* chunk = m_activeChunks.Find(meshResult.m_chunkCoords);
+	if (chunk != meshResult.m_chunk)
 	{
-		if (chunkBuildCount >= MAX_MESHES_PER_FRAME)
-		{
-			break;
-		}
+		m_numStaleMeshResults += 1;
+		return;
+	}
 
-		Chunk* chunk = m_meshBuildQueue[chunkMeshIndex];
+	chunk->m_isMeshJobInFlight = false;
+	if (chunk->m_meshEditGeneration != meshResult.m_editGeneration)
+	{
+		m_numStaleMeshResults += 1;
+		PushMeshBuildIfReady(chunk);
+		return;
+	}
 
-		if (chunk && chunk->m_isMeshDirty)
-		{
-			// Wait to generate until all neighbors are active
-			if (!chunk->m_northNeighbor || !chunk->m_southNeighbor || !chunk->m_eastNeighbor || !chunk->m_westNeighbor)
-			{
-				continue;
-			}
+	chunk->SetMesh(meshResult.m_vertexes);
+	chunk->m_meshStats = meshResult.m_meshStats;
+	chunk->m_visibility = meshResult.m_visibility;
+	EnsureQuadIndexCapacity(chunk->GetQuadCount());
+	m_meshBytesUploadedThisWindow += chunk->GetMeshByteCount();
 
-			chunk->GenerateChunkMesh();
-			chunk->m_isMeshDirty = false;
-			chunkBuildCount += 1;
-		}
+	double waitSeconds = GetCurrentTimeSeconds() - chunk->m_meshDirtyTime;
+	m_meshesBuiltThisWindow += 1;
+	m_meshWaitSecondsThisWindow += waitSeconds;
+	m_maxMeshWaitThisWindow = (waitSeconds > m_maxMeshWaitThisWindow) ? waitSeconds : m_maxMeshWaitThisWindow;
+	RemoveFromMeshBuildQueue(chunk);
+}
+
+void World::MarkChunkMeshDirty(Chunk* chunk)
+{
+	chunk->m_isMeshDirty = true;
+	chunk->m_meshEditGeneration = ++m_nextMeshEditGeneration;
+	if (chunk->m_meshDirtyIndex < 0)
+	{
+		chunk->m_meshDirtyIndex = static_cast<int>(m_dirtyMeshChunks.size());
+		chunk->m_meshDirtyTime = GetCurrentTimeSeconds();
+		m_dirtyMeshChunks.push_back(chunk);
 	}
+	PushMeshBuildIfReady(chunk);
+}
 
-	CleanUpMeshBuildQueue();
+void World::RemoveFromMeshBuildQueue(Chunk* chunk)
+{
+	chunk->m_isMeshDirty = false;
+	if (chunk->m_meshDirtyIndex >= 0)
+	{
+		// Swap with the last dirty chunk so removal is O(1)
+		Chunk* lastChunk = m_dirtyMeshChunks.back();
+		m_dirtyMeshChunks[chunk->m_meshDirtyIndex] = lastChunk;
+		lastChunk->m_meshDirtyIndex = chunk->m_meshDirtyIndex;
+		m_dirtyMeshChunks.pop_back();
+		chunk->m_meshDirtyIndex = -1;
+	}
+
+	// Heap entries can't be removed in place, so a chunk leaving while queued forces a rebuild
+	if (chunk->m_isInMeshBuildHeap)
+	{
+		chunk->m_isInMeshBuildHeap = false;
+		m_isMeshBuildHeapStale = true;
+	}
 }
 
-void World::CleanUpMeshBuildQueue()
+void World::PushMeshBuildIfReady(Chunk* chunk)
 {
-	for (int meshIndex = 0; meshIndex < static_cast<int>(m_meshBuildQueue.size());)
+	if (!chunk->m_isMeshDirty || chunk->m_isInMeshBuildHeap || chunk->m_isMeshJobInFlight || m_isMeshBuildHeapStale || !IsChunkReadyForMesh(chunk))
 	{
-		if (!m_meshBuildQueue[meshIndex]->m_isMeshDirty)
+		return;
+	}
+
+	int distSquared = GetMeshBuildDistSquared(chunk);
+	if (distSquared * CHUNK_SIZE_X * CHUNK_SIZE_Y > CHUNK_MESH_BUILD_RANGE)
+	{
+		return;
+	}
+
+	MeshBuildQueueEntry entry;
+	entry.m_distSquared = distSquared;
+	entry.m_chunk = chunk;
+	m_meshBuildHeap.push_back(entry);
+	std::push_heap(m_meshBuildHeap.begin(), m_meshBuildHeap.end(), IsFartherMeshBuild);
+	chunk->m_isInMeshBuildHeap = true;
+}
+
+bool World::IsChunkReadyForMesh(Chunk const* chunk) const
+{
+	// Faces on the chunk border need all four neighbors
+	return chunk->m_northNeighbor && chunk->m_southNeighbor && chunk->m_eastNeighbor && chunk->m_westNeighbor;
+}
+
+int World::GetMeshBuildDistSquared(Chunk const* chunk) const
+{
+	int offsetX = chunk->m_chunkCoords.x - m_meshBuildCameraChunkCoords.x;
+	int offsetY = chunk->m_chunkCoords.y - m_meshBuildCameraChunkCoords.y;
+	return offsetX * offsetX + offsetY * offsetY;
+}
+
+void World::UpdateGenerationQueue(Vec2 const& cameraPosXY)
+{
+	float deactivationRangeSq = static_cast<float>(CHUNK_DEACTIVATION_RANGE * CHUNK_DEACTIVATION_RANGE);
+	auto isOutOfRange = [&](Chunk const* chunk)
+	{
+		IntVec2 chunkCenter = chunk->GetChunkCenter(chunk->m_chunkCoords);
+		return GetDistanceSquared2D(cameraPosXY, Vec2(static_cast<float>(chunkCenter.x), static_cast<float>(chunkCenter.y))) > deactivationRangeSq;
+	};
+
+	// Requests the camera left behind before dispatch go straight back to the pool
+	auto firstDropped = std::remove_if(m_chunksQueuedForGeneration.begin(), m_chunksQueuedForGeneration.end(), [&](Chunk* chunk)
+	{
+		if (!isOutOfRange(chunk))
 		{
-			m_meshBuildQueue.erase(m_meshBuildQueue.begin() + meshIndex);
+			return false;
 		}
-		else
+		m_activatingChunkCoords.erase(chunk->m_chunkCoords);
+		SetChunkPresentInWindow(chunk->m_chunkCoords, false);
+		m_chunkPool.Release(chunk);
+		m_numGenerationsDropped += 1;
+		return true;
+	});
+	m_chunksQueuedForGeneration.erase(firstDropped, m_chunksQueuedForGeneration.end());
+
+	// Dispatched ones are revoked; the job still owns the chunk until it comes back
+	for (Chunk* chunk : m_chunksGenerating)
+	{
+		if (isOutOfRange(chunk))
+		{
+			RevokeGeneration(chunk);
+		}
+	}
+
+	// Nearest first from where the camera is now, not from where it was when each chunk was queued
+	IntVec2 cameraChunkCoords = GetChunkCoordsFromWorldPos(cameraPosXY);
+	if (cameraChunkCoords.x != m_generationQueueCameraChunkCoords.x || cameraChunkCoords.y != m_generationQueueCameraChunkCoords.y)
+	{
+		m_generationQueueCameraChunkCoords = cameraChunkCoords;
+		m_isGenerationQueueStale = true;
+	}
+	if (m_isGenerationQueueStale)
+	{
+		std::stable_sort(m_chunksQueuedForGeneration.begin(), m_chunksQueuedForGeneration.end(), [&cameraChunkCoords](Chunk const* a, Chunk const* b)
+		{
+			int aOffsetX = a->m_chunkCoords.x - cameraChunkCoords.x;
+			int aOffsetY = a->m_chunkCoords.y - cameraChunkCoords.y;
+			int bOffsetX = b->m_chunkCoords.x - cameraChunkCoords.x;
+			int bOffsetY = b->m_chunkCoords.y - cameraChunkCoords.y;
+			return aOffsetX * aOffsetX + aOffsetY * aOffsetY < bOffsetX * bOffsetX + bOffsetY * bOffsetY;
+		});
+		m_isGenerationQueueStale = false;
+	}
+}
+
+bool World::RevokeGeneration(Chunk* chunk)
+{
+	// Only one side wins each transition: a worker that already finished keeps its chunk, which then deactivates normally
+	ChunkState expectedState = ChunkState::ACTIVATING_QUEUED_GENERATE;
+	if (!chunk->m_chunkState.compare_exchange_strong(expectedState, ChunkState::ACTIVATING_GENERATE_REVOKED))
+	{
+		if (expectedState != ChunkState::ACTIVATING_GENERATING ||
+			!chunk->m_chunkState.compare_exchange_strong(expectedState, ChunkState::ACTIVATING_GENERATE_REVOKED))
 		{
-			++meshIndex;
+			return false;
 		}
 	}
+
+	// Free to activate again right away with a new chunk, even while this one's job is still out
+	m_activatingChunkCoords.erase(chunk->m_chunkCoords);
+	SetChunkPresentInWindow(chunk->m_chunkCoords, false);
+	return true;
 }
 
 void World::DispatchGenerateJobs()
@@ -303,10 +1082,13 @@ void World::DispatchGenerateJobs()
 		Chunk* chunk = m_chunksQueuedForGeneration.front();
 		m_chunksQueuedForGeneration.pop_front();
 
-		chunk->m_chunkState.store(ChunkState::ACTIVATING_GENERATING);
-
-		GenerateChunkJob* job = new GenerateChunkJob(chunk);
+		// Stays ACTIVATING_QUEUED_GENERATE until a worker claims it, so it can still be revoked for free
+		GenerateChunkJob* job = AcquireJob(m_freeGenerateJobs);
+		job->m_chunk = chunk;
+		job->m_settings = m_theGame->m_worldGenSettings;
+		job->m_completions = &m_generateCompletions;
 		g_theJobSystem->AddJobToSystem(job);
+		m_chunksGenerating.push_back(chunk);
 		m_outstandingGenerateJobs += 1;
 
 		if (m_outstandingGenerateJobs >= MAX_GENERATION_JOBS)
@@ -326,8 +1108,11 @@ void World::DispatchLoadAndSaveJobs()
 
 		chunk->m_chunkState.store(ChunkState::ACTIVATING_LOADING);
 
-		LoadChunkJob* job = new LoadChunkJob(chunk);
-		g_theJobSystem->AddJobToSystem(job);
+		LoadChunkJob* job = AcquireJob(m_freeLoadJobs);
+		job->m_chunk = chunk;
+		job->m_dispatchTime = GetCurrentTimeSeconds();
+		job->m_completions = &m_loadCompletions;
+		g_theIOJobSystem->AddJobToSystem(job);
 		m_outstandingLoadJobs += 1;
 	}
 
@@ -339,64 +1124,125 @@ void World::DispatchLoadAndSaveJobs()
 
 		chunk->m_chunkState.store(ChunkState::DEACTIVATING_SAVING);
 
-		SaveChunkJob* job = new SaveChunkJob(chunk);
-		g_theJobSystem->AddJobToSystem(job);
+		SaveChunkJob* job = AcquireJob(m_freeSaveJobs);
+		job->m_chunk = chunk;
+		job->m_completions = &m_saveCompletions;
+		g_theIOJobSystem->AddJobToSystem(job);
 		m_outstandingSaveJobs += 1;
 	}
 }
 
-void World::ProcessCompletedJobs()
+int World::ProcessCompletedJobs(double deadline)
+{
+	for (JobSystem* jobSystem : { g_theJobSystem, g_theIOJobSystem })
+	{
+		RecycleCompletedJobs(jobSystem);
+	}
+
+	// Each channel is drained in one pass, then its results are handled in order until the deadline.
+	// Results still waiting count as outstanding jobs, so the channels never hold more than their limits
+	m_generateCompletions.DrainInto(m_generateResults);
+	m_loadCompletions.DrainInto(m_loadResults);
+	m_saveCompletions.DrainInto(m_saveResults);
+	m_meshCompletions.DrainInto(m_meshResults);
+
+	int numFinished = 0;
+	numFinished += FinishResultsUntil(m_generateResults, deadline, [this](GeneratedChunkResult const& generateResult)
+	{
+		FinishGenerateJob(generateResult);
+	});
+	numFinished += FinishResultsUntil(m_loadResults, deadline, [this](LoadedChunkResult const& loadResult)
+	{
+		FinishLoadJob(loadResult);
+	});
+	numFinished += FinishResultsUntil(m_saveResults, deadline, [this](SavedChunkResult const& saveResult)
+	{
+		FinishSaveJob(saveResult);
+	});
+	numFinished += FinishResultsUntil(m_meshResults, deadline, [this](BuiltChunkMeshResult& meshResult)
+	{
+		FinishMeshJob(meshResult);
+		m_outstandingMeshJobs -= 1;
+	});
+	return numFinished;
+}
+
+void World::RecycleCompletedJobs(JobSystem* jobSystem)
 {
+	// The world adds nothing but chunk jobs, and their results already went through the channels.
+	// The job system still holds a job after Execute returns, so it is only reusable once handed back here
 	Job* completedJob = nullptr;
-	while ((completedJob = g_theJobSystem->RetreiveCompletedJob()) != nullptr)
+	while ((completedJob = jobSystem->RetreiveCompletedJob()) != nullptr)
 	{
-		if (GenerateChunkJob* genJob = dynamic_cast<GenerateChunkJob*>(completedJob))
-		{
-			Chunk* chunk = genJob->m_chunk;
-			if (chunk->m_chunkState.load() == ChunkState::ACTIVATING_GENERATE_COMPLETE)
-			{
-				FinalizeActivatedChunk(chunk);
-			}
-			delete genJob;
-			m_outstandingGenerateJobs -= 1;
-		}
-		else if (LoadChunkJob* loadJob = dynamic_cast<LoadChunkJob*>(completedJob))
-		{
-			Chunk* chunk = loadJob->m_chunk;
-			if (chunk->m_chunkState.load() == ChunkState::ACTIVATING_LOAD_COMPLETE)
-			{
-				FinalizeActivatedChunk(chunk);
-			}
-			delete loadJob;
-			m_outstandingLoadJobs -= 1;
-		}
-		else if (SaveChunkJob* saveJob = dynamic_cast<SaveChunkJob*>(completedJob))
-		{
-			Chunk* chunk = saveJob->m_chunk;
-			if (chunk->m_chunkState.load() == ChunkState::DEACTIVATING_SAVE_COMPLETE)
-			{
-				chunk->DeleteBuffers();
-				delete chunk;
-			}
-			delete saveJob;
-			m_outstandingSaveJobs -= 1;
-		}
-		else
+		ChunkJob* chunkJob = static_cast<ChunkJob*>(completedJob);
+		switch (chunkJob->m_chunkJobType)
 		{
-			delete completedJob;
+			case ChunkJobType::GENERATE:   m_freeGenerateJobs.push_back(static_cast<GenerateChunkJob*>(chunkJob)); break;
+			case ChunkJobType::LOAD:       m_freeLoadJobs.push_back(static_cast<LoadChunkJob*>(chunkJob));         break;
+			case ChunkJobType::SAVE:       m_freeSaveJobs.push_back(static_cast<SaveChunkJob*>(chunkJob));         break;
+			case ChunkJobType::BUILD_MESH: m_freeMeshJobs.push_back(static_cast<BuildChunkMeshJob*>(chunkJob));    break;
 		}
 	}
 }
 
+void World::FinishGenerateJob(GeneratedChunkResult const& generateResult)
+{
+	Chunk* chunk = generateResult.m_chunk;
+	m_chunksGenerating.erase(std::find(m_chunksGenerating.begin(), m_chunksGenerating.end(), chunk));
+	ChunkState chunkState = chunk->m_chunkState.load();
+	if (chunkState == ChunkState::ACTIVATING_GENERATE_COMPLETE)
+	{
+		m_totalCaveCandidateBlocks += chunk->m_caveStats.m_numCandidateBlocks;
+		m_totalCaveBlocksEvaluated += chunk->m_caveStats.m_numBlocksEvaluated;
+		m_totalCaveBlocksCarved += chunk->m_caveStats.m_numBlocksCarved;
+		FinalizeActivatedChunk(chunk);
+	}
+	else if (chunkState == ChunkState::ACTIVATING_GENERATE_REVOKED)
+	{
+		m_numGenerationsRevoked += generateResult.m_didGenerate ? 0 : 1;
+		m_numGenerationsWasted += generateResult.m_didGenerate ? 1 : 0;
+		m_chunkPool.Release(chunk);
+	}
+	m_chunksGeneratedThisWindow += generateResult.m_didGenerate ? 1 : 0;
+	m_outstandingGenerateJobs -= 1;
+}
+
+void World::FinishLoadJob(LoadedChunkResult const& loadResult)
+{
+	Chunk* chunk = loadResult.m_chunk;
+	if (chunk->m_chunkState.load() == ChunkState::ACTIVATING_LOAD_COMPLETE)
+	{
+		FinalizeActivatedChunk(chunk);
+	}
+	double loadSeconds = GetCurrentTimeSeconds() - loadResult.m_dispatchTime;
+	m_chunksLoadedThisWindow += 1;
+	m_loadSecondsThisWindow += loadSeconds;
+	m_maxLoadThisWindow = (loadSeconds > m_maxLoadThisWindow) ? loadSeconds : m_maxLoadThisWindow;
+	m_outstandingLoadJobs -= 1;
+}
+
+void World::FinishSaveJob(SavedChunkResult const& saveResult)
+{
+	Chunk* chunk = saveResult.m_chunk;
+	if (chunk->m_chunkState.load() == ChunkState::DEACTIVATING_SAVE_COMPLETE)
+	{
+		m_chunkPool.Release(chunk);
+	}
+	m_outstandingSaveJobs -= 1;
+}
+
 void World::ActivateChunk(Chunk* chunkToActivate)
 {
-	if (m_activeChunks.find(chunkToActivate->m_chunkCoords) != m_activeChunks.end())
+	if (m_activeChunks.Contains(chunkToActivate->m_chunkCoords))
 	{
 		return;
 	}
 
-	std::string filename = Stringf("Saves/Chunk(%i,%i).chunk", chunkToActivate->m_chunkCoords.x, chunkToActivate->m_chunkCoords.y);
-	if (DoesFileExist(filename))
+	// Present from now on, so the activation cursor never queues the same chunk twice
+	m_activatingChunkCoords.insert(chunkToActivate->m_chunkCoords);
+	SetChunkPresentInWindow(chunkToActivate->m_chunkCoords, true);
+
+	if (DoesFileExist(Chunk::GetSaveFilePath(chunkToActivate->m_chunkCoords)))
 	{
 		chunkToActivate->m_chunkState.store(ChunkState::ACTIVATING_QUEUED_LOAD);
 		m_chunksQueuedForLoad.push_back(chunkToActivate);
@@ -405,79 +1251,178 @@ void World::ActivateChunk(Chunk* chunkToActivate)
 	{
 		chunkToActivate->m_chunkState.store(ChunkState::ACTIVATING_QUEUED_GENERATE);
 		m_chunksQueuedForGeneration.push_back(chunkToActivate);
+		m_isGenerationQueueStale = true;
 	}
 }
 
 void World::FinalizeActivatedChunk(Chunk* chunkToActivate)
 {
-	if (m_activeChunks.find(chunkToActivate->m_chunkCoords) != m_activeChunks.end())
+	m_activatingChunkCoords.erase(chunkToActivate->m_chunkCoords);
+	if (m_activeChunks.Contains(chunkToActivate->m_chunkCoords))
 	{
 		return;
 	}
 
 	// Add to active chunks
-	m_activeChunks[chunkToActivate->m_chunkCoords] = chunkToActivate;
+	m_activeChunks.Insert(chunkToActivate);
 
 	// Mark mesh dirty so it'll be processed
-	chunkToActivate->m_isMeshDirty = true;
+	MarkChunkMeshDirty(chunkToActivate);
 
 	// This chunk has just been activated from a clean state
 	chunkToActivate->m_needsSaving = false;
 
+	// Decoration from neighbors that activated first, before lighting sees the blocks
+	ApplyPendingBlockWrites(chunkToActivate);
+
 	// Hook up neighbors
 	HookUpNeighbors(chunkToActivate);
 
 	// Initialize lighting
 	InitializeChunkLighting(chunkToActivate);
+
+	// Decoration this chunk generated for its neighbors
+	DistributeOutgoingBlockWrites(chunkToActivate);
+}
+
+void World::ApplyPendingBlockWrites(Chunk* chunkToActivate)
+{
+	// Writes left on disk by WorldPregen or an earlier session are applied once, then live on in the chunk's own save
+	IntVec2 const& chunkCoords = chunkToActivate->m_chunkCoords;
+	std::vector<PendingBlockWrite> blockWrites;
+	std::string writesFilename = Chunk::GetPendingWritesFilePath(chunkCoords);
+	if (DoesFileExist(writesFilename))
+	{
+		if (!Chunk::ReadPendingWritesFromFile(chunkCoords, blockWrites))
+		{
+			DebuggerPrintf("Ignoring corrupt pending writes in %s\n", writesFilename.c_str());
+		}
+		std::remove(writesFilename.c_str());
+	}
+
+	auto foundWrites = m_pendingBlockWrites.find(chunkCoords);
+	if (foundWrites != m_pendingBlockWrites.end())
+	{
+		blockWrites.insert(blockWrites.end(), foundWrites->second.begin(), foundWrites->second.end());
+		m_pendingBlockWrites.erase(foundWrites);
+	}
+
+	if (!blockWrites.empty() && chunkToActivate->ApplyBlockWrites(blockWrites) > 0)
+	{
+		chunkToActivate->m_needsSaving = true;
+	}
+}
+
+void World::DistributeOutgoingBlockWrites(Chunk* chunkToActivate)
+{
+	// A generated chunk is normally regenerated on its next visit; one that decorates its neighbors is saved
+	// instead, so they receive its writes once rather than getting removed blocks back on every visit
+	std::vector<PendingBlockWrite>& outgoingWrites = chunkToActivate->m_outgoingBlockWrites;
+	if (!outgoingWrites.empty())
+	{
+		chunkToActivate->m_needsSaving = true;
+	}
+	for (int writeIndex = 0; writeIndex < static_cast<int>(outgoingWrites.size()); ++writeIndex)
+	{
+		PendingBlockWrite const& outgoingWrite = outgoingWrites[writeIndex];
+		Chunk* targetChunk = GetWorldChunk(outgoingWrite.m_targetChunkCoords);
+		if (targetChunk == nullptr)
+		{
+			m_pendingBlockWrites[outgoingWrite.m_targetChunkCoords].push_back(outgoingWrite);
+			continue;
+		}
+
+		// Already active, goes through SetBlockType so lighting and meshes are updated
+		if (targetChunk->m_blocks[outgoingWrite.m_blockIndex].m_blockType == BLOCKTYPE_AIR)
+		{
+			IntVec3 localCoords = targetChunk->IndexToLocalCoords(outgoingWrite.m_blockIndex);
+			targetChunk->SetBlockType(localCoords.x, localCoords.y, localCoords.z, outgoingWrite.m_blockType);
+		}
+	}
+
+	std::vector<PendingBlockWrite>().swap(outgoingWrites);
+}
+
+void World::EvictDistantPendingBlockWrites(Vec2 const& cameraPosXY)
+{
+	// Moved to the target's pending writes file, which ApplyPendingBlockWrites reads back when it activates
+	float evictionRangeSquared = static_cast<float>(PENDING_WRITE_EVICTION_RANGE * PENDING_WRITE_EVICTION_RANGE);
+	for (auto foundWrites = m_pendingBlockWrites.begin(); foundWrites != m_pendingBlockWrites.end();)
+	{
+		IntVec2 const& chunkCoords = foundWrites->first;
+		Vec2 chunkCenter = Vec2(static_cast<float>(chunkCoords.x * CHUNK_SIZE_X + CHUNK_SIZE_X / 2), static_cast<float>(chunkCoords.y * CHUNK_SIZE_Y + CHUNK_SIZE_Y / 2));
+		if (GetDistanceSquared2D(cameraPosXY, chunkCenter) > evictionRangeSquared)
+		{
+			Chunk::AppendPendingWritesToFile(chunkCoords, foundWrites->second);
+			foundWrites = m_pendingBlockWrites.erase(foundWrites);
+		}
+		else
+		{
+			++foundWrites;
+		}
+	}
 }
 
 void World::HookUpNeighbors(Chunk* chunkToActivate)
 {
 	// Check and set North
 	IntVec2 northCoords = chunkToActivate->m_chunkCoords + IntVec2::NORTH;
-	if (m_activeChunks.find(northCoords) != m_activeChunks.end())
+	Chunk* northChunk = m_activeChunks.Find(northCoords);
+	if (northChunk != nullptr)
 	{
-		chunkToActivate->m_northNeighbor = m_activeChunks[northCoords];
-		m_activeChunks[northCoords]->m_southNeighbor = chunkToActivate;
+		chunkToActivate->m_northNeighbor = northChunk;
+		northChunk->m_southNeighbor = chunkToActivate;
+		PushMeshBuildIfReady(northChunk);
 	}
 
 	// Check and set South
 	IntVec2 southCoords = chunkToActivate->m_chunkCoords + IntVec2::SOUTH;
-	if (m_activeChunks.find(southCoords) != m_activeChunks.end())
+	Chunk* southChunk = m_activeChunks.Find(southCoords);
+	if (southChunk != nullptr)
 	{
-		chunkToActivate->m_southNeighbor = m_activeChunks[southCoords];
-		m_activeChunks[southCoords]->m_northNeighbor = chunkToActivate;
+		chunkToActivate->m_southNeighbor = southChunk;
+		southChunk->m_northNeighbor = chunkToActivate;
+		PushMeshBuildIfReady(southChunk);
 	}
 
 	// Check and set East
 	IntVec2 eastCoords = chunkToActivate->m_chunkCoords + IntVec2::EAST;
-	if (m_activeChunks.find(eastCoords) != m_activeChunks.end())
+	Chunk* eastChunk = m_activeChunks.Find(eastCoords);
+	if (eastChunk != nullptr)
 	{
-		chunkToActivate->m_eastNeighbor = m_activeChunks[eastCoords];
-		m_activeChunks[eastCoords]->m_westNeighbor = chunkToActivate;
+		chunkToActivate->m_eastNeighbor = eastChunk;
+		eastChunk->m_westNeighbor = chunkToActivate;
+		PushMeshBuildIfReady(eastChunk);
 	}
 
 	// Check and set West
 	IntVec2 westCoords = chunkToActivate->m_chunkCoords + IntVec2::WEST;
-	if (m_activeChunks.find(westCoords) != m_activeChunks.end())
+	Chunk* westChunk = m_activeChunks.Find(westCoords);
+	if (westChunk != nullptr)
 	{
-		chunkToActivate->m_westNeighbor = m_activeChunks[westCoords];
-		m_activeChunks[westCoords]->m_eastNeighbor = chunkToActivate;
+		chunkToActivate->m_westNeighbor = westChunk;
+		westChunk->m_eastNeighbor = chunkToActivate;
+		PushMeshBuildIfReady(westChunk);
 	}
+
+	PushMeshBuildIfReady(chunkToActivate);
 }
 
 void World::DeActivateChunk(Chunk* chunkToDeActivate)
 {
-	if (m_activeChunks.find(chunkToDeActivate->m_chunkCoords) == m_activeChunks.end())
+	if (!m_activeChunks.Contains(chunkToDeActivate->m_chunkCoords))
 	{
 		return;
 	}
 
 	// Remove from neighbors
 	RemoveFromNeighbors(chunkToDeActivate);
+	RemoveFromMeshBuildQueue(chunkToDeActivate);
+	RemoveFromDirtyLighting(chunkToDeActivate);
 
-	// Remove from active map
-	m_activeChunks.erase(chunkToDeActivate->m_chunkCoords);
+	// Remove from active grid
+	m_activeChunks.Remove(chunkToDeActivate->m_chunkCoords);
+	SetChunkPresentInWindow(chunkToDeActivate->m_chunkCoords, false);
 
 	if (chunkToDeActivate->m_needsSaving)
 	{
@@ -486,8 +1431,7 @@ void World::DeActivateChunk(Chunk* chunkToDeActivate)
 	}
 	else
 	{
-		chunkToDeActivate->DeleteBuffers();
-		delete chunkToDeActivate;
+		m_chunkPool.Release(chunkToDeActivate);
 	}
 }
 
@@ -514,48 +1458,10 @@ void World::RemoveFromNeighbors(Chunk* chunkToDeActivate)
 void World::SaveChunkToFile(Chunk* chunkToSave)
 {
 	std::vector<uint8_t> byteInBuffer;
-
-	// Write the header
-	ChunkFileHeader header;
-	byteInBuffer.push_back(header.m_g);
-	byteInBuffer.push_back(header.m_c);
-	byteInBuffer.push_back(header.m_h);
-	byteInBuffer.push_back(header.m_k);
-	byteInBuffer.push_back(header.m_version);
-	byteInBuffer.push_back(header.m_bitsX);
-	byteInBuffer.push_back(header.m_bitsY);
-	byteInBuffer.push_back(header.m_bitsZ);
-
-	// Encode the RLE
-	uint8_t currentBlockType = chunkToSave->m_blocks[0].GetBlockType();
-	uint8_t runLength = 1;
-
-	for (int blockIndex = 1; blockIndex < CHUNK_BLOCK_TOTAL; ++blockIndex)
-	{
-		uint8_t blockType = chunkToSave->m_blocks[blockIndex].GetBlockType();
-		if (blockType == currentBlockType && runLength < 255)
-		{
-			runLength += 1;
-		}
-		else
-		{
-			// Storing the run
-			byteInBuffer.push_back(currentBlockType);
-			byteInBuffer.push_back(runLength);
-
-			// Starting a new run
-			currentBlockType = blockType;
-			runLength = 1;
-		}
-	}
-
-	// Storing final run
-	byteInBuffer.push_back(currentBlockType);
-	byteInBuffer.push_back(runLength);
+	chunkToSave->WriteBlocksToBuffer(byteInBuffer);
 
 	// Writing the buffer to file
-	std::string filename = Stringf("Saves/Chunk(%d,%d).chunk", chunkToSave->m_chunkCoords.x, chunkToSave->m_chunkCoords.y);
-	WriteBufferToFile(byteInBuffer, filename);
+	WriteBufferToFile(byteInBuffer, Chunk::GetSaveFilePath(chunkToSave->m_chunkCoords));
 }
 
 void World::LoadChunkFromFile(Chunk* chunkToLoad)
@@ -563,44 +1469,28 @@ void World::LoadChunkFromFile(Chunk* chunkToLoad)
 	std::vector<uint8_t> outByteBuffer;
 
 	// Read the file
-	std::string filename = Stringf("Saves/Chunk(%d,%d).chunk", chunkToLoad->m_chunkCoords.x, chunkToLoad->m_chunkCoords.y);
-	FileReadToBuffer(outByteBuffer, filename);
+	FileReadToBuffer(outByteBuffer, Chunk::GetSaveFilePath(chunkToLoad->m_chunkCoords));
 
-	// Read the header
-	uint8_t* outBufferPointer = outByteBuffer.data();
-	ChunkFileHeader* header = reinterpret_cast<ChunkFileHeader*>(outBufferPointer);
-
-	if (header->m_g != 'G' || header->m_c != 'C' || header->m_h != 'H' || header->m_k != 'K')
+	if (!chunkToLoad->ReadBlocksFromBuffer(outByteBuffer))
 	{
 		ERROR_AND_DIE("File header does not match ChunkFileHeader!");
-		return;
-	}
-
-	// Increment the current buffer data pointer by the size of a header
-	outBufferPointer += sizeof(ChunkFileHeader);
-
-	// Decode the RLE
-	int blockIndex = 0;
-	while (outBufferPointer < outByteBuffer.data() + outByteBuffer.size())
-	{
-		uint8_t blockType = *outBufferPointer++;
-		uint8_t runLength = *outBufferPointer++;
-
-		// Set the blocks
-		for (int setBlockIndex = 0; setBlockIndex < runLength; ++setBlockIndex)
-		{
-			chunkToLoad->m_blocks[blockIndex++].SetBlockType(blockType);
-		}
 	}
 }
 
-void World::ProcessDirtyLighting()
+int World::ProcessDirtyLighting(double deadline)
 {
-	// Processing light blocks until none remain
+	// One block costs far less than reading the clock, so the deadline is only checked every few blocks
+	int numProcessed = 0;
 	while (!m_dirtyLightBlocks.empty())
 	{
 		ProcessNextDirtyLightBlock();
+		numProcessed += 1;
+		if ((numProcessed % LIGHT_BLOCKS_PER_DEADLINE_CHECK) == 0 && GetCurrentTimeSeconds() >= deadline)
+		{
+			break;
+		}
 	}
+	return numProcessed;
 }
 
 void World::ProcessNextDirtyLightBlock()
@@ -613,6 +1503,10 @@ void World::ProcessNextDirtyLightBlock()
 	// Popping the first block in the queue
 	BlockIterator blockIterator = m_dirtyLightBlocks.front();
 	m_dirtyLightBlocks.pop_front();
+	if (blockIterator.m_chunk != nullptr)
+	{
+		blockIterator.m_chunk->m_numQueuedLightBlocks -= 1;
+	}
 
 	Block* block = blockIterator.GetBlock();
 	if (block == nullptr)
@@ -680,6 +1574,23 @@ void World::MarkLightingDirty(BlockIterator const& blockIterator)
 	// Mark and add to queue
 	block->SetIsLightDirty(true);
 	m_dirtyLightBlocks.push_back(blockIterator);
+	blockIterator.m_chunk->m_numQueuedLightBlocks += 1;
+}
+
+void World::RemoveFromDirtyLighting(Chunk* chunk)
+{
+	// The lighting budget carries the queue across frames, so a deactivating chunk can still have
+	// blocks in it; they would outlive its block array once it is saved or handed back to the pool
+	if (chunk->m_numQueuedLightBlocks == 0)
+	{
+		return;
+	}
+
+	m_dirtyLightBlocks.erase(std::remove_if(m_dirtyLightBlocks.begin(), m_dirtyLightBlocks.end(), [chunk](BlockIterator const& blockIterator)
+	{
+		return blockIterator.m_chunk == chunk;
+	}), m_dirtyLightBlocks.end());
+	chunk->m_numQueuedLightBlocks = 0;
 }
 
 void World::MarkLightingDirtyIfNotOpaque(BlockIterator const& blockIterator)
@@ -825,7 +1736,7 @@ void World::MarkChunkMeshesDirtyAround(BlockIterator const& blockIterator)
 	}
 
 	// Mark the chunk containing the block
-	centerChunk->m_isMeshDirty = true;
+	MarkChunkMeshDirty(centerChunk);
 
 	// Mark neighbor chunks that may need to rebuild mesh due to shared faces
 	BlockIterator neighbors[6] = 
@@ -848,7 +1759,7 @@ void World::MarkChunkMeshesDirtyAround(BlockIterator const& blockIterator)
 		Chunk* neighborChunk = neighbor.GetChunk();
 		if (neighborChunk && neighborChunk != centerChunk)
 		{
-			neighborChunk->m_isMeshDirty = true;
+			MarkChunkMeshDirty(neighborChunk);
 		}
 	}
 }
@@ -939,23 +1850,13 @@ float World::GetChunkDistSquaredToCamera(Chunk* chunk, Vec2 const& cameraPosXY)
 
 Chunk* World::GetWorldChunk(IntVec2 chunkCoords) const
 {
-	auto foundChunk = m_activeChunks.find(chunkCoords);
-	if (foundChunk != m_activeChunks.end())
-	{
-		return foundChunk->second;
-	}
-	return nullptr;
+	return m_activeChunks.Find(chunkCoords);
 }
 
 Chunk* World::GetChunkForWorldPos(Vec3 const& worldPos) const
 {
 	IntVec2 chunkCoords = GetChunkCoordsFromWorldPos(Vec2(worldPos.x, worldPos.y));
-	auto foundChunk = m_activeChunks.find(chunkCoords);
-	if (foundChunk != m_activeChunks.end())
-	{
-		return foundChunk->second;
-	}
-	return nullptr;
+	return m_activeChunks.Find(chunkCoords);
 }
 
 bool World::SetBlockTypeAtCoords(IntVec3 const& globalCoords, uint8_t blockTypeIndex)
@@ -1149,42 +2050,58 @@ GameRaycastResult3D  World::RaycastVsBlocks(Vec3 const& rayStartPos, Vec3 const&
 // -----------------------------------------------------------------------------
 void GenerateChunkJob::Execute()
 {
-	if (!m_chunk)
-	{
-		return;
-	}
+	GeneratedChunkResult result;
+	result.m_chunk = m_chunk;
 
-	// Generates the chunks mesh
-	m_chunk->PopulateWithDensityNoise();
+	// A request revoked while it waited in the job queue is skipped without touching the chunk's blocks
+	ChunkState expectedState = ChunkState::ACTIVATING_QUEUED_GENERATE;
+	if (m_chunk->m_chunkState.compare_exchange_strong(expectedState, ChunkState::ACTIVATING_GENERATING))
+	{
+		// Generates the chunks mesh
+		m_chunk->PopulateWithDensityNoise(m_settings);
+		result.m_didGenerate = true;
 
-	// Mark chunk as complete
-	m_chunk->m_chunkState.store(ChunkState::ACTIVATING_GENERATE_COMPLETE);
+		// Mark chunk as complete, unless it was revoked meanwhile and the main thread will discard it
+		expectedState = ChunkState::ACTIVATING_GENERATING;
+		m_chunk->m_chunkState.compare_exchange_strong(expectedState, ChunkState::ACTIVATING_GENERATE_COMPLETE);
+	}
+	PushCompletion(*m_completions, std::move(result));
+}
+// -----------------------------------------------------------------------------
+void BuildChunkMeshJob::Execute()
+{
+	BuiltChunkMeshResult result;
+	result.m_chunk = m_chunk;
+	result.m_chunkCoords = m_snapshot.m_chunkCoords;
+	result.m_editGeneration = m_snapshot.m_editGeneration;
+	result.m_meshStats = Chunk::BuildMeshFromSnapshot(m_snapshot, result.m_vertexes);
+	result.m_visibility = Chunk::BuildVisibilityFromSnapshot(m_snapshot);
+	PushCompletion(*m_completions, std::move(result));
 }
 // -----------------------------------------------------------------------------
 void SaveChunkJob::Execute()
 {
-	if (!m_chunk)
-	{
-		return;
-	}
-
 	// Save the chunk to file
 	g_theGame->m_currentWorld->SaveChunkToFile(m_chunk);
 
 	// Mark chunk as complete
 	m_chunk->m_chunkState.store(ChunkState::DEACTIVATING_SAVE_COMPLETE);
+
+	SavedChunkResult result;
+	result.m_chunk = m_chunk;
+	PushCompletion(*m_completions, std::move(result));
 }
 // -----------------------------------------------------------------------------
 void LoadChunkJob::Execute()
 {
-	if (!m_chunk)
-	{
-		return;
-	}
-
 	// Load chunk from file
 	g_theGame->m_currentWorld->LoadChunkFromFile(m_chunk);
 
 	// Mark chunk as complete
 	m_chunk->m_chunkState.store(ChunkState::ACTIVATING_LOAD_COMPLETE);
+
+	LoadedChunkResult result;
+	result.m_chunk = m_chunk;
+	result.m_dispatchTime = m_dispatchTime;
+	PushCompletion(*m_completions, std::move(result));
 }
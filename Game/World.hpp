@@ -1,55 +1,169 @@
 #pragma once
 #include "Game/GameCommon.h"
+#include "Game/Chunk.hpp"
 #include "Game/BlockIterator.hpp"
+#include "Game/ChunkGrid.hpp"
+#include "Game/ChunkPool.hpp"
+#include "Game/ViewFrustum.hpp"
+#include "Game/CompletionChannel.hpp"
 #include "Engine/Math/IntVec2.h"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/RaycastUtils.hpp"
 #include "Engine/Core/JobSystem.hpp"
 #include <unordered_map>
+#include <unordered_set>
 // -----------------------------------------------------------------------------
 class Game;
 class Chunk;
+class Texture;
+class WorldRenderContext;
 // -----------------------------------------------------------------------------
-namespace std
-{
-	template <>
-	struct hash<IntVec2>
-	{
-		std::size_t operator()(IntVec2 const& coords) const noexcept
-		{
-			return (std::hash<int>()(coords.x) * 73856093) ^ (std::hash<int>()(coords.y) * 19349663);
-		}
-	};
-}
+struct MeshBuildQueueEntry
+{
+	int    m_distSquared = 0;    // Chunk center to camera chunk center, in chunks
+	Chunk* m_chunk = nullptr;
+};
+// -----------------------------------------------------------------------------
+// Job results, handed back to the main thread through the world's completion channels
+struct GeneratedChunkResult
+{
+	Chunk* m_chunk = nullptr;
+	bool   m_didGenerate = false;    // False when the request was revoked before a worker picked it up
+};
+struct LoadedChunkResult
+{
+	Chunk* m_chunk = nullptr;
+	double m_dispatchTime = 0.0;
+};
+struct SavedChunkResult
+{
+	Chunk* m_chunk = nullptr;
+};
+struct BuiltChunkMeshResult
+{
+	Chunk*   m_chunk = nullptr;          // Only compared against the active chunk, never dereferenced by the worker
+	IntVec2  m_chunkCoords = IntVec2::ZERO;
+	uint64_t m_editGeneration = 0;
+	std::vector<ChunkVertex> m_vertexes;
+	ChunkMeshStats m_meshStats;
+	ChunkVisibility m_visibility;
+};
 // -----------------------------------------------------------------------------
-class GenerateChunkJob : public Job
+enum class ChunkJobType
 {
+	GENERATE,
+	LOAD,
+	SAVE,
+	BUILD_MESH,
+};
+// -----------------------------------------------------------------------------
+// Every job the world adds to a job system. Results go through the completion channels;
+// the job object itself only comes back through the job system to be reused, and its
+// type says which free list it belongs on
+class ChunkJob : public Job
+{
+public:
+	explicit ChunkJob(ChunkJobType chunkJobType) : m_chunkJobType(chunkJobType) {}
+
 public:
-	GenerateChunkJob(Chunk* chunk) : m_chunk(chunk) {}
+	ChunkJobType m_chunkJobType;
+};
+// -----------------------------------------------------------------------------
+class GenerateChunkJob : public ChunkJob
+{
+public:
+	GenerateChunkJob() : ChunkJob(ChunkJobType::GENERATE) {}
 	virtual void Execute() override;
 
 public:
 	Chunk* m_chunk = nullptr;
+	WorldGenSettings m_settings;
+	CompletionChannel<GeneratedChunkResult>* m_completions = nullptr;
 };
 // -----------------------------------------------------------------------------
-class SaveChunkJob : public Job
+class SaveChunkJob : public ChunkJob
 {
 public:
-	SaveChunkJob(Chunk* chunk) : m_chunk(chunk) {}
+	SaveChunkJob() : ChunkJob(ChunkJobType::SAVE) {}
 	virtual void Execute() override;
 
 public:
 	Chunk* m_chunk = nullptr;
+	CompletionChannel<SavedChunkResult>* m_completions = nullptr;
 };
 // -----------------------------------------------------------------------------
-class LoadChunkJob : public Job
+class LoadChunkJob : public ChunkJob
 {
 public:
-	LoadChunkJob(Chunk* chunk) : m_chunk(chunk) {}
+	LoadChunkJob() : ChunkJob(ChunkJobType::LOAD) {}
 	virtual void Execute() override;
 
 public:
 	Chunk* m_chunk = nullptr;
+	double m_dispatchTime = 0.0;
+	CompletionChannel<LoadedChunkResult>* m_completions = nullptr;
+};
+// -----------------------------------------------------------------------------
+class BuildChunkMeshJob : public ChunkJob
+{
+public:
+	BuildChunkMeshJob() : ChunkJob(ChunkJobType::BUILD_MESH) {}
+	virtual void Execute() override;
+
+public:
+	Chunk* m_chunk = nullptr;
+	ChunkMeshSnapshot m_snapshot;    // Reused with the job, so its arrays are only allocated once
+	CompletionChannel<BuiltChunkMeshResult>* m_completions = nullptr;
+};
+// -----------------------------------------------------------------------------
+// Culling results of one World::Render, and the renderer calls its CountingWorldRenderContext saw
+struct WorldRenderStats
+{
+	int m_numChunksDrawn = 0;
+	int m_numChunksCulled = 0;
+	int m_numGroupTests = 0;         // Frustum tests against groups of chunks
+	int m_numChunkTests = 0;         // Frustum tests against single chunks
+	int m_numChunksOccluded = 0;     // In the frustum, but not reached by the cave visibility search
+	int m_numSectionsVisited = 0;
+	bool m_isOcclusionCullingActive = false;
+	int m_numStateChanges = 0;       // Blend, sampler, rasterizer and depth modes, shader and texture binds
+	int m_numConstantUploads = 0;    // World constants once, then model constants per chunk
+};
+// -----------------------------------------------------------------------------
+// A chunk section reached by the visibility search, and how it was reached
+struct VisibilitySearchNode
+{
+	Chunk*  m_chunk = nullptr;
+	int     m_section = 0;
+	int     m_entryFace = -1;          // Face of this section the search came in through, -1 for the camera's own section
+	uint8_t m_stepDirections = 0;      // Faces stepped out of so far; the search never steps back against one
+};
+// -----------------------------------------------------------------------------
+// Main thread world work, in priority order. Each stage runs until its time budget for the frame
+// is spent, plus whatever the stages before it left unspent; the rest of its queue waits for next frame
+enum class WorldUpdateStage
+{
+	COMPLETIONS,     // Generate, load, save and mesh results handed back by the job systems
+	LIGHTING,        // Dirty light blocks
+	MESHING,         // Mesh snapshots and dispatch
+	DEACTIVATION,    // Chunks beyond deactivation range
+	ACTIVATION,      // Missing chunks within activation range
+	COUNT
+};
+// -----------------------------------------------------------------------------
+struct WorldStageStats
+{
+	double m_budgetSeconds = 0.0;       // Configured, before time carried over from earlier stages
+	double m_grantedSeconds = 0.0;      // Last frame, including time carried over
+	double m_usedSeconds = 0.0;         // Last frame
+	int    m_numItems = 0;              // Done last frame
+	int    m_backlog = 0;               // Left over for later frames
+
+	// Over the same one second window as the generation rate
+	double m_usedSecondsThisWindow = 0.0;
+	double m_maxUsedThisWindow = 0.0;
+	float  m_averageUsedSeconds = 0.f;
+	float  m_maxUsedSeconds = 0.f;
 };
 // -----------------------------------------------------------------------------
 struct GameRaycastResult3D : public RaycastResult3D
@@ -66,29 +180,63 @@ public:
 	// Updating
 	void Update(float deltaSeconds);
 	void HandleDebugInput();
+	void UpdateGenerationRate();
+	void ReportChunkUnderCamera() const;
 
 	// Rendering
 	void Render() const;
 	void RenderDebugModes() const;
+	void EnsureQuadIndexCapacity(int numQuads);
+	void BuildFaceSpriteCells();
+	IntVec2 GetSpriteCell(IntVec2 const& spriteCoords) const;
+	ViewFrustum GetCameraFrustum() const;
+	void RenderVisibleChunkGroups(ViewFrustum const& frustum, WorldRenderContext& context, WorldRenderStats& renderStats) const;
+	bool RenderChunk(Chunk const* chunk, WorldRenderContext& context, WorldRenderStats& renderStats) const;
+	void FindVisibleSections(ViewFrustum const& frustum, WorldRenderStats& renderStats) const;
+
+	// Frame budget
+	void RunBudgetedStages(Vec2 const& cameraPosXY);
+	int  RunStage(WorldUpdateStage stage, Vec2 const& cameraPosXY, double deadline);
+	int  GetStageBacklog(WorldUpdateStage stage) const;
 
 	// Processing
-	void DeactivateFurthestChunk(Vec2 const& cameraPosXY);
-	void QueueClosestMissingChunk(Vec2 const& cameraPosXY);
+	int  DeactivateDistantChunks(Vec2 const& cameraPosXY, double deadline);
+	bool DeactivateFurthestChunk(Vec2 const& cameraPosXY);
+	int  QueueClosestMissingChunk(Vec2 const& cameraPosXY, double deadline);
+	void BuildActivationOffsets();
+	void RecenterActivationWindow(IntVec2 const& cameraChunkCoords);
+	int  GetActivationWindowIndex(IntVec2 const& chunkCoords) const;
+	void SetChunkPresentInWindow(IntVec2 const& chunkCoords, bool isPresent);
 
 	// Mesh
 	void UpdateMeshBuildQueue(Vec2 const& cameraPosXY);
-	void BuildMeshesThisFrame();
-	void CleanUpMeshBuildQueue();
+	int  BuildMeshesThisFrame(double deadline);
+	void DispatchMeshJob(Chunk* chunk);
+	void FinishMeshJob(BuiltChunkMeshResult& meshResult);
+	void MarkChunkMeshDirty(Chunk* chunk);
+	void RemoveFromMeshBuildQueue(Chunk* chunk);
+	void PushMeshBuildIfReady(Chunk* chunk);
+	bool IsChunkReadyForMesh(Chunk const* chunk) const;
+	int  GetMeshBuildDistSquared(Chunk const* chunk) const;
 	
 	// Jobs
+	void UpdateGenerationQueue(Vec2 const& cameraPosXY);
+	bool RevokeGeneration(Chunk* chunk);
 	void DispatchGenerateJobs();
 	void DispatchLoadAndSaveJobs();
-	void ProcessCompletedJobs();
+	int  ProcessCompletedJobs(double deadline);
+	void RecycleCompletedJobs(JobSystem* jobSystem);
+	void FinishGenerateJob(GeneratedChunkResult const& generateResult);
+	void FinishLoadJob(LoadedChunkResult const& loadResult);
+	void FinishSaveJob(SavedChunkResult const& saveResult);
 
 	// Chunk Activation
 	void ActivateChunk(Chunk* chunkToActivate);
 	void FinalizeActivatedChunk(Chunk* chunkToActivate);
 	void HookUpNeighbors(Chunk* chunkToActivate);
+	void ApplyPendingBlockWrites(Chunk* chunkToActivate);
+	void DistributeOutgoingBlockWrites(Chunk* chunkToActivate);
+	void EvictDistantPendingBlockWrites(Vec2 const& cameraPosXY);
 	
 	// Chunk Deactivation
 	void DeActivateChunk(Chunk* chunkToDeActivate);
@@ -99,8 +247,9 @@ public:
 	void LoadChunkFromFile(Chunk* chunkToLoad);
 
 	// Lighting
-	void ProcessDirtyLighting();
+	int  ProcessDirtyLighting(double deadline);
 	void ProcessNextDirtyLightBlock();
+	void RemoveFromDirtyLighting(Chunk* chunk);
 	void MarkLightingDirty(BlockIterator const& blockIterator);
 	void MarkLightingDirtyIfNotOpaque(BlockIterator const& blockIterator);
 	void InitializeChunkLighting(Chunk* chunk);
@@ -126,12 +275,47 @@ public:
 	GameRaycastResult3D RaycastVsBlocks(Vec3 const& rayStartPos, Vec3 const& rayDir, float maxDist) const;
 
 	bool m_lightingEnabled = true;
+	bool m_frustumCullingEnabled = true;
+	bool m_hierarchicalCullingEnabled = true;
+	bool m_occlusionCullingEnabled = true;
+	MeshingMode m_meshingMode = MeshingMode::PER_FACE;
+
+	// Sprite cell of each block type's top, bottom and side, resolved once from the game's sprite sheet
+	std::vector<IntVec2> m_faceSpriteCells;    // NUM_SNAPSHOT_FACE_UVS per block type
 private:
 	Game* m_theGame = nullptr;
-	std::unordered_map<IntVec2, Chunk*> m_activeChunks;
-	std::vector<Chunk*> m_meshBuildQueue;
+	ChunkGrid m_activeChunks;
+	ChunkPool m_chunkPool;
 	std::deque<BlockIterator> m_dirtyLightBlocks;
 
+	// Mesh building: every dirty chunk stays in the list until meshed, and the ready ones within
+	// build range sit in a min-heap keyed on distance, re-keyed only when the camera changes chunk
+	std::vector<Chunk*> m_dirtyMeshChunks;
+	std::vector<MeshBuildQueueEntry> m_meshBuildHeap;
+	IntVec2 m_meshBuildCameraChunkCoords = IntVec2::ZERO;
+	bool    m_isMeshBuildHeapStale = true;
+	uint64_t m_nextMeshEditGeneration = 0;
+	int     m_numStaleMeshResults = 0;
+
+	// Every chunk quad uses the same 0,1,2,0,2,3 pattern, so one index buffer sized to the largest chunk serves them all
+	IndexBuffer* m_quadIndexBuffer = nullptr;
+	Texture* m_chunkSpriteImage = nullptr;
+	mutable WorldRenderStats m_lastRenderStats;
+	mutable uint32_t m_visibilityFrame = 0;
+	mutable std::vector<VisibilitySearchNode> m_visibilitySearchQueue;
+	int     m_quadIndexCapacity = 0;    // Quads
+
+	// Nearest-first activation: chunk offsets sorted by distance once, walked by a cursor that
+	// restarts when the camera enters a new chunk, with a presence bit per chunk in the window
+	std::vector<IntVec2> m_activationOffsets;
+	int     m_activationCursor = 0;
+	IntVec2 m_activationWindowCenter = IntVec2::ZERO;
+	std::vector<bool> m_isChunkPresentInWindow;             // Active, or queued/in flight for load or generation
+	std::unordered_set<IntVec2> m_activatingChunkCoords;    // Queued or in flight, not yet in m_activeChunks
+
+	// Decoration writes waiting for their target chunk to activate
+	std::unordered_map<IntVec2, std::vector<PendingBlockWrite>> m_pendingBlockWrites;
+
 	// Debugging
 	bool m_debugDrawMode = false;
 	bool m_debugJobText = false;
@@ -142,8 +326,65 @@ private:
 	std::deque<Chunk*> m_chunksQueuedForLoad;
 	std::deque<Chunk*> m_chunksQueuedForSave;
 
+	// [main thread] Generation requests handed to the job system, kept so they can be revoked if the camera leaves them behind
+	std::vector<Chunk*> m_chunksGenerating;
+	IntVec2 m_generationQueueCameraChunkCoords = IntVec2::ZERO;
+	bool    m_isGenerationQueueStale = true;
+	int     m_numGenerationsDropped = 0;          // Left range while still waiting in the world's queue
+	int     m_numGenerationsRevoked = 0;          // Revoked after dispatch, before a worker started them
+	int     m_numGenerationsWasted = 0;           // Revoked while a worker was generating, result discarded
+
 	// Current outstanding jobs
 	int m_outstandingGenerateJobs = 0;
 	int m_outstandingLoadJobs     = 0;
 	int m_outstandingSaveJobs     = 0;
+	int m_outstandingMeshJobs     = 0;
+
+	// Workers push results here as they finish; the main thread drains each channel in bulk once a frame.
+	// Each is sized for its job limit, so a push never finds it full
+	CompletionChannel<GeneratedChunkResult> m_generateCompletions { MAX_GENERATION_JOBS };
+	CompletionChannel<LoadedChunkResult>    m_loadCompletions { MAX_LOAD_JOBS };
+	CompletionChannel<SavedChunkResult>     m_saveCompletions { MAX_SAVE_JOBS };
+	CompletionChannel<BuiltChunkMeshResult> m_meshCompletions { MAX_MESH_JOBS };
+	std::vector<GeneratedChunkResult> m_generateResults;
+	std::vector<LoadedChunkResult>    m_loadResults;
+	std::vector<SavedChunkResult>     m_saveResults;
+	std::vector<BuiltChunkMeshResult> m_meshResults;
+
+	// Job objects handed back by the job systems, reused for the next dispatch instead of new and delete
+	std::vector<GenerateChunkJob*>  m_freeGenerateJobs;
+	std::vector<LoadChunkJob*>      m_freeLoadJobs;
+	std::vector<SaveChunkJob*>      m_freeSaveJobs;
+	std::vector<BuildChunkMeshJob*> m_freeMeshJobs;
+
+	// Generation throughput
+	int    m_chunksGeneratedThisWindow = 0;
+	double m_generationWindowStartTime = 0.0;
+	float  m_chunksGeneratedPerSecond  = 0.f;
+
+	// Time from a chunk going dirty to its mesh being built, over the same window
+	int    m_meshesBuiltThisWindow      = 0;
+	double m_meshWaitSecondsThisWindow  = 0.0;
+	double m_maxMeshWaitThisWindow      = 0.0;
+	float  m_averageMeshWaitSeconds     = 0.f;
+	float  m_maxMeshWaitSeconds         = 0.f;
+	int64_t m_meshBytesUploadedThisWindow = 0;
+	float  m_meshBytesUploadedPerSecond = 0.f;
+
+	// Time from a load job being dispatched to it coming back, over the same window
+	int    m_chunksLoadedThisWindow     = 0;
+	double m_loadSecondsThisWindow      = 0.0;
+	double m_maxLoadThisWindow          = 0.0;
+	float  m_averageLoadSeconds         = 0.f;
+	float  m_maxLoadSeconds             = 0.f;
+
+	// Main thread time per update stage, indexed by WorldUpdateStage
+	WorldStageStats m_stageStats[static_cast<int>(WorldUpdateStage::COUNT)];
+	int    m_updatesThisWindow          = 0;
+	int    m_numChunksOutOfRange        = 0;    // Beyond deactivation range at the last scan
+
+	// Cave stage totals across every generated chunk
+	int64_t m_totalCaveCandidateBlocks = 0;
+	int64_t m_totalCaveBlocksEvaluated = 0;
+	int64_t m_totalCaveBlocksCarved    = 0;
 };
\ No newline at end of file
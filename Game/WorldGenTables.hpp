@@ -0,0 +1,297 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include "Game/Chunk.hpp"
+#include <array>
+// -----------------------------------------------------------------------------
+// Compile-time tables used by chunk generation.
+// Tree stamps are baked from their shape parameters into one flat array of
+// packed offsets, and every (temperature, humidity, continentalness) band
+// combination is resolved ahead of time into its biome, surface blocks and
+// tree candidates, so the per-column work is a single table load.
+// -----------------------------------------------------------------------------
+struct PackedStampBlock
+{
+	int8_t  m_x = 0;
+	int8_t  m_y = 0;
+	int8_t  m_z = 0;
+	uint8_t m_blockType = BLOCKTYPE_AIR;
+};
+// -----------------------------------------------------------------------------
+struct TreeStampRange
+{
+	int m_firstBlock = 0;
+	int m_numBlocks = 0;
+	int m_radius = 0;
+};
+// -----------------------------------------------------------------------------
+// Trunk of m_trunkHeight logs, then a diamond of leaves around the trunk top
+// from (m_trunkHeight - m_leavesBelowTop) up to (m_trunkHeight + 2)
+struct TreeShape
+{
+	uint8_t m_logType = BLOCKTYPE_AIR;
+	uint8_t m_leafType = BLOCKTYPE_AIR;
+	int     m_trunkHeight = 0;
+	int     m_leavesBelowTop = 0;
+	float   m_leafDistSquaredLimit = 0.f;   // Leaves closer than this to the trunk top, 0 for no leaves
+	int     m_radius = 0;
+};
+// -----------------------------------------------------------------------------
+constexpr TreeShape TREE_SHAPES[NUM_TREE_STAMPS] =
+{
+	{ BLOCKTYPE_OAKLOG,    BLOCKTYPE_OAKLEAVES,        4, 2, 3.f,   2 },  // TREE_STAMP_OAK_SMALL
+	{ BLOCKTYPE_OAKLOG,    BLOCKTYPE_OAKLEAVES,        7, 2, 27.5f, 2 },  // TREE_STAMP_OAK_LARGE
+	{ BLOCKTYPE_SPRUCELOG, BLOCKTYPE_SPRUCELEAVES,     7, 2, 5.f,   2 },  // TREE_STAMP_SPRUCE
+	{ BLOCKTYPE_BIRCHLOG,  BLOCKTYPE_BIRCHLEAVES,      7, 2, 6.f,   2 },  // TREE_STAMP_BIRCH
+	{ BLOCKTYPE_ACACIALOG, BLOCKTYPE_ACACIALEAVES,     7, 0, 6.f,   2 },  // TREE_STAMP_ACACIA
+	{ BLOCKTYPE_JUNGLELOG, BLOCKTYPE_JUNGLELEAVES,     7, 2, 6.f,   2 },  // TREE_STAMP_JUNGLE
+	{ BLOCKTYPE_CACTUS,    BLOCKTYPE_AIR,              3, 0, 0.f,   1 },  // TREE_STAMP_CACTUS
+	{ BLOCKTYPE_SPRUCELOG, BLOCKTYPE_SPRUCELEAVESSNOW, 7, 2, 8.f,   2 },  // TREE_STAMP_SNOWY_SPRUCE
+};
+// -----------------------------------------------------------------------------
+constexpr int GetConstexprAbs(int value)
+{
+	return (value < 0) ? -value : value;
+}
+
+// Visits the stamp's blocks trunk first, then leaves, the same order they are placed in
+template <typename BlockVisitor>
+constexpr void ForEachTreeShapeBlock(TreeShape const& shape, BlockVisitor&& visitor)
+{
+	for (int trunkZ = 0; trunkZ < shape.m_trunkHeight; ++trunkZ)
+	{
+		visitor(0, 0, trunkZ, shape.m_logType);
+	}
+
+	for (int leafZ = shape.m_trunkHeight - shape.m_leavesBelowTop; leafZ <= shape.m_trunkHeight + 2; ++leafZ)
+	{
+		int distZ = leafZ - shape.m_trunkHeight;
+		int radius = 2 - GetConstexprAbs(distZ);
+		for (int leafY = -radius; leafY <= radius; ++leafY)
+		{
+			for (int leafX = -radius; leafX <= radius; ++leafX)
+			{
+				if (static_cast<float>(leafX * leafX + leafY * leafY + distZ * distZ) < shape.m_leafDistSquaredLimit)
+				{
+					visitor(leafX, leafY, leafZ, shape.m_leafType);
+				}
+			}
+		}
+	}
+}
+
+constexpr int CountTreeStampBlocks()
+{
+	int numBlocks = 0;
+	for (int stampIndex = 0; stampIndex < NUM_TREE_STAMPS; ++stampIndex)
+	{
+		ForEachTreeShapeBlock(TREE_SHAPES[stampIndex], [&numBlocks](int, int, int, uint8_t) { numBlocks += 1; });
+	}
+	return numBlocks;
+}
+
+constexpr int TREE_STAMP_TOTAL_BLOCKS = CountTreeStampBlocks();
+// -----------------------------------------------------------------------------
+struct TreeStampTables
+{
+	std::array<PackedStampBlock, TREE_STAMP_TOTAL_BLOCKS> m_blocks = {};
+	std::array<TreeStampRange, NUM_TREE_STAMPS> m_ranges = {};
+};
+
+constexpr TreeStampTables BuildTreeStampTables()
+{
+	TreeStampTables tables;
+	int numBlocks = 0;
+	for (int stampIndex = 0; stampIndex < NUM_TREE_STAMPS; ++stampIndex)
+	{
+		TreeStampRange& range = tables.m_ranges[stampIndex];
+		range.m_firstBlock = numBlocks;
+		range.m_radius = TREE_SHAPES[stampIndex].m_radius;
+
+		ForEachTreeShapeBlock(TREE_SHAPES[stampIndex], [&tables, &numBlocks](int x, int y, int z, uint8_t blockType)
+		{
+			PackedStampBlock& block = tables.m_blocks[numBlocks];
+			block.m_x = static_cast<int8_t>(x);
+			block.m_y = static_cast<int8_t>(y);
+			block.m_z = static_cast<int8_t>(z);
+			block.m_blockType = blockType;
+			numBlocks += 1;
+		});
+		range.m_numBlocks = numBlocks - range.m_firstBlock;
+	}
+	return tables;
+}
+
+inline constexpr TreeStampTables TREE_STAMP_TABLES = BuildTreeStampTables();
+// -----------------------------------------------------------------------------
+// Biome bands, see Chunk::GetTemperatureBand / GetHumidityBand / GetContinentalnessBand
+constexpr int NUM_TEMPERATURE_BANDS = 5;
+constexpr int NUM_HUMIDITY_BANDS = 5;
+constexpr int NUM_CONTINENTALNESS_BANDS = 7;
+constexpr int NUM_BIOME_LOOKUPS = NUM_TEMPERATURE_BANDS * NUM_HUMIDITY_BANDS * NUM_CONTINENTALNESS_BANDS;
+constexpr int NUM_TREE_VARIANTS = 3;
+// -----------------------------------------------------------------------------
+struct BiomeLookup
+{
+	BiomeType     m_biome = BIOME_OCEAN;
+	SurfaceBlocks m_surface = { BLOCKTYPE_STONE, BLOCKTYPE_STONE, BLOCKTYPE_STONE };
+
+	// A tree may grow on either surface type; the variant noise picks one of the three stamps
+	uint8_t       m_treeSurfaceTypes[2] = { BLOCKTYPE_AIR, BLOCKTYPE_AIR };
+	TreeStampType m_treeStamps[NUM_TREE_VARIANTS] = { TREE_STAMP_NONE, TREE_STAMP_NONE, TREE_STAMP_NONE };
+};
+// -----------------------------------------------------------------------------
+constexpr int GetBiomeLookupIndex(int temperatureBand, int humidityBand, int continentalnessBand)
+{
+	return (temperatureBand * NUM_HUMIDITY_BANDS + humidityBand) * NUM_CONTINENTALNESS_BANDS + continentalnessBand;
+}
+
+constexpr BiomeType ClassifyBiome(int temp, int humidity, int continent)
+{
+	// Oceanic regions
+	if (continent <= 2)
+	{
+		if (temp == 0) return BIOME_FROZEN_OCEAN;
+		if (continent <= 1) return BIOME_DEEP_OCEAN;
+		return BIOME_OCEAN;
+	}
+
+	// Coasts / beaches
+	if (continent == 3)
+	{
+		if (temp == 0) return BIOME_SNOWY_BEACH;
+		if (temp < 4) return BIOME_BEACH;
+		return BIOME_DESERT;
+	}
+
+	// Inland regions, temperature + humidity table
+	if (temp == 0)
+	{
+		if (humidity <= 1) return BIOME_SNOWY_PLAINS;
+		if (humidity == 3) return BIOME_SNOWY_TAIGA;
+		return BIOME_TAIGA;
+	}
+	if (temp == 1)
+	{
+		if (humidity <= 1) return BIOME_PLAINS;
+		if (humidity >= 3) return BIOME_FOREST;
+		return BIOME_TAIGA;
+	}
+	if (temp == 2)
+	{
+		if (humidity <= 1) return BIOME_PLAINS;
+		return BIOME_FOREST;
+	}
+	if (temp == 3)
+	{
+		if (humidity <= 1) return BIOME_SAVANNA;
+		if (humidity >= 3) return BIOME_JUNGLE;
+		return BIOME_FOREST;
+	}
+	if (humidity <= 2) return BIOME_DESERT;
+	return BIOME_BADLANDS;
+}
+
+constexpr SurfaceBlocks GetBiomeSurfaceBlocks(BiomeType biome)
+{
+	switch (biome)
+	{
+	// Oceans & Beaches
+		case BIOME_OCEAN:
+		case BIOME_DEEP_OCEAN:
+			return { BLOCKTYPE_SAND, BLOCKTYPE_ICE, BLOCKTYPE_SAND };
+		case BIOME_FROZEN_OCEAN:
+			return { BLOCKTYPE_SNOW, BLOCKTYPE_ICE, BLOCKTYPE_SAND };
+		case BIOME_BEACH:
+			return { BLOCKTYPE_SAND, BLOCKTYPE_SAND, BLOCKTYPE_SAND };
+		case BIOME_SNOWY_BEACH:
+			return { BLOCKTYPE_SNOW, BLOCKTYPE_SNOW, BLOCKTYPE_SAND };
+
+	// Hot desert areas
+		case BIOME_DESERT:
+			return { BLOCKTYPE_SAND, BLOCKTYPE_SAND, BLOCKTYPE_SAND };
+		case BIOME_BADLANDS:
+			return { BLOCKTYPE_GRASSLIGHT, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
+
+	// Forests
+		case BIOME_PLAINS:
+			return { BLOCKTYPE_GRASS, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
+		case BIOME_FOREST:
+			return { BLOCKTYPE_GRASS, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
+		case BIOME_TAIGA:
+			return { BLOCKTYPE_GRASSLIGHT, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
+		case BIOME_SNOWY_TAIGA:
+			return { BLOCKTYPE_SNOW, BLOCKTYPE_ICE, BLOCKTYPE_STONE };
+		case BIOME_SNOWY_PLAINS:
+			return { BLOCKTYPE_SNOW, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
+
+	// Jungle / Savanna
+		case BIOME_JUNGLE:
+			return { BLOCKTYPE_GRASSDARK, BLOCKTYPE_DIRT, BLOCKTYPE_SAND };
+		case BIOME_SAVANNA:
+			return { BLOCKTYPE_GRASSYELLOW, BLOCKTYPE_DIRT, BLOCKTYPE_STONE };
+
+		default:
+			return { BLOCKTYPE_STONE, BLOCKTYPE_STONE, BLOCKTYPE_STONE };
+	}
+}
+
+constexpr void SetBiomeTrees(BiomeLookup& lookup, uint8_t surfaceType, TreeStampType stamp)
+{
+	lookup.m_treeSurfaceTypes[0] = surfaceType;
+	lookup.m_treeSurfaceTypes[1] = surfaceType;
+	for (int variant = 0; variant < NUM_TREE_VARIANTS; ++variant)
+	{
+		lookup.m_treeStamps[variant] = stamp;
+	}
+}
+
+constexpr BiomeLookup BuildBiomeLookup(int temp, int humidity, int continent)
+{
+	BiomeLookup lookup;
+	lookup.m_biome = ClassifyBiome(temp, humidity, continent);
+	lookup.m_surface = GetBiomeSurfaceBlocks(lookup.m_biome);
+
+	switch (lookup.m_biome)
+	{
+		case BIOME_FOREST:
+			lookup.m_treeSurfaceTypes[0] = BLOCKTYPE_GRASS;
+			lookup.m_treeSurfaceTypes[1] = BLOCKTYPE_DIRT;
+			lookup.m_treeStamps[0] = TREE_STAMP_OAK_SMALL;
+			lookup.m_treeStamps[1] = TREE_STAMP_OAK_LARGE;
+			lookup.m_treeStamps[2] = TREE_STAMP_BIRCH;
+			break;
+		case BIOME_TAIGA:       SetBiomeTrees(lookup, BLOCKTYPE_GRASSLIGHT, TREE_STAMP_SPRUCE);       break;
+		case BIOME_SNOWY_TAIGA: SetBiomeTrees(lookup, BLOCKTYPE_SNOW, TREE_STAMP_SNOWY_SPRUCE);       break;
+		case BIOME_DESERT:      SetBiomeTrees(lookup, BLOCKTYPE_SAND, TREE_STAMP_CACTUS);             break;
+		case BIOME_SAVANNA:     SetBiomeTrees(lookup, BLOCKTYPE_GRASSYELLOW, TREE_STAMP_ACACIA);      break;
+		case BIOME_JUNGLE:      SetBiomeTrees(lookup, BLOCKTYPE_GRASSDARK, TREE_STAMP_JUNGLE);        break;
+		default:
+			break;
+	}
+	return lookup;
+}
+
+constexpr std::array<BiomeLookup, NUM_BIOME_LOOKUPS> BuildBiomeLookupTable()
+{
+	std::array<BiomeLookup, NUM_BIOME_LOOKUPS> table = {};
+	for (int temp = 0; temp < NUM_TEMPERATURE_BANDS; ++temp)
+	{
+		for (int humidity = 0; humidity < NUM_HUMIDITY_BANDS; ++humidity)
+		{
+			for (int continent = 0; continent < NUM_CONTINENTALNESS_BANDS; ++continent)
+			{
+				table[GetBiomeLookupIndex(temp, humidity, continent)] = BuildBiomeLookup(temp, humidity, continent);
+			}
+		}
+	}
+	return table;
+}
+
+inline constexpr std::array<BiomeLookup, NUM_BIOME_LOOKUPS> BIOME_LOOKUP_TABLE = BuildBiomeLookupTable();
+// -----------------------------------------------------------------------------
+constexpr int GetTreeVariant(float treeVariantNoise)
+{
+	if (treeVariantNoise < 0.33f) return 0;
+	if (treeVariantNoise < 0.66f) return 1;
+	return 2;
+}
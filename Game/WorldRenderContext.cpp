@@ -0,0 +1,191 @@
+#include "Game/WorldRenderContext.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.h"
+
+// Rendering is left out of headless builds (see Tools/CMakeLists.txt)
+#if !defined(HEADLESS_WORLDGEN)
+#include "Engine/Renderer/Renderer.h"
+
+RendererWorldRenderContext::RendererWorldRenderContext(ConstantBuffer* worldConstantBuffer)
+	: m_worldConstantBuffer(worldConstantBuffer)
+{
+}
+
+void RendererWorldRenderContext::SetState(WorldPassState state)
+{
+	switch (state)
+	{
+		case WorldPassState::BLEND_OPAQUE:                g_theRenderer->SetBlendMode(BlendMode::OPAQUE);                   break;
+		case WorldPassState::SAMPLER_POINT_CLAMP:         g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);          break;
+		case WorldPassState::RASTERIZER_SOLID_CULL_BACK:  g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK); break;
+		case WorldPassState::DEPTH_READ_WRITE_LESS_EQUAL: g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);    break;
+		default: break;
+	}
+}
+
+void RendererWorldRenderContext::BindShader(Shader* shader)
+{
+	g_theRenderer->BindShader(shader);
+}
+
+void RendererWorldRenderContext::BindTexture(Texture const* texture)
+{
+	g_theRenderer->BindTexture(texture);
+}
+
+void RendererWorldRenderContext::SetWorldConstants(WorldConstants const& worldConstants)
+{
+	g_theRenderer->CopyCPUToGPU(&worldConstants, sizeof(WorldConstants), m_worldConstantBuffer);
+	g_theRenderer->BindConstantBuffer(4, m_worldConstantBuffer);
+}
+
+void RendererWorldRenderContext::SetModelConstants(Mat44 const& modelToWorld)
+{
+	g_theRenderer->SetModelConstants(modelToWorld);
+}
+
+void RendererWorldRenderContext::DrawIndexedVertexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount)
+{
+	g_theRenderer->DrawIndexedVertexBuffer(vertexBuffer, indexBuffer, indexCount);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+void NullWorldRenderContext::SetState(WorldPassState state)
+{
+	UNUSED(state);
+}
+
+void NullWorldRenderContext::BindShader(Shader* shader)
+{
+	UNUSED(shader);
+}
+
+void NullWorldRenderContext::BindTexture(Texture const* texture)
+{
+	UNUSED(texture);
+}
+
+void NullWorldRenderContext::SetWorldConstants(WorldConstants const& worldConstants)
+{
+	UNUSED(worldConstants);
+}
+
+void NullWorldRenderContext::SetModelConstants(Mat44 const& modelToWorld)
+{
+	UNUSED(modelToWorld);
+}
+
+void NullWorldRenderContext::DrawIndexedVertexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount)
+{
+	UNUSED(vertexBuffer);
+	UNUSED(indexBuffer);
+	UNUSED(indexCount);
+}
+
+// -----------------------------------------------------------------------------
+CountingWorldRenderContext::CountingWorldRenderContext(WorldRenderContext& innerContext)
+	: m_innerContext(innerContext)
+{
+}
+
+void CountingWorldRenderContext::SetState(WorldPassState state)
+{
+	m_numStateChanges += 1;
+	m_innerContext.SetState(state);
+}
+
+void CountingWorldRenderContext::BindShader(Shader* shader)
+{
+	m_numStateChanges += 1;
+	m_innerContext.BindShader(shader);
+}
+
+void CountingWorldRenderContext::BindTexture(Texture const* texture)
+{
+	m_numStateChanges += 1;
+	m_innerContext.BindTexture(texture);
+}
+
+void CountingWorldRenderContext::SetWorldConstants(WorldConstants const& worldConstants)
+{
+	m_numConstantUploads += 1;
+	m_innerContext.SetWorldConstants(worldConstants);
+}
+
+void CountingWorldRenderContext::SetModelConstants(Mat44 const& modelToWorld)
+{
+	m_numConstantUploads += 1;
+	m_innerContext.SetModelConstants(modelToWorld);
+}
+
+void CountingWorldRenderContext::DrawIndexedVertexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount)
+{
+	m_numDraws += 1;
+	m_innerContext.DrawIndexedVertexBuffer(vertexBuffer, indexBuffer, indexCount);
+}
+
+// -----------------------------------------------------------------------------
+void BeginWorldPass(WorldRenderContext& context, WorldConstants const& worldConstants, Shader* worldShader, Texture const* spriteTexture)
+{
+	context.SetWorldConstants(worldConstants);
+	context.SetState(WorldPassState::BLEND_OPAQUE);
+	context.SetState(WorldPassState::SAMPLER_POINT_CLAMP);
+	context.SetState(WorldPassState::RASTERIZER_SOLID_CULL_BACK);
+	context.SetState(WorldPassState::DEPTH_READ_WRITE_LESS_EQUAL);
+	context.BindShader(worldShader);
+	context.BindTexture(spriteTexture);
+}
+
+void DrawChunkMesh(WorldRenderContext& context, IntVec2 const& chunkCoords, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount)
+{
+	Mat44 chunkToWorld;
+	chunkToWorld.SetTranslation3D(Vec3(static_cast<float>(chunkCoords.x * CHUNK_SIZE_X), static_cast<float>(chunkCoords.y * CHUNK_SIZE_Y), 0.f));
+	context.SetModelConstants(chunkToWorld);
+	context.DrawIndexedVertexBuffer(vertexBuffer, indexBuffer, indexCount);
+}
+
+void DrawChunkMeshReference(WorldRenderContext& context, WorldConstants const& worldConstants, Shader* worldShader, Texture const* spriteTexture,
+	                        IntVec2 const& chunkCoords, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount)
+{
+	Mat44 chunkToWorld;
+	chunkToWorld.SetTranslation3D(Vec3(static_cast<float>(chunkCoords.x * CHUNK_SIZE_X), static_cast<float>(chunkCoords.y * CHUNK_SIZE_Y), 0.f));
+	context.SetModelConstants(chunkToWorld);
+	context.SetWorldConstants(worldConstants);
+	context.SetState(WorldPassState::BLEND_OPAQUE);
+	context.SetState(WorldPassState::SAMPLER_POINT_CLAMP);
+	context.SetState(WorldPassState::RASTERIZER_SOLID_CULL_BACK);
+	context.SetState(WorldPassState::DEPTH_READ_WRITE_LESS_EQUAL);
+	context.BindShader(worldShader);
+	context.BindTexture(spriteTexture);
+	context.DrawIndexedVertexBuffer(vertexBuffer, indexBuffer, indexCount);
+}
+
+WorldPassCountsReport MeasureWorldPassCounts(int numChunks)
+{
+	WorldPassCountsReport report;
+	report.m_numChunks = numChunks;
+	WorldConstants worldConstants;
+	NullWorldRenderContext nullContext;
+
+	CountingWorldRenderContext passContext(nullContext);
+	BeginWorldPass(passContext, worldConstants, nullptr, nullptr);
+	for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+	{
+		DrawChunkMesh(passContext, IntVec2(chunkIndex, 0), nullptr, nullptr, 6);
+	}
+	report.m_numStateChanges = passContext.m_numStateChanges;
+	report.m_numConstantUploads = passContext.m_numConstantUploads;
+	report.m_numDraws = passContext.m_numDraws;
+
+	CountingWorldRenderContext referenceContext(nullContext);
+	for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+	{
+		DrawChunkMeshReference(referenceContext, worldConstants, nullptr, nullptr, IntVec2(chunkIndex, 0), nullptr, nullptr, 6);
+	}
+	report.m_numReferenceStateChanges = referenceContext.m_numStateChanges;
+	report.m_numReferenceConstantUploads = referenceContext.m_numConstantUploads;
+	report.m_numReferenceDraws = referenceContext.m_numDraws;
+	return report;
+}
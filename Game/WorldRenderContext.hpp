@@ -0,0 +1,106 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include "Engine/Math/IntVec2.h"
+// -----------------------------------------------------------------------------
+class Shader;
+class Texture;
+class VertexBuffer;
+class IndexBuffer;
+class ConstantBuffer;
+class Mat44;
+// -----------------------------------------------------------------------------
+// Fixed-function state the world pass sets; the renderer context maps each one to its engine mode
+enum class WorldPassState
+{
+	BLEND_OPAQUE,
+	SAMPLER_POINT_CLAMP,
+	RASTERIZER_SOLID_CULL_BACK,
+	DEPTH_READ_WRITE_LESS_EQUAL,
+	NUM_WORLD_PASS_STATES
+};
+// -----------------------------------------------------------------------------
+// The renderer calls the world pass makes; World::Render and Chunk::Render go through this instead of g_theRenderer
+class WorldRenderContext
+{
+public:
+	virtual ~WorldRenderContext() = default;
+
+	virtual void SetState(WorldPassState state) = 0;
+	virtual void BindShader(Shader* shader) = 0;
+	virtual void BindTexture(Texture const* texture) = 0;
+	virtual void SetWorldConstants(WorldConstants const& worldConstants) = 0;
+	virtual void SetModelConstants(Mat44 const& modelToWorld) = 0;
+	virtual void DrawIndexedVertexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount) = 0;
+};
+// -----------------------------------------------------------------------------
+#if !defined(HEADLESS_WORLDGEN)
+// Forwards every call straight to g_theRenderer
+class RendererWorldRenderContext : public WorldRenderContext
+{
+public:
+	explicit RendererWorldRenderContext(ConstantBuffer* worldConstantBuffer);
+
+	virtual void SetState(WorldPassState state) override;
+	virtual void BindShader(Shader* shader) override;
+	virtual void BindTexture(Texture const* texture) override;
+	virtual void SetWorldConstants(WorldConstants const& worldConstants) override;
+	virtual void SetModelConstants(Mat44 const& modelToWorld) override;
+	virtual void DrawIndexedVertexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount) override;
+
+public:
+	ConstantBuffer* m_worldConstantBuffer = nullptr;
+};
+#endif
+// -----------------------------------------------------------------------------
+// Drops every call, so the pass can run without a renderer
+class NullWorldRenderContext : public WorldRenderContext
+{
+public:
+	virtual void SetState(WorldPassState state) override;
+	virtual void BindShader(Shader* shader) override;
+	virtual void BindTexture(Texture const* texture) override;
+	virtual void SetWorldConstants(WorldConstants const& worldConstants) override;
+	virtual void SetModelConstants(Mat44 const& modelToWorld) override;
+	virtual void DrawIndexedVertexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount) override;
+};
+// -----------------------------------------------------------------------------
+// Counts each call as it is issued, then passes it on to the wrapped context
+class CountingWorldRenderContext : public WorldRenderContext
+{
+public:
+	explicit CountingWorldRenderContext(WorldRenderContext& innerContext);
+
+	virtual void SetState(WorldPassState state) override;
+	virtual void BindShader(Shader* shader) override;
+	virtual void BindTexture(Texture const* texture) override;
+	virtual void SetWorldConstants(WorldConstants const& worldConstants) override;
+	virtual void SetModelConstants(Mat44 const& modelToWorld) override;
+	virtual void DrawIndexedVertexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount) override;
+
+public:
+	WorldRenderContext& m_innerContext;
+	int m_numStateChanges = 0;       // Fixed-function states, shader and texture binds
+	int m_numConstantUploads = 0;    // World and model constants
+	int m_numDraws = 0;
+};
+// -----------------------------------------------------------------------------
+struct WorldPassCountsReport
+{
+	int m_numChunks = 0;
+	int m_numStateChanges = 0;             // One frame of the world pass
+	int m_numConstantUploads = 0;
+	int m_numDraws = 0;
+	int m_numReferenceStateChanges = 0;    // The same chunks with every piece of state set again per chunk
+	int m_numReferenceConstantUploads = 0;
+	int m_numReferenceDraws = 0;
+};
+// -----------------------------------------------------------------------------
+// Shared state and world constants, set once per frame before any chunk draws
+void BeginWorldPass(WorldRenderContext& context, WorldConstants const& worldConstants, Shader* worldShader, Texture const* spriteTexture);
+// A chunk's mesh is chunk-local, so its origin is all it adds to the shared state
+void DrawChunkMesh(WorldRenderContext& context, IntVec2 const& chunkCoords, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount);
+// The original per-chunk sequence, which set world constants and all shared state again for every chunk
+void DrawChunkMeshReference(WorldRenderContext& context, WorldConstants const& worldConstants, Shader* worldShader, Texture const* spriteTexture,
+	                        IntVec2 const& chunkCoords, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int indexCount);
+// Counts both sequences for a frame of numChunks draws through a null context
+WorldPassCountsReport MeasureWorldPassCounts(int numChunks);
@@ -25,11 +25,14 @@ cbuffer WorldConstants : register(b4)
 Texture2D diffuseTexture : register(t0);
 SamplerState diffuseSampler : register(s0);
 // -----------------------------------------------------------------------------
+// Must match CHUNK_SPRITE_GRID_SIZE in GameCommon.h and ChunkVertex in Chunk.hpp
+static const uint SPRITE_GRID_SIZE = 8;
+static const uint CHUNK_VERTEX_UNLIT = 1;
+// -----------------------------------------------------------------------------
+// One 8-byte ChunkVertex per vertex, fetched as a single R32G32_UINT element (VertexType::VERTEX_UINT2)
 struct vs_input_t
 {
-	float3 modelSpacePosition : POSITION;
-	float4 color : COLOR;
-	float2 uv : TEXCOORD;
+	uint2 packedVertex : POSITION;
 };
 // -----------------------------------------------------------------------------
 struct v2p_t
@@ -37,12 +40,45 @@ struct v2p_t
 	float4 clipSpacePosition : SV_Position;
 	float4 color : COLOR;
 	float2 uv : TEXCOORD;
+	nointerpolation float2 spriteCell : SpriteCell;
     float3 worldPosition : WorldPos;
 };
 // -----------------------------------------------------------------------------
+// Sprite UV in blocks, laid out the way the per-face corners map onto the sprite
+float2 GetFaceUV(float3 localPosition, uint blockFace)
+{
+	switch (blockFace)
+	{
+		case 0:  return float2(localPosition.y, localPosition.z);     // East
+		case 1:  return float2(-localPosition.y, localPosition.z);    // West
+		case 2:  return float2(-localPosition.x, localPosition.z);    // North
+		case 3:  return float2(localPosition.x, localPosition.z);     // South
+		case 4:  return float2(localPosition.x, localPosition.y);     // Top
+		default: return float2(localPosition.x, -localPosition.y);    // Bottom
+	}
+}
+// -----------------------------------------------------------------------------
 v2p_t VertexMain(vs_input_t input)
 {
-	float4 modelSpacePosition = float4(input.modelSpacePosition, 1.0f);
+	// Word 0: local x, y, z, face. Word 1: sprite index, light nibbles, tint, flags
+	uint positionWord = input.packedVertex.x;
+	uint appearanceWord = input.packedVertex.y;
+	float3 localPosition = float3(positionWord & 0xFF, (positionWord >> 8) & 0xFF, (positionWord >> 16) & 0xFF);
+	uint blockFace = positionWord >> 24;
+	uint spriteIndex = appearanceWord & 0xFF;
+	uint lightInfluence = (appearanceWord >> 8) & 0xFF;
+	float tint = ((appearanceWord >> 16) & 0xFF) / 255.f;
+	uint flags = appearanceWord >> 24;
+
+	// Red and green carry outdoor and indoor light, blue the tint; unlit faces use the tint for all three
+	float4 color = float4((lightInfluence >> 4) / 15.f, (lightInfluence & 0x0F) / 15.f, tint, 1.f);
+	if (flags & CHUNK_VERTEX_UNLIT)
+	{
+		color = float4(tint, tint, tint, 1.f);
+	}
+
+	// ModelToWorldTransform holds the chunk origin
+	float4 modelSpacePosition = float4(localPosition, 1.0f);
 	float4 worldSpacePosition = mul(ModelToWorldTransform, modelSpacePosition);
 	float4 cameraSpacePosition = mul(WorldToCameraTransform, worldSpacePosition);
 	float4 renderSpacePosition = mul(CameraToRenderTransform, cameraSpacePosition);
@@ -50,8 +86,9 @@ v2p_t VertexMain(vs_input_t input)
 
 	v2p_t v2p;
 	v2p.clipSpacePosition = clipSpacePosition;
-	v2p.color = input.color;
-	v2p.uv = input.uv;
+	v2p.color = color;
+	v2p.uv = GetFaceUV(localPosition, blockFace);
+	v2p.spriteCell = float2(spriteIndex % SPRITE_GRID_SIZE, spriteIndex / SPRITE_GRID_SIZE);
     v2p.worldPosition = cameraSpacePosition.xyz;
 	return v2p;
 }
@@ -63,8 +100,11 @@ float3 DiminishingAdd(float3 a, float3 b)
 // -----------------------------------------------------------------------------
 float4 PixelMain(v2p_t input) : SV_Target0
 {
-	// Sampling the base color
-	float4 textureColor = diffuseTexture.Sample(diffuseSampler, input.uv);
+	// Sampling the base color: the sprite repeats once per block across merged faces
+	float2 atlasUV = (input.spriteCell + frac(input.uv)) / SPRITE_GRID_SIZE;
+	float2 atlasUVdx = ddx(input.uv) / SPRITE_GRID_SIZE;
+	float2 atlasUVdy = ddy(input.uv) / SPRITE_GRID_SIZE;
+	float4 textureColor = diffuseTexture.SampleGrad(diffuseSampler, atlasUV, atlasUVdx, atlasUVdy);
 	clip(textureColor.a - 0.01f);
 	
 	// Lighting calculation
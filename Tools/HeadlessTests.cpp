@@ -0,0 +1,370 @@
+#include "Tools/ToolCommon.hpp"
+#include "Game/Chunk.hpp"
+#include "Game/Block.hpp"
+#include "Game/BlockDefinition.hpp"
+#include "Game/ViewFrustum.hpp"
+#include "Game/BatchNoise.hpp"
+#include "Game/ClimateCache.hpp"
+#include "Game/CompletionChannel.hpp"
+#include "Game/WorldRenderContext.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/MathUtils.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+// Headless checks for the game code paths that must agree with a slower
+// reference path. Each test prints what it compared and fails on any
+// disagreement; ctest runs each one by name from the Run directory.
+//
+//   HeadlessTests [test=Name] [chunks=N] [any GameConfig.xml key=value]
+// -----------------------------------------------------------------------------
+struct HeadlessTest
+{
+	char const* m_name;
+	bool (*m_run)(WorldGenSettings const& settings, int numChunks);
+};
+// -----------------------------------------------------------------------------
+// Chunks scattered far enough apart to cover oceans, plains and mountains
+static std::vector<IntVec2> GetScatteredChunkCoords(int numChunks)
+{
+	std::mt19937 rng(GAME_SEED);
+	std::uniform_int_distribution<int> coordDistribution(-2048, 2048);
+	std::vector<IntVec2> chunkCoords;
+	chunkCoords.reserve(numChunks);
+	for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+	{
+		int chunkX = coordDistribution(rng);
+		int chunkY = coordDistribution(rng);
+		chunkCoords.push_back(IntVec2(chunkX, chunkY));
+	}
+	return chunkCoords;
+}
+
+static bool TestBatchNoise(WorldGenSettings const& settings, int numChunks)
+{
+	UNUSED(settings)
+
+	// The SIMD lanes must reproduce the scalar Engine noise at every sample
+	int numSamples = numChunks * 256;
+	float maxError = MeasureBatchNoiseError(numSamples, GAME_SEED);
+	printf("  %d samples %d wide, max error vs scalar %.7f (tolerance %.7f)\n", numSamples, NOISE_BATCH_WIDTH, maxError, BATCH_NOISE_TOLERANCE);
+	return maxError <= BATCH_NOISE_TOLERANCE;
+}
+
+static bool TestDensityLattice(WorldGenSettings const& settings, int numChunks)
+{
+	// Interpolation between nodes is approximate by design and only reported; on the nodes themselves
+	// the lattice must return the per-block noise
+	float maxAbsError = 0.f;
+	float maxNodeError = 0.f;
+	double totalMeanError = 0.0;
+	long long numSamples = 0;
+	long long numMismatchedBlocks = 0;
+	for (IntVec2 const& chunkCoords : GetScatteredChunkCoords(numChunks))
+	{
+		Chunk chunk(chunkCoords);
+		DensityErrorReport report = chunk.MeasureDensityLatticeError(settings);
+		maxAbsError = GetMax(maxAbsError, report.m_maxAbsError);
+		maxNodeError = GetMax(maxNodeError, report.m_maxNodeError);
+		totalMeanError += report.m_meanAbsError;
+		numSamples += report.m_numSamples;
+		numMismatchedBlocks += report.m_numMismatchedBlocks;
+	}
+
+	printf("  %lld blocks: max error %.4f, mean error %.4f, node error %.7f, %lld solid/air mismatches\n", numSamples, maxAbsError,
+		totalMeanError / static_cast<double>(numChunks), maxNodeError, numMismatchedBlocks);
+	return maxNodeError <= BATCH_NOISE_TOLERANCE;
+}
+
+static bool TestClimateCache(WorldGenSettings const& settings, int numChunks)
+{
+	UNUSED(settings)
+
+	// Interpolated climate is approximate and only reported; on its own sample points the cache must match
+	// per-block noise, and its cavern lists must match exactly
+	ClimateCache climateCache;
+	float maxAbsError = 0.f;
+	float maxSampleError = 0.f;
+	double totalMeanError = 0.0;
+	long long numColumns = 0;
+	long long numBiomeMismatches = 0;
+	long long numCavernMismatches = 0;
+	for (IntVec2 const& chunkCoords : GetScatteredChunkCoords(numChunks))
+	{
+		Chunk chunk(chunkCoords);
+		ClimateCacheReport report = chunk.MeasureClimateCache(climateCache);
+		maxAbsError = GetMax(maxAbsError, report.m_maxAbsError);
+		maxSampleError = GetMax(maxSampleError, report.m_maxSampleError);
+		totalMeanError += report.m_meanAbsError;
+		numColumns += report.m_numColumns;
+		numBiomeMismatches += report.m_numBiomeMismatches;
+		numCavernMismatches += report.m_numCavernMismatches;
+	}
+
+	printf("  %lld columns: max error %.5f, mean error %.5f, sample point error %.7f, %lld biome mismatches (%.3f%%), %lld cavern mismatches\n",
+		numColumns, maxAbsError, totalMeanError / static_cast<double>(numChunks), maxSampleError, numBiomeMismatches,
+		100.0 * static_cast<double>(numBiomeMismatches) / static_cast<double>(numColumns), numCavernMismatches);
+	return maxSampleError <= BATCH_NOISE_TOLERANCE && numCavernMismatches == 0;
+}
+
+static bool TestColumnBounds(WorldGenSettings const& settings, int numChunks)
+{
+	// The bounded path must classify every block exactly as the full path does, in both density modes
+	bool passed = true;
+	for (DensitySampleMode densityMode : { DensitySampleMode::PER_BLOCK, DensitySampleMode::LATTICE })
+	{
+		WorldGenSettings modeSettings = settings;
+		modeSettings.m_densityMode = densityMode;
+
+		long long numBlocks = 0;
+		long long numBlocksEvaluated = 0;
+		long long numMismatchedBlocks = 0;
+		for (IntVec2 const& chunkCoords : GetScatteredChunkCoords(numChunks))
+		{
+			Chunk chunk(chunkCoords);
+			ColumnBoundsReport report = chunk.MeasureColumnBounds(modeSettings);
+			numBlocks += report.m_numBlocks;
+			numBlocksEvaluated += report.m_numBlocksEvaluated;
+			numMismatchedBlocks += report.m_numMismatchedBlocks;
+			if (report.m_numMismatchedBlocks > 0)
+			{
+				printf("  chunk (%d,%d): %d mismatched blocks\n", chunkCoords.x, chunkCoords.y, report.m_numMismatchedBlocks);
+			}
+		}
+
+		printf("  %s: %lld of %lld blocks needed density noise, %lld mismatched\n", (densityMode == DensitySampleMode::LATTICE) ? "Lattice" : "PerBlock",
+			numBlocksEvaluated, numBlocks, numMismatchedBlocks);
+		passed = passed && (numMismatchedBlocks == 0);
+	}
+	return passed;
+}
+
+static bool TestCaverns(WorldGenSettings const& settings, int numChunks)
+{
+	UNUSED(settings)
+
+	// Chunks only carve their own cavern list, so no cavern may reach past its chunk or below the world
+	int numCaverns = 0;
+	int numEscapingCaverns = 0;
+	for (IntVec2 const& chunkCoords : GetScatteredChunkCoords(numChunks))
+	{
+		std::vector<CavernSphere> caverns;
+		AppendCavernsForChunk(chunkCoords, caverns);
+		for (CavernSphere const& cavern : caverns)
+		{
+			float minX = static_cast<float>(chunkCoords.x * CHUNK_SIZE_X);
+			float minY = static_cast<float>(chunkCoords.y * CHUNK_SIZE_Y);
+			bool isInside = cavern.m_center.x - cavern.m_radius >= minX && cavern.m_center.x + cavern.m_radius <= minX + CHUNK_SIZE_X &&
+				            cavern.m_center.y - cavern.m_radius >= minY && cavern.m_center.y + cavern.m_radius <= minY + CHUNK_SIZE_Y &&
+				            cavern.m_center.z - cavern.m_radius >= 0.f && cavern.m_center.z + cavern.m_radius <= static_cast<float>(CAVERN_MAX_Z);
+			numCaverns += 1;
+			numEscapingCaverns += isInside ? 0 : 1;
+		}
+	}
+
+	printf("  %d caverns in %d chunks, %d reaching outside their chunk\n", numCaverns, numChunks, numEscapingCaverns);
+	return numEscapingCaverns == 0 && numCaverns > 0;
+}
+
+static bool TestOrePlacement(WorldGenSettings const& settings, int numChunks)
+{
+	// The coarse grid is approximate: report how far it strays from the per-block reference. It refines
+	// with exact noise, so it may miss ore but never turn reference stone into ore
+	long long numCandidateBlocks = 0;
+	long long numPerBlockOres = 0;
+	long long numCoarseGridOres = 0;
+	long long numMismatchedBlocks = 0;
+	long long numFalseOres = 0;
+	for (IntVec2 const& chunkCoords : GetScatteredChunkCoords(numChunks))
+	{
+		Chunk chunk(chunkCoords);
+		chunk.PopulateWithDensityNoise(settings);
+		OreMeasurement measurement = chunk.MeasureOrePlacement(settings);
+		numCandidateBlocks += measurement.m_perBlock.m_numCandidateBlocks;
+		numPerBlockOres += measurement.m_perBlock.m_numOreBlocksPlaced;
+		numCoarseGridOres += measurement.m_coarseGrid.m_numOreBlocksPlaced;
+		numMismatchedBlocks += measurement.m_numMismatchedBlocks;
+		numFalseOres += measurement.m_numFalseOreBlocks;
+	}
+
+	printf("  %lld candidates: per-block %lld ores, coarse grid %lld ores, %lld mismatched (%lld where the reference has stone)\n",
+		numCandidateBlocks, numPerBlockOres, numCoarseGridOres, numMismatchedBlocks, numFalseOres);
+	return numFalseOres == 0;
+}
+
+static bool TestBiomeLookup(WorldGenSettings const& settings, int numChunks)
+{
+	UNUSED(settings)
+
+	// The baked table must classify, surface and plant trees exactly as the original branches did
+	Chunk chunk(IntVec2::ZERO);
+	BiomeLookupReport report = chunk.MeasureBiomeLookup(numChunks * 1024, GAME_SEED);
+	printf("  %d columns: branching %.3f ms, table %.3f ms, %d mismatched\n", report.m_numSamples, report.m_branchingSeconds * 1000.0,
+		report.m_lookupSeconds * 1000.0, report.m_numMismatches);
+	return report.m_numMismatches == 0;
+}
+
+// A generated chunk as the mesher sees it, with no neighbors loaded. Light varies in patches so
+// some neighboring faces share a light value and can merge while others cannot
+static void CaptureTestSnapshot(Chunk const& chunk, bool lightingEnabled, ChunkMeshSnapshot& outSnapshot)
+{
+	outSnapshot.m_chunkCoords = chunk.m_chunkCoords;
+	outSnapshot.m_lightingEnabled = lightingEnabled;
+	outSnapshot.m_blockTypes.assign(MESH_SNAPSHOT_NUM_BLOCKS, BLOCKTYPE_AIR);
+	outSnapshot.m_lightInfluence.assign(MESH_SNAPSHOT_NUM_BLOCKS, 0);
+	for (int chunkZ = 0; chunkZ < CHUNK_SIZE_Z; ++chunkZ)
+	{
+		for (int chunkY = 0; chunkY < CHUNK_SIZE_Y; ++chunkY)
+		{
+			for (int chunkX = 0; chunkX < CHUNK_SIZE_X; ++chunkX)
+			{
+				outSnapshot.CopyBlock(chunkX, chunkY, chunkZ, chunk.m_blocks[chunk.GetBlockIndex(chunkX, chunkY, chunkZ)]);
+				uint32_t patchHash = static_cast<uint32_t>((chunkX / 4) * 73856093) ^ static_cast<uint32_t>((chunkY / 4) * 19349663) ^ static_cast<uint32_t>((chunkZ / 8) * 83492791);
+				outSnapshot.m_lightInfluence[ChunkMeshSnapshot::GetIndex(chunkX, chunkY, chunkZ)] = static_cast<uint8_t>((patchHash % 3) * 0x11);
+			}
+		}
+	}
+
+	// The block definitions' sprite coords stand in for the sprite sheet cells the world resolves
+	int numBlockTypes = static_cast<int>(BlockDefinition::s_blockDefs.size());
+	outSnapshot.m_faceSpriteCells.assign(numBlockTypes * NUM_SNAPSHOT_FACE_UVS, IntVec2::ZERO);
+	for (int blockType = 0; blockType < numBlockTypes; ++blockType)
+	{
+		BlockDefinition const* blockDef = BlockDefinition::s_blockDefs[blockType];
+		if (blockDef)
+		{
+			outSnapshot.m_faceSpriteCells[blockType * NUM_SNAPSHOT_FACE_UVS + SNAPSHOT_FACE_UV_TOP] = blockDef->m_topSpriteCoords;
+			outSnapshot.m_faceSpriteCells[blockType * NUM_SNAPSHOT_FACE_UVS + SNAPSHOT_FACE_UV_BOTTOM] = blockDef->m_bottomSpriteCoords;
+			outSnapshot.m_faceSpriteCells[blockType * NUM_SNAPSHOT_FACE_UVS + SNAPSHOT_FACE_UV_SIDE] = blockDef->m_sideSpriteCoords;
+		}
+	}
+}
+
+static bool TestGreedyMeshing(WorldGenSettings const& settings, int numChunks)
+{
+	// Greedy quads must cover exactly the block faces the per-face mesher emits, each drawn the same way
+	long long numFaces = 0;
+	long long numPerFaceQuads = 0;
+	long long numGreedyQuads = 0;
+	long long numMismatchedFaces = 0;
+	ChunkMeshSnapshot snapshot;
+	for (IntVec2 const& chunkCoords : GetScatteredChunkCoords(numChunks))
+	{
+		Chunk chunk(chunkCoords);
+		chunk.PopulateWithDensityNoise(settings);
+		for (bool lightingEnabled : { true, false })
+		{
+			CaptureTestSnapshot(chunk, lightingEnabled, snapshot);
+			MeshingReport report = Chunk::CompareGreedyMeshing(snapshot);
+			numFaces += report.m_perFace.m_numFaces;
+			numPerFaceQuads += report.m_perFace.m_numQuads;
+			numGreedyQuads += report.m_greedy.m_numQuads;
+			numMismatchedFaces += report.m_numMismatchedFaces;
+			if (report.m_numMismatchedFaces > 0)
+			{
+				printf("  chunk (%d,%d) lighting %s: %d mismatched faces\n", chunkCoords.x, chunkCoords.y, lightingEnabled ? "on" : "off", report.m_numMismatchedFaces);
+			}
+		}
+	}
+
+	printf("  %lld faces: %lld per-face quads, %lld greedy quads, %lld mismatched faces\n", numFaces, numPerFaceQuads, numGreedyQuads, numMismatchedFaces);
+	return numMismatchedFaces == 0 && numGreedyQuads <= numPerFaceQuads;
+}
+
+static bool TestFrustumCulling(WorldGenSettings const& settings, int numChunks)
+{
+	UNUSED(settings)
+	UNUSED(numChunks)
+
+	// The plane test may keep boxes that are not visible, but must never cull a visible point
+	// or call a box inside while one of its corners is not
+	FrustumCullingReport report = ViewFrustum::MeasureAgainstPointTests(256, 256, GAME_SEED);
+	printf("  %d cameras, %d boxes: %d outside, %d inside, %d wrongly culled, %d wrongly inside\n", report.m_numCameras, report.m_numBoxTests,
+		report.m_numOutside, report.m_numInside, report.m_numWronglyCulled, report.m_numWronglyInside);
+	return report.m_numWronglyCulled == 0 && report.m_numWronglyInside == 0 && report.m_numOutside > 0 && report.m_numInside > 0;
+}
+
+static bool TestCompletionChannel(WorldGenSettings const& settings, int numChunks)
+{
+	UNUSED(settings)
+
+	// Every value pushed from the producer threads must be drained exactly once, and every job recycled once
+	CompletionChannelReport report = MeasureCompletionChannel(4, numChunks * 1024);
+	double worldPathNanoseconds = report.m_worldPathSeconds * 1.0e9 / static_cast<double>(report.m_numCompletions);
+	double jobQueueNanoseconds = report.m_jobQueueSeconds * 1.0e9 / static_cast<double>(report.m_numCompletions);
+	printf("  %d completions from %d threads: world path %.0f ns each, heap jobs %.0f ns each, %d mismatched paths\n", report.m_numCompletions,
+		report.m_numProducerThreads, worldPathNanoseconds, jobQueueNanoseconds, report.m_numMismatchedPaths);
+	return report.m_numMismatchedPaths == 0;
+}
+static bool TestRenderCounts(WorldGenSettings const& settings, int numChunks)
+{
+	UNUSED(settings)
+
+	// The world pass sets shared state and world constants once, then only an origin and a draw per chunk
+	WorldPassCountsReport report = MeasureWorldPassCounts(numChunks);
+	printf("  %d chunks: pass %d state changes %d uploads %d draws, per-chunk setup %d state changes %d uploads %d draws\n", report.m_numChunks,
+		report.m_numStateChanges, report.m_numConstantUploads, report.m_numDraws, report.m_numReferenceStateChanges, report.m_numReferenceConstantUploads,
+		report.m_numReferenceDraws);
+	int numSharedStates = static_cast<int>(WorldPassState::NUM_WORLD_PASS_STATES) + 2;
+	return report.m_numDraws == numChunks && report.m_numReferenceDraws == numChunks && report.m_numStateChanges == numSharedStates &&
+		report.m_numConstantUploads == numChunks + 1 && report.m_numReferenceStateChanges == numSharedStates * numChunks &&
+		report.m_numReferenceConstantUploads == 2 * numChunks;
+}
+// -----------------------------------------------------------------------------
+static HeadlessTest const HEADLESS_TESTS[] =
+{
+	{ "BatchNoise",        TestBatchNoise },
+	{ "DensityLattice",    TestDensityLattice },
+	{ "ClimateCache",      TestClimateCache },
+	{ "ColumnBounds",      TestColumnBounds },
+	{ "Caverns",           TestCaverns },
+	{ "OrePlacement",      TestOrePlacement },
+	{ "BiomeLookup",       TestBiomeLookup },
+	{ "GreedyMeshing",     TestGreedyMeshing },
+	{ "FrustumCulling",    TestFrustumCulling },
+	{ "CompletionChannel", TestCompletionChannel },
+	{ "RenderCounts",      TestRenderCounts },
+};
+
+int main(int argc, char** argv)
+{
+	LoadToolConfig(argc, argv);
+
+	std::string testName = g_gameConfigBlackboard.GetValue("test", "");
+	int numChunks = g_gameConfigBlackboard.GetValue("chunks", 64);
+	if (numChunks <= 0)
+	{
+		printf("chunks must be positive\n");
+		return 1;
+	}
+
+	WorldGenSettings settings;
+	StartupWorldGen(settings);
+
+	int numRun = 0;
+	int numFailed = 0;
+	for (HeadlessTest const& test : HEADLESS_TESTS)
+	{
+		if (!testName.empty() && testName != test.m_name)
+		{
+			continue;
+		}
+
+		printf("%s\n", test.m_name);
+		bool passed = test.m_run(settings, numChunks);
+		printf("%s %s\n", passed ? "PASS" : "FAIL", test.m_name);
+		numRun += 1;
+		numFailed += passed ? 0 : 1;
+	}
+
+	ShutdownWorldGen(settings);
+	if (numRun == 0)
+	{
+		printf("No test named \"%s\"\n", testName.c_str());
+		return 1;
+	}
+	printf("%d of %d tests passed\n", numRun - numFailed, numRun);
+	return (numFailed == 0) ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+// -----------------------------------------------------------------------------
+// Linux stand-in for the Engine's ErrorWarningAssert.cpp, which uses
+// OutputDebugStringA and message boxes. The headless tools have no debugger
+// window or dialogs, so everything goes to stderr; fatal errors abort and the
+// Yes/No style dialogs answer with their default.
+// -----------------------------------------------------------------------------
+static void PrintErrorLocation(char const* severityText, char const* filePath, char const* functionName, int lineNum, std::string const& reason, char const* conditionText)
+{
+	fprintf(stderr, "%s: %s\n", severityText, reason.c_str());
+	if (conditionText != nullptr)
+	{
+		fprintf(stderr, "  condition: %s\n", conditionText);
+	}
+	fprintf(stderr, "  in %s, %s(%d)\n", functionName, filePath, lineNum);
+}
+
+void DebuggerPrintf(char const* messageFormat, ...)
+{
+	va_list variableArgumentList;
+	va_start(variableArgumentList, messageFormat);
+	vfprintf(stderr, messageFormat, variableArgumentList);
+	va_end(variableArgumentList);
+}
+
+bool IsDebuggerAvailable()
+{
+	return false;
+}
+
+void FatalError(char const* filePath, char const* functionName, int lineNum, std::string const& reasonForError, char const* conditionText)
+{
+	PrintErrorLocation("Fatal error", filePath, functionName, lineNum, reasonForError, conditionText);
+	fflush(stderr);
+	std::abort();
+}
+
+void RecoverableWarning(char const* filePath, char const* functionName, int lineNum, std::string const& reasonForWarning, char const* conditionText)
+{
+	PrintErrorLocation("Warning", filePath, functionName, lineNum, reasonForWarning, conditionText);
+}
+
+void SystemDialogue_Okay(std::string const& messageTitle, std::string const& messageText, SeverityLevel severity)
+{
+	UNUSED(severity)
+	fprintf(stderr, "%s: %s\n", messageTitle.c_str(), messageText.c_str());
+}
+
+bool SystemDialogue_OkayCancel(std::string const& messageTitle, std::string const& messageText, SeverityLevel severity)
+{
+	SystemDialogue_Okay(messageTitle, messageText, severity);
+	return true;
+}
+
+bool SystemDialogue_YesNo(std::string const& messageTitle, std::string const& messageText, SeverityLevel severity)
+{
+	SystemDialogue_Okay(messageTitle, messageText, severity);
+	return true;
+}
+
+int SystemDialogue_YesNoCancel(std::string const& messageTitle, std::string const& messageText, SeverityLevel severity)
+{
+	SystemDialogue_Okay(messageTitle, messageText, severity);
+	return 1;
+}
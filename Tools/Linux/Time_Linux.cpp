@@ -0,0 +1,11 @@
+#include "Engine/Core/Time.hpp"
+#include <chrono>
+// -----------------------------------------------------------------------------
+// Linux stand-in for the Engine's Time.cpp, which reads QueryPerformanceCounter.
+// Same contract: seconds since the first call, from a monotonic clock.
+// -----------------------------------------------------------------------------
+double GetCurrentTimeSeconds()
+{
+	static std::chrono::steady_clock::time_point const s_startTime = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - s_startTime).count();
+}
@@ -0,0 +1,70 @@
+#include "Tools/ToolCommon.hpp"
+#include "Game/BlockDefinition.hpp"
+#include "Game/ClimateCache.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/Splines.hpp"
+#include <cstdio>
+#include <string>
+
+void LoadToolConfig(int argc, char** argv)
+{
+	char const* gameConfigXmlFilePath = "Data/GameConfig.xml";
+	XmlDocument gameConfigXml;
+	XmlError result = gameConfigXml.LoadFile(gameConfigXmlFilePath);
+	if (result == tinyxml2::XML_SUCCESS && gameConfigXml.RootElement())
+	{
+		g_gameConfigBlackboard.PopulateFromXmlElementAttributes(*gameConfigXml.RootElement());
+	}
+	else
+	{
+		printf("Could not load %s, using default world generation settings\n", gameConfigXmlFilePath);
+	}
+
+	// Every key=value argument overrides the matching GameConfig.xml attribute
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		std::string arg = argv[argIndex];
+		size_t equalsPos = arg.find('=');
+		if (equalsPos == std::string::npos || equalsPos == 0)
+		{
+			printf("Ignoring argument \"%s\", expected key=value\n", arg.c_str());
+			continue;
+		}
+		g_gameConfigBlackboard.SetValue(arg.substr(0, equalsPos), arg.substr(equalsPos + 1));
+	}
+}
+
+void StartupWorldGen(WorldGenSettings& outSettings)
+{
+	BlockDefinition::InitializeBlockDefinitions();
+
+	outSettings.m_continentHeightOffsetCurve = CreateContinentHeightOffsetCurve();
+	outSettings.m_continentSquashCurve = CreateContinentSquashCurve();
+	if (g_gameConfigBlackboard.GetValue("useClimateCache", false))
+	{
+		outSettings.m_climateCache = new ClimateCache();
+	}
+	ReadWorldGenSettingsFromConfig(outSettings);
+}
+
+void ShutdownWorldGen(WorldGenSettings& settings)
+{
+	delete settings.m_climateCache;
+	settings.m_climateCache = nullptr;
+	delete settings.m_continentHeightOffsetCurve;
+	settings.m_continentHeightOffsetCurve = nullptr;
+	delete settings.m_continentSquashCurve;
+	settings.m_continentSquashCurve = nullptr;
+
+	BlockDefinition::ClearBlockDefinitions();
+}
+
+void PrintWorldGenSettings(WorldGenSettings const& settings)
+{
+	printf("Settings: densityMode=%s columnBounds=%s oreMode=%s climateCache=%s\n",
+		(settings.m_densityMode == DensitySampleMode::LATTICE) ? "Lattice" : "PerBlock",
+		settings.m_useColumnBounds ? "true" : "false",
+		(settings.m_oreMode == OrePlacementMode::COARSE_GRID) ? "CoarseGrid" : "PerBlock",
+		(settings.m_climateCache != nullptr) ? "true" : "false");
+}
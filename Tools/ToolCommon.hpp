@@ -0,0 +1,15 @@
+#pragma once
+#include "Game/GameCommon.h"
+// -----------------------------------------------------------------------------
+// Setup shared by the headless tools. Every tool is run from the Run directory
+// so the block definitions, GameConfig.xml and Saves folder resolve the same
+// way they do for the game.
+// -----------------------------------------------------------------------------
+// Loads GameConfig.xml, then applies every key=value argument on top of it
+void LoadToolConfig(int argc, char** argv);
+
+// Block definitions, continent curves, climate cache and sampling options, as Game::Startup sets them up
+void StartupWorldGen(WorldGenSettings& outSettings);
+void ShutdownWorldGen(WorldGenSettings& settings);
+
+void PrintWorldGenSettings(WorldGenSettings const& settings);
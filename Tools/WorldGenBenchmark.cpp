@@ -0,0 +1,141 @@
+#include "Tools/ToolCommon.hpp"
+#include "Game/Chunk.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/Time.hpp"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+// -----------------------------------------------------------------------------
+// Headless world generation benchmark.
+// Generates chunks around an origin on a number of worker threads and reports
+// throughput, per-stage time and a content hash per chunk. Run from the Run
+// directory so the block definitions and GameConfig.xml are found.
+//
+//   WorldGenBenchmark [chunks=N] [threads=M] [originX=X] [originY=Y] [printHashes=true|false]
+//                     [any GameConfig.xml world generation key=value, e.g. densityMode=Lattice]
+// -----------------------------------------------------------------------------
+struct BenchmarkChunkResult
+{
+	IntVec2  m_chunkCoords = IntVec2::ZERO;
+	uint64_t m_contentHash = 0;
+	double   m_seconds = 0.0;
+	GenerationStageTimes m_stageTimes;
+};
+// -----------------------------------------------------------------------------
+// Rings of increasing Chebyshev distance around the origin, nearest first like world activation
+static std::vector<IntVec2> GetChunkCoordsAroundOrigin(IntVec2 const& origin, int numChunks)
+{
+	std::vector<IntVec2> chunkCoords;
+	chunkCoords.reserve(numChunks);
+	for (int ring = 0; static_cast<int>(chunkCoords.size()) < numChunks; ++ring)
+	{
+		for (int offsetY = -ring; offsetY <= ring; ++offsetY)
+		{
+			for (int offsetX = -ring; offsetX <= ring; ++offsetX)
+			{
+				bool isOnRing = (offsetX == -ring || offsetX == ring || offsetY == -ring || offsetY == ring);
+				if (isOnRing && static_cast<int>(chunkCoords.size()) < numChunks)
+				{
+					chunkCoords.push_back(IntVec2(origin.x + offsetX, origin.y + offsetY));
+				}
+			}
+		}
+	}
+	return chunkCoords;
+}
+
+static void PrintStageLine(char const* stageName, double stageSeconds, double totalSeconds, int numChunks)
+{
+	double percentOfTotal = (totalSeconds > 0.0) ? (100.0 * stageSeconds / totalSeconds) : 0.0;
+	printf("  %-10s %10.3f ms/chunk  %5.1f%%\n", stageName, 1000.0 * stageSeconds / static_cast<double>(numChunks), percentOfTotal);
+}
+
+int main(int argc, char** argv)
+{
+	LoadToolConfig(argc, argv);
+
+	int numChunks = g_gameConfigBlackboard.GetValue("chunks", 256);
+	int defaultThreads = static_cast<int>(std::thread::hardware_concurrency());
+	int numThreads = g_gameConfigBlackboard.GetValue("threads", (defaultThreads > 0) ? defaultThreads : 1);
+	IntVec2 origin = IntVec2(g_gameConfigBlackboard.GetValue("originX", 0), g_gameConfigBlackboard.GetValue("originY", 0));
+	bool printHashes = g_gameConfigBlackboard.GetValue("printHashes", true);
+	if (numChunks <= 0 || numThreads <= 0)
+	{
+		printf("chunks and threads must both be positive\n");
+		return 1;
+	}
+
+	WorldGenSettings settings;
+	StartupWorldGen(settings);
+
+	std::vector<IntVec2> chunkCoords = GetChunkCoordsAroundOrigin(origin, numChunks);
+	std::vector<BenchmarkChunkResult> results(numChunks);
+	std::atomic<int> nextChunkIndex = 0;
+
+	// Workers pull the next chunk in activation order until every chunk is generated
+	double startTime = GetCurrentTimeSeconds();
+	std::vector<std::thread> workers;
+	for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+	{
+		workers.emplace_back([&]()
+		{
+			for (int chunkIndex = nextChunkIndex++; chunkIndex < numChunks; chunkIndex = nextChunkIndex++)
+			{
+				double chunkStartTime = GetCurrentTimeSeconds();
+				Chunk* chunk = new Chunk(chunkCoords[chunkIndex]);
+				chunk->PopulateWithDensityNoise(settings);
+
+				BenchmarkChunkResult& result = results[chunkIndex];
+				result.m_chunkCoords = chunkCoords[chunkIndex];
+				result.m_contentHash = chunk->ComputeContentHash();
+				result.m_stageTimes = chunk->m_stageTimes;
+				delete chunk;
+				result.m_seconds = GetCurrentTimeSeconds() - chunkStartTime;
+			}
+		});
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	double wallSeconds = GetCurrentTimeSeconds() - startTime;
+
+	// Stage times are summed over every chunk, so they add up to thread time rather than wall time
+	GenerationStageTimes stageTotals;
+	double chunkSecondsTotal = 0.0;
+	uint64_t worldHash = 14695981039346656037ULL;
+	for (BenchmarkChunkResult const& result : results)
+	{
+		stageTotals.m_noiseMapSeconds += result.m_stageTimes.m_noiseMapSeconds;
+		stageTotals.m_densitySeconds += result.m_stageTimes.m_densitySeconds;
+		stageTotals.m_caveSeconds += result.m_stageTimes.m_caveSeconds;
+		stageTotals.m_oreSeconds += result.m_stageTimes.m_oreSeconds;
+		stageTotals.m_treeSeconds += result.m_stageTimes.m_treeSeconds;
+		chunkSecondsTotal += result.m_seconds;
+		worldHash = (worldHash ^ result.m_contentHash) * 1099511628211ULL;
+	}
+
+	if (printHashes)
+	{
+		for (BenchmarkChunkResult const& result : results)
+		{
+			printf("chunk (%d,%d) hash %016llx\n", result.m_chunkCoords.x, result.m_chunkCoords.y, static_cast<unsigned long long>(result.m_contentHash));
+		}
+	}
+
+	printf("Generated %d chunks around (%d,%d) on %d threads in %.3f s: %.1f chunks/s\n",
+		numChunks, origin.x, origin.y, numThreads, wallSeconds, static_cast<double>(numChunks) / wallSeconds);
+	PrintWorldGenSettings(settings);
+	printf("Per-stage time (%.3f ms/chunk total):\n", 1000.0 * chunkSecondsTotal / static_cast<double>(numChunks));
+	PrintStageLine("noiseMaps", stageTotals.m_noiseMapSeconds, chunkSecondsTotal, numChunks);
+	PrintStageLine("density", stageTotals.m_densitySeconds, chunkSecondsTotal, numChunks);
+	PrintStageLine("caves", stageTotals.m_caveSeconds, chunkSecondsTotal, numChunks);
+	PrintStageLine("ores", stageTotals.m_oreSeconds, chunkSecondsTotal, numChunks);
+	PrintStageLine("trees", stageTotals.m_treeSeconds, chunkSecondsTotal, numChunks);
+	printf("World hash %016llx\n", static_cast<unsigned long long>(worldHash));
+
+	ShutdownWorldGen(settings);
+	return 0;
+}
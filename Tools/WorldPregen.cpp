@@ -0,0 +1,324 @@
+#include "Tools/ToolCommon.hpp"
+#include "Game/Chunk.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+// -----------------------------------------------------------------------------
+// Offline world pre-generation.
+// Generates every chunk in the square region [minX, maxX] x [minY, maxY] on all
+// cores and writes it to Saves/ in the GCHK format, so players only ever take
+// the LoadChunkJob path inside the region. Run from the Run directory.
+//
+//   WorldPregen [minX=X] [minY=Y] [maxX=X] [maxY=Y] [threads=M]
+//               [any GameConfig.xml world generation key=value]
+//
+// Each chunk is saved once its neighbors have generated, so tree blocks they
+// place across the border are baked into the file. A one-chunk margin ring
+// around the region is generated for that too but never saved; what the region
+// places into it goes to a pending writes file that
+// World::ApplyPendingBlockWrites picks up. Files are written to a temporary name and renamed, so a save file only
+// exists once it is complete; rerunning after an interruption skips those
+// chunks and only regenerates their neighbors for the decoration they hand
+// across.
+// -----------------------------------------------------------------------------
+struct PregenSlot
+{
+	IntVec2 m_chunkCoords = IntVec2::ZERO;
+	bool    m_needsSaving = false;        // No complete save file yet
+	bool    m_needsGenerating = false;    // Needs saving, or hands decoration to a neighbor that does
+
+	// [worker threads] Chunk is held from generation until every in-region neighbor has generated too
+	Chunk* m_chunk = nullptr;
+	std::atomic<int> m_numPendingGenerations = 0;    // Itself plus its eight neighbors
+	std::vector<PendingBlockWrite> m_incomingBlockWrites;
+	std::vector<PendingBlockWrite> m_marginBlockWrites;     // Its own writes into the margin ring, persisted with its save
+};
+// -----------------------------------------------------------------------------
+// The chunks to save; slots also cover the margin ring one chunk outside it
+struct PregenRegion
+{
+	int m_minX = 0;
+	int m_minY = 0;
+	int m_sizeX = 0;
+	int m_sizeY = 0;
+
+	bool IsInRegion(IntVec2 const& chunkCoords) const
+	{
+		return chunkCoords.x >= m_minX && chunkCoords.x < m_minX + m_sizeX && chunkCoords.y >= m_minY && chunkCoords.y < m_minY + m_sizeY;
+	}
+	bool HasSlot(IntVec2 const& chunkCoords) const
+	{
+		return chunkCoords.x >= m_minX - 1 && chunkCoords.x <= m_minX + m_sizeX && chunkCoords.y >= m_minY - 1 && chunkCoords.y <= m_minY + m_sizeY;
+	}
+	int GetNumSlots() const
+	{
+		return (m_sizeX + 2) * (m_sizeY + 2);
+	}
+	int GetSlotIndex(IntVec2 const& chunkCoords) const
+	{
+		return (chunkCoords.y - m_minY + 1) * (m_sizeX + 2) + (chunkCoords.x - m_minX + 1);
+	}
+	IntVec2 GetSlotCoords(int slotIndex) const
+	{
+		return IntVec2(m_minX - 1 + slotIndex % (m_sizeX + 2), m_minY - 1 + slotIndex / (m_sizeX + 2));
+	}
+};
+// -----------------------------------------------------------------------------
+static std::mutex s_incomingWritesMutex;
+static std::mutex s_pendingWritesFileMutex;
+static std::atomic<int> s_numChunksGenerated = 0;
+static std::atomic<int> s_numChunksSaved = 0;
+static std::atomic<int> s_numSaveFailures = 0;
+static std::atomic<long long> s_numBytesWritten = 0;
+static std::atomic<int> s_numMarginWritesPersisted = 0;
+// -----------------------------------------------------------------------------
+// Appended before the chunk's own file is renamed into place, so an interrupted run repeats them rather than losing them
+static void PersistMarginWrites(PregenSlot const& slot)
+{
+	for (int offsetY = -1; offsetY <= 1; ++offsetY)
+	{
+		for (int offsetX = -1; offsetX <= 1; ++offsetX)
+		{
+			IntVec2 marginCoords = IntVec2(slot.m_chunkCoords.x + offsetX, slot.m_chunkCoords.y + offsetY);
+			std::vector<PendingBlockWrite> marginWrites;
+			for (PendingBlockWrite const& marginWrite : slot.m_marginBlockWrites)
+			{
+				if (marginWrite.m_targetChunkCoords == marginCoords)
+				{
+					marginWrites.push_back(marginWrite);
+				}
+			}
+			if (marginWrites.empty())
+			{
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(s_pendingWritesFileMutex);
+			Chunk::AppendPendingWritesToFile(marginCoords, marginWrites);
+			s_numMarginWritesPersisted += static_cast<int>(marginWrites.size());
+		}
+	}
+}
+
+// Applies the neighbors' decoration and writes the chunk; called exactly once per slot that needs saving
+static void SaveFinishedChunk(PregenSlot& slot)
+{
+	Chunk* chunk = slot.m_chunk;
+	chunk->ApplyBlockWrites(slot.m_incomingBlockWrites);
+	PersistMarginWrites(slot);
+
+	std::vector<uint8_t> byteBuffer;
+	chunk->WriteBlocksToBuffer(byteBuffer);
+
+	std::string filename = Chunk::GetSaveFilePath(slot.m_chunkCoords);
+	std::string tempFilename = filename + ".tmp";
+	WriteBufferToFile(byteBuffer, tempFilename);
+
+	std::error_code renameError;
+	std::filesystem::rename(tempFilename, filename, renameError);
+	if (renameError)
+	{
+		printf("Failed to write %s: %s\n", filename.c_str(), renameError.message().c_str());
+		s_numSaveFailures += 1;
+	}
+	else
+	{
+		s_numChunksSaved += 1;
+		s_numBytesWritten += static_cast<long long>(byteBuffer.size());
+	}
+
+	delete chunk;
+	slot.m_chunk = nullptr;
+	std::vector<PendingBlockWrite>().swap(slot.m_incomingBlockWrites);
+	std::vector<PendingBlockWrite>().swap(slot.m_marginBlockWrites);
+}
+
+static void GenerateSlot(PregenRegion const& region, std::vector<PregenSlot>& slots, int slotIndex, WorldGenSettings const& settings)
+{
+	PregenSlot& slot = slots[slotIndex];
+	Chunk* chunk = new Chunk(slot.m_chunkCoords);
+	chunk->PopulateWithDensityNoise(settings);
+	s_numChunksGenerated += 1;
+
+	// Decoration for neighbors that still need saving, and for the margin ring from chunks that are saved now
+	{
+		std::lock_guard<std::mutex> lock(s_incomingWritesMutex);
+		for (PendingBlockWrite const& outgoingWrite : chunk->m_outgoingBlockWrites)
+		{
+			if (region.IsInRegion(outgoingWrite.m_targetChunkCoords))
+			{
+				PregenSlot& targetSlot = slots[region.GetSlotIndex(outgoingWrite.m_targetChunkCoords)];
+				if (targetSlot.m_needsSaving)
+				{
+					targetSlot.m_incomingBlockWrites.push_back(outgoingWrite);
+				}
+			}
+			else if (slot.m_needsSaving)
+			{
+				slot.m_marginBlockWrites.push_back(outgoingWrite);
+			}
+		}
+	}
+
+	if (slot.m_needsSaving)
+	{
+		chunk->m_outgoingBlockWrites.clear();
+		slot.m_chunk = chunk;
+	}
+	else
+	{
+		delete chunk;
+	}
+
+	// Whichever generation finishes last around a chunk saves it
+	for (int offsetY = -1; offsetY <= 1; ++offsetY)
+	{
+		for (int offsetX = -1; offsetX <= 1; ++offsetX)
+		{
+			IntVec2 waitingCoords = IntVec2(slot.m_chunkCoords.x + offsetX, slot.m_chunkCoords.y + offsetY);
+			if (!region.HasSlot(waitingCoords))
+			{
+				continue;
+			}
+
+			PregenSlot& waitingSlot = slots[region.GetSlotIndex(waitingCoords)];
+			if (waitingSlot.m_needsSaving && --waitingSlot.m_numPendingGenerations == 0)
+			{
+				SaveFinishedChunk(waitingSlot);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	LoadToolConfig(argc, argv);
+
+	PregenRegion region;
+	region.m_minX = g_gameConfigBlackboard.GetValue("minX", -32);
+	region.m_minY = g_gameConfigBlackboard.GetValue("minY", -32);
+	int maxX = g_gameConfigBlackboard.GetValue("maxX", 31);
+	int maxY = g_gameConfigBlackboard.GetValue("maxY", 31);
+	region.m_sizeX = maxX - region.m_minX + 1;
+	region.m_sizeY = maxY - region.m_minY + 1;
+	int defaultThreads = static_cast<int>(std::thread::hardware_concurrency());
+	int numThreads = g_gameConfigBlackboard.GetValue("threads", (defaultThreads > 0) ? defaultThreads : 1);
+	if (region.m_sizeX <= 0 || region.m_sizeY <= 0 || numThreads <= 0)
+	{
+		printf("Region must be non-empty (min <= max) and threads must be positive\n");
+		return 1;
+	}
+
+	std::error_code directoryError;
+	std::filesystem::create_directories("Saves", directoryError);
+	if (directoryError)
+	{
+		printf("Could not create Saves directory: %s\n", directoryError.message().c_str());
+		return 1;
+	}
+
+	// Chunks with a complete save file are done, as is the margin ring; only their neighbors' decoration still needs them
+	int numSlots = region.GetNumSlots();
+	std::vector<PregenSlot> slots(numSlots);
+	int numToSave = 0;
+	for (int slotIndex = 0; slotIndex < numSlots; ++slotIndex)
+	{
+		PregenSlot& slot = slots[slotIndex];
+		slot.m_chunkCoords = region.GetSlotCoords(slotIndex);
+		slot.m_needsSaving = region.IsInRegion(slot.m_chunkCoords) && !std::filesystem::exists(Chunk::GetSaveFilePath(slot.m_chunkCoords));
+		numToSave += slot.m_needsSaving ? 1 : 0;
+	}
+
+	for (int slotIndex = 0; slotIndex < numSlots; ++slotIndex)
+	{
+		PregenSlot& slot = slots[slotIndex];
+		int numNeighborsWithSlots = 0;
+		for (int offsetY = -1; offsetY <= 1; ++offsetY)
+		{
+			for (int offsetX = -1; offsetX <= 1; ++offsetX)
+			{
+				IntVec2 neighborCoords = IntVec2(slot.m_chunkCoords.x + offsetX, slot.m_chunkCoords.y + offsetY);
+				if (region.HasSlot(neighborCoords))
+				{
+					numNeighborsWithSlots += 1;
+					slot.m_needsGenerating = slot.m_needsGenerating || slots[region.GetSlotIndex(neighborCoords)].m_needsSaving;
+				}
+			}
+		}
+		slot.m_numPendingGenerations = numNeighborsWithSlots;
+	}
+
+	// Row-major order, so a held chunk only waits on the next row and memory stays around two rows of chunks
+	std::vector<int> generationOrder;
+	for (int slotIndex = 0; slotIndex < numSlots; ++slotIndex)
+	{
+		if (slots[slotIndex].m_needsGenerating)
+		{
+			generationOrder.push_back(slotIndex);
+		}
+	}
+	int numToGenerate = static_cast<int>(generationOrder.size());
+
+	WorldGenSettings settings;
+	StartupWorldGen(settings);
+	PrintWorldGenSettings(settings);
+	int numRegionChunks = region.m_sizeX * region.m_sizeY;
+	printf("Region (%d,%d) to (%d,%d): %d chunks, %d already saved, %d to save, %d to generate (with margin ring) on %d threads\n",
+		region.m_minX, region.m_minY, maxX, maxY, numRegionChunks, numRegionChunks - numToSave, numToSave, numToGenerate, numThreads);
+
+	double startTime = GetCurrentTimeSeconds();
+	std::atomic<int> nextOrderIndex = 0;
+	std::vector<std::thread> workers;
+	for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+	{
+		workers.emplace_back([&]()
+		{
+			for (int orderIndex = nextOrderIndex++; orderIndex < numToGenerate; orderIndex = nextOrderIndex++)
+			{
+				GenerateSlot(region, slots, generationOrder[orderIndex], settings);
+			}
+		});
+	}
+
+	// Progress once a second until every worker has run out of chunks
+	int lastReportedSaved = -1;
+	while (s_numChunksSaved + s_numSaveFailures < numToSave)
+	{
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+		int numSaved = s_numChunksSaved;
+		if (numSaved != lastReportedSaved)
+		{
+			double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+			printf("  saved %d/%d, generated %d/%d, %.1f chunks/s\n", numSaved, numToSave, static_cast<int>(s_numChunksGenerated), numToGenerate,
+				static_cast<double>(numSaved) / elapsedSeconds);
+			lastReportedSaved = numSaved;
+		}
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	double wallSeconds = GetCurrentTimeSeconds() - startTime;
+
+	int numSaved = s_numChunksSaved;
+	double chunksPerSecond = (wallSeconds > 0.0) ? (static_cast<double>(numSaved) / wallSeconds) : 0.0;
+	double megabytesWritten = static_cast<double>(s_numBytesWritten) / (1024.0 * 1024.0);
+	printf("Saved %d chunks (generated %d) in %.3f s: %.1f chunks/s, %.1f MB written, %d pending writes for the margin ring\n", numSaved,
+		static_cast<int>(s_numChunksGenerated), wallSeconds, chunksPerSecond, megabytesWritten, static_cast<int>(s_numMarginWritesPersisted));
+
+	ShutdownWorldGen(settings);
+	if (s_numSaveFailures > 0)
+	{
+		printf("%d chunks failed to save, rerun to retry them\n", static_cast<int>(s_numSaveFailures));
+		return 1;
+	}
+	return 0;
+}